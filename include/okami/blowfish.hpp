@@ -25,6 +25,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <string>
@@ -36,6 +38,49 @@ namespace Nippon
 
 inline constexpr std::string_view kCipherKey = "YaKiNiKuM2rrVrPJpGMkfe3EK4RbpbHw";
 
+/**
+ * @brief Blowfish ECB with its own key schedule
+ *
+ * Every block is independent in ECB, so encrypt()/decrypt() run several
+ * blocks through the rounds together (kLanes at a time) to overlap their
+ * S-box loads, and split buffers of kParallelBytes or more into slices on a
+ * shared worker pool. A context is immutable after construction and safe to
+ * use from any number of threads at once.
+ */
+class BlowfishContext
+{
+  public:
+    /// Blocks processed together per round.
+    static constexpr std::size_t kLanes = 4;
+    /// Buffers smaller than this are processed on the calling thread.
+    static constexpr std::size_t kParallelBytes = 256 * 1024;
+
+    explicit BlowfishContext(std::string_view key);
+
+    void encryptBlock(uint32_t &xl, uint32_t &xr) const noexcept;
+    void decryptBlock(uint32_t &xl, uint32_t &xr) const noexcept;
+
+    /// Encrypt/Decrypt in place (ECB mode, 8-byte blocks). Trailing bytes past
+    /// the last whole block are left as they are. maxThreads caps the threads
+    /// used, caller included; 0 means one per hardware thread.
+    void encrypt(std::span<uint8_t> bytes, unsigned maxThreads = 0) const;
+    void decrypt(std::span<uint8_t> bytes, unsigned maxThreads = 0) const;
+
+  private:
+    template <bool Decrypt> void process(std::span<uint8_t> bytes, unsigned maxThreads) const;
+    template <bool Decrypt> void processBlocks(uint8_t *data, std::size_t blocks) const noexcept;
+    template <bool Decrypt, std::size_t Lanes> void processGroup(uint8_t *data) const noexcept;
+    [[nodiscard]] uint32_t feistel(uint32_t x) const noexcept;
+
+    std::array<uint32_t, 16 + 2> p_;
+    std::array<std::array<uint32_t, 256>, 4> s_;
+};
+
+/// Shared context for the game's package cipher key, built on first use.
+[[nodiscard]] const BlowfishContext &okamiCipher();
+
+/// Process-wide context selected by Create(). Prefer BlowfishContext; this
+/// interface is kept for code that keys the cipher once up front.
 class BlowFish
 {
   public:
@@ -51,9 +96,6 @@ class BlowFish
     /// Encrypt/Decrypt a mutable span in-place (ECB mode, 8-byte blocks).
     static void Encrypt(std::span<uint8_t> Bytes);
     static void Decrypt(std::span<uint8_t> Bytes);
-
-  private:
-    [[nodiscard]] static uint32_t Feistel(uint32_t X);
 };
 
 } // namespace Nippon
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace okami
+{
+
+/**
+ * 64-bit content hash for change and duplicate detection. Not cryptographic:
+ * confirm a match by comparing the bytes where that matters. Four
+ * independent lanes consume 8-byte words so the multiplies overlap; each step
+ * is a bijection of the lane state, so changing any single word always
+ * changes the result.
+ */
+[[nodiscard]] inline uint64_t contentHash(std::span<const uint8_t> data)
+{
+    constexpr uint64_t kPrime = 0x100000001B3ull; // FNV-1a 64 prime
+    std::array<uint64_t, 4> lanes{0xCBF29CE484222325ull, 0x84222325CBF29CE4ull, 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full};
+
+    auto step = [](uint64_t lane, uint64_t word) { return std::rotl((lane ^ word) * kPrime, 31); };
+
+    const uint8_t *p = data.data();
+    std::size_t left = data.size();
+    for (; left >= 32; p += 32, left -= 32)
+    {
+        for (std::size_t i = 0; i < lanes.size(); ++i)
+        {
+            uint64_t word;
+            std::memcpy(&word, p + i * sizeof(word), sizeof(word));
+            lanes[i] = step(lanes[i], word);
+        }
+    }
+    for (std::size_t i = 0; left > 0; ++i)
+    {
+        uint64_t word = 0;
+        const std::size_t n = std::min(left, sizeof(word));
+        std::memcpy(&word, p, n);
+        lanes[i] = step(lanes[i], word);
+        p += n;
+        left -= n;
+    }
+
+    // Fold the lanes and length, then a murmur3 finaliser
+    uint64_t h = data.size();
+    for (uint64_t lane : lanes)
+        h = step(h, lane);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace okami
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <span>
 #include <string_view>
@@ -39,6 +41,24 @@ inline constexpr auto kIconEntries = std::to_array<IconEntry>({
     {okami::ItemTypes::OkamiTrapItem, 13, 2},
 });
 
+/// Indexed by item type: position of the item in kIconEntries, or -1 if it
+/// keeps its vanilla icon.
+inline constexpr auto kIconEntryByItem = []
+{
+    std::array<int8_t, 256> table{};
+    table.fill(-1);
+    for (size_t i = 0; i < kIconEntries.size(); ++i)
+        table[static_cast<size_t>(kIconEntries[i].itemType)] = static_cast<int8_t>(i);
+    return table;
+}();
+static_assert(kIconEntries.size() <= INT8_MAX);
+
+/// Position of itemType in kIconEntries, or -1.
+[[nodiscard]] constexpr int iconEntryIndex(int itemType)
+{
+    return static_cast<unsigned>(itemType) < kIconEntryByItem.size() ? kIconEntryByItem[static_cast<size_t>(itemType)] : -1;
+}
+
 /// Filename of the custom icon package, relative to the mod directory.
 inline constexpr std::string_view kPackageFilename = "icons/APCustomIcons.dat";
 
@@ -55,15 +75,34 @@ inline constexpr std::string_view kPackageResourceName = "archipelago/customicon
 [[nodiscard]] bool buildFromFiles(const std::filesystem::path &outPath, const std::filesystem::path &standardPath, const std::filesystem::path &progressionPath,
                                   const std::filesystem::path &trapPath);
 
+/// Build manifest stored alongside a combined package at outPath.
+[[nodiscard]] std::filesystem::path manifestPath(const std::filesystem::path &outPath);
+
+/// Layout of a combined package.
+struct CombinedPackage
+{
+    /// Number of vanilla entries (= 0-based index of the first custom entry).
+    int vanillaCount = 0;
+    /// Number of custom entries after the vanilla ones. Rows of kIconEntries
+    /// with identical DDS data share one entry, so this is at most 3.
+    int iconCount = 0;
+    /// 0-based package index of each kIconEntries row's icon.
+    std::array<uint16_t, kIconEntries.size()> iconIndex{};
+};
+
 /// Build a combined package: all entries from the encrypted vanilla package at
-/// vanillaPath, followed by the custom DDS icons.  The combined package is written
-/// to outPath using the same Blowfish format.
-/// vanillaCount receives the number of vanilla entries (= 0-based index of the
-/// first custom entry in the combined package).
+/// vanillaPath, followed by one entry per distinct custom DDS icon. The
+/// combined package is written to outPath using the same Blowfish format, and
+/// layout receives where each kIconEntries row's icon ended up.
 /// Returns true on success; false if the vanilla package cannot be read or DDS
 /// files are missing.
+///
+/// A manifest of input hashes (vanilla package, DDS files, kIconEntries) is
+/// written to manifestPath(outPath) after each build. When it still matches the
+/// inputs and outPath has the recorded size, the existing package is kept and
+/// only layout is filled in.
 [[nodiscard]] bool buildCombinedFromFiles(const std::filesystem::path &outPath, const std::filesystem::path &vanillaPath,
                                           const std::filesystem::path &standardPath, const std::filesystem::path &progressionPath,
-                                          const std::filesystem::path &trapPath, int &vanillaCount);
+                                          const std::filesystem::path &trapPath, CombinedPackage &layout);
 
 } // namespace okami::customiconpkg
@@ -1,10 +1,55 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace okami::custommodelpkg
 {
 
+/// Vertex colour and texture of one model variant.
+struct ModelVariant
+{
+    uint8_t r = 255, g = 255, b = 255, a = 255;
+    uint16_t textureIndex = 0;
+};
+
+/**
+ * @brief AP box model package serialized once and stamped out per variant
+ *
+ * Every variant shares the box geometry, transform and headers and differs
+ * only in its per-face colour weights and texture index, whose offsets are
+ * fixed by the layout. The constructor serializes the package image once;
+ * a variant is a copy of it with those blocks patched in, so N variants cost
+ * N copies of about 1 KiB rather than N full serializations.
+ */
+class BoxModelTemplate
+{
+  public:
+    BoxModelTemplate();
+
+    /// Size of every variant's package image.
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_image.size();
+    }
+
+    /// Write a variant's package image into out. Returns false, writing
+    /// nothing, if out is smaller than size().
+    [[nodiscard]] bool buildInto(std::span<uint8_t> out, const ModelVariant &variant) const;
+
+    /// Package image for one variant.
+    [[nodiscard]] std::vector<uint8_t> build(const ModelVariant &variant) const;
+
+    /// Package images for several variants, in order.
+    [[nodiscard]] std::vector<std::vector<uint8_t>> build(std::span<const ModelVariant> variants) const;
+
+  private:
+    std::vector<uint8_t> m_image; // package image with zeroed colour weights
+};
+
 /// Initialize all 6 custom model packages. Call once during itempatch::initialize().
 void initialize();
 
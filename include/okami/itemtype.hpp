@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 // Source: https://okami.speedruns.wiki/Item_Table
 
 namespace okami
@@ -542,5 +544,30 @@ inline constexpr const char *GetName(unsigned value)
     }
     return "invalid";
 }
+
+/// Placeholder types that stand in for Archipelago items: standard, progression
+/// and trap, first for other players' items, then for the local player's.
+inline constexpr auto kApDummyItems = std::to_array<Enum>({
+    ForeignStandardItem,
+    ForeignProgressionItem,
+    ForeignTrapItem,
+    OkamiStandardItem,
+    OkamiProgressionItem,
+    OkamiTrapItem,
+});
+
+/// Indexed by item ID; true for the AP dummy types.
+inline constexpr auto kIsApDummyItem = []
+{
+    std::array<bool, 256> table{};
+    for (Enum item : kApDummyItems)
+        table[item] = true;
+    return table;
+}();
+
+inline constexpr bool IsApDummyItem(unsigned value)
+{
+    return value < kIsApDummyItem.size() && kIsApDummyItem[value];
+}
 } // namespace ItemTypes
 } // namespace okami
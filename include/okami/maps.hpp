@@ -1,10 +1,13 @@
 
 #pragma once
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <iomanip>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 namespace okami
 {
@@ -257,7 +260,7 @@ inline static const std::unordered_map<uint16_t, std::string> MapNames = {
 /// The areaNameID is shown on the title-screen continue slot.
 /// Values sourced from OriginEdit (Shintensu) and the speedruns wiki.
 /// Maps not in the table get 0x35 ("Start from beginning").
-inline static const std::unordered_map<uint16_t, uint32_t> MapToAreaNameID = {
+inline constexpr auto MapToAreaNameID = std::to_array<std::pair<uint16_t, uint32_t>>({
     // Kamiki Village variants → 0x00
     {::MapID::KamikiVillageCursed, 0x00},
     {::MapID::CaveofNagi, 0x00},
@@ -393,14 +396,17 @@ inline static const std::unordered_map<uint16_t, uint32_t> MapToAreaNameID = {
     // Digging Minigame / Dojo → use parent area
     {::MapID::DiggingMinigame, 0x01},
     {::MapID::OnigiriDojoLessonRoom, 0x01},
-};
+});
+
+/// @brief areaNameID for maps not in MapToAreaNameID ("Start from beginning").
+inline constexpr uint32_t kDefaultAreaNameID = 0x35;
 
 /// @brief Look up save-slot areaNameID from a map ID.
 /// Returns 0x35 ("Start from beginning") if the map isn't in the table.
-inline uint32_t getAreaNameID(uint16_t mapID)
+inline constexpr uint32_t getAreaNameID(uint16_t mapID)
 {
-    auto it = MapToAreaNameID.find(mapID);
-    return (it != MapToAreaNameID.end()) ? it->second : 0x35u;
+    auto it = std::ranges::find(MapToAreaNameID, mapID, &std::pair<uint16_t, uint32_t>::first);
+    return (it != MapToAreaNameID.end()) ? it->second : kDefaultAreaNameID;
 }
 
 /// @brief Decode Map name from ID
@@ -1,6 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <unordered_map>
+#include <utility>
 
 namespace okami
 {
@@ -180,8 +182,8 @@ static const char *names[NUM_MAP_TYPES] = {
     "Unk82",
 };
 
-#include <unordered_map>
-static const std::unordered_map<unsigned, unsigned> mapidToIndex{
+// Map ID -> MapTypes index. Several map IDs (cursed/healed variants) share a type.
+inline constexpr auto mapidToIndex = std::to_array<std::pair<unsigned, unsigned>>({
     {0x100, KamikiVillageGameStart},
     {0x101, CaveOfNagi},
     {0x102, KamikiVillage},
@@ -267,7 +269,7 @@ static const std::unordered_map<unsigned, unsigned> mapidToIndex{
     {0xF13, KamuiEzofuji},
     {0xF20, ShinshuField100yearsago},
     {0xF21, MoonCaveEntrance100yearsago},
-};
+});
 
 inline const char *GetName(unsigned value)
 {
@@ -278,9 +280,9 @@ inline const char *GetName(unsigned value)
     return "invalid";
 }
 
-inline unsigned FromMapId(unsigned id)
+inline constexpr unsigned FromMapId(unsigned id)
 {
-    if (auto it = mapidToIndex.find(id); it != mapidToIndex.end())
+    if (auto it = std::ranges::find(mapidToIndex, id, &std::pair<unsigned, unsigned>::first); it != mapidToIndex.end())
     {
         return it->second;
     }
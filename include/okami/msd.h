@@ -1,9 +1,13 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <map>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include "filebuffer.h"
+#include "serializer.hpp"
 
 namespace okami
 {
@@ -17,21 +21,70 @@ struct MSDHeader
 
 /**
  * @brief Used to modify MSD files by adding or replacing strings, and getting the new MSD data.
+ *
+ * ReadMSD() copies every string of an existing file into its own vector.
+ * OverlayMSD() instead copies the file's string region once, as a single
+ * block. Only overridden and added strings are stored separately; the
+ * rebuilt file holds a full offset table, the copied region and those
+ * strings. Every offset points forward into the rebuilt file itself, and
+ * nothing refers back to the original, which may be freed right away.
+ *
+ * Once built, the output keeps spare string space (and, in overlay mode,
+ * spare offset slots), so later OverrideString()/AddString() calls patch it
+ * in place: the string is appended to the spare space and its offset
+ * updated, without moving the buffer. Only when the spare space runs out is
+ * the file rebuilt.
  */
 class MSDManager
 {
   private:
-    std::vector<std::vector<uint16_t>> strings;
+    /// Spare string bytes kept after the last string for in-place updates.
+    static constexpr size_t kSpareStringBytes = 4096;
+    /// Spare offset slots kept in overlay mode for in-place additions.
+    static constexpr size_t kOverlaySpareEntries = 64;
+
+    bool overlay = false;
+    std::vector<uint8_t> base;                           // overlay: the original's string region
+    std::vector<uint64_t> baseOffsets;                   // overlay: offset of each original string into base
+    std::map<uint32_t, std::vector<uint16_t>> overrides; // overlay: patched original strings
+    std::vector<std::vector<uint16_t>> strings;          // strings after the original ones (all of them without an overlay)
 
     bool dirty = false;
-    FileBuffer compiledMSD;
+    ByteBuffer compiledMSD;
+    size_t tableCapacity = 0; // offset slots in compiledMSD
+    size_t usedBytes = 0;     // end of the last string in compiledMSD; spare space follows
 
     void MakeDirty();
     void Rebuild();
+    void Clear();
+    const std::vector<uint16_t> *OwnedString(uint32_t index) const;
+    std::vector<uint16_t> &OwnedSlot(uint32_t index);
+    bool PatchInPlace(uint32_t index, const std::vector<uint16_t> &str);
 
   public:
+    /**
+     * @brief Encodes a UTF-8 string as MSD glyphs.
+     *
+     * ASCII maps straight onto the font. Other characters use the nearest
+     * ASCII spelling (accents dropped, typographic punctuation flattened,
+     * full-width forms narrowed) or a single unsupported-glyph marker.
+     */
     static std::vector<uint16_t> CompileString(const std::string &str);
 
+    /// Upper bound on the code units CompileStringInto() writes for str, terminator included.
+    static constexpr size_t CompiledLength(std::string_view str)
+    {
+        return str.size() + 1;
+    }
+
+    /**
+     * @brief Encodes str like CompileString() into a caller-owned buffer without allocating.
+     *
+     * @param out Must hold at least CompiledLength(str) code units.
+     * @return size_t Code units written, or 0 if out is too small.
+     */
+    static size_t CompileStringInto(std::string_view str, std::span<uint16_t> out);
+
     MSDManager() = default;
 
     /**
@@ -41,6 +94,13 @@ class MSDManager
      */
     void ReadMSD(const void *pData);
 
+    /**
+     * @brief Reads original MSD content as one block, storing only later changes per string.
+     *
+     * @param pData Pointer to MSD data. Only read during this call.
+     */
+    void OverlayMSD(const void *pData);
+
     /**
      * @brief Adds a string to this MSD file.
      *
@@ -61,7 +121,9 @@ class MSDManager
     /**
      * @brief Retrieves the replacement MSD data to pass back to Okami.
      *
-     * @warning Data becomes invalidated when MSD is modified after this call.
+     * @warning Data becomes invalidated when a modification after this call
+     * does not fit in the spare space. Modifications that fit are applied to
+     * the returned buffer in place.
      *
      * @return const uint8_t* MSD data.
      */
@@ -73,5 +135,12 @@ class MSDManager
      * @return size_t number of strings
      */
     [[nodiscard]] size_t Size() const;
+
+    /**
+     * @brief Current string at an index, terminator included.
+     *
+     * @return const uint16_t* The string, or nullptr if index is out of range.
+     */
+    [[nodiscard]] const uint16_t *GetString(uint32_t index) const;
 };
 } // namespace okami
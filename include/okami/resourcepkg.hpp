@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace okami
@@ -40,6 +42,13 @@ class ResourcePackage
     /// Add a typed entry with the given raw data bytes.
     void addEntry(ResourceType type, std::span<const uint8_t> data);
 
+    /// Add an entry unless one with the same type and bytes is already in the
+    /// package, and return the index of the entry holding the data. Entry
+    /// sizes are implied by the next entry's offset, so two offset-table
+    /// entries can never share one blob; duplicates are folded into a single
+    /// entry that callers reference by index instead.
+    std::size_t addUniqueEntry(ResourceType type, std::span<const uint8_t> data);
+
     /// Add a blank (zero-length) entry with a null type tag.
     /// Used for the reserved index-0 slot.
     void addBlank();
@@ -55,7 +64,16 @@ class ResourcePackage
     /// Returns true on success, false on any I/O or encoding failure.
     [[nodiscard]] bool write(const std::filesystem::path &filename) const;
 
+    /// Size of the decrypted package image, including the 32-byte padding.
+    [[nodiscard]] std::size_t serializedSize() const;
+
+    /// Write the decrypted package image into a caller-owned buffer.
+    /// Returns the bytes written, or 0 if the buffer is smaller than serializedSize().
+    [[nodiscard]] std::size_t serializeInto(std::span<uint8_t> out) const;
+
   private:
+    template <typename Sink> void serialize(Sink &out) const;
+
     struct Entry
     {
         ResourceType type{};
@@ -63,6 +81,128 @@ class ResourcePackage
     };
 
     std::vector<Entry> m_entries;
+    std::unordered_multimap<uint64_t, std::size_t> m_byHash; // content hash -> entry, for addUniqueEntry
+    std::size_t m_hashed = 0;                                // entries [0, m_hashed) are in m_byHash
+};
+
+/// Streaming counterpart of ResourcePackage for large packages.
+///
+/// Entries are borrowed spans (which must stay valid until write() returns)
+/// or buffers moved into the writer, so nothing is copied up front. write()
+/// lays out the header from the entry sizes, then serializes, encrypts and
+/// writes the package kChunkBytes at a time through one reusable buffer, so
+/// peak memory stays at one chunk whatever the package size. The output is
+/// byte-for-byte what ResourcePackage::write() produces for the same entries.
+class ResourcePackageWriter
+{
+  public:
+    /// Plaintext bytes encrypted and written per step. A multiple of the
+    /// cipher block, and large enough to be split across the cipher's workers.
+    static constexpr std::size_t kChunkBytes = 1024 * 1024;
+
+    ResourcePackageWriter() = default;
+
+    ResourcePackageWriter(const ResourcePackageWriter &) = delete;
+    ResourcePackageWriter &operator=(const ResourcePackageWriter &) = delete;
+    ResourcePackageWriter(ResourcePackageWriter &&) = default;
+    ResourcePackageWriter &operator=(ResourcePackageWriter &&) = default;
+
+    /// Add an entry that borrows data; it must outlive write().
+    void addEntry(ResourceType type, std::span<const uint8_t> data);
+
+    /// Add an entry that takes ownership of data.
+    void addEntry(ResourceType type, std::vector<uint8_t> &&data);
+
+    /// Borrowing addEntry() that folds duplicates; see ResourcePackage::addUniqueEntry().
+    std::size_t addUniqueEntry(ResourceType type, std::span<const uint8_t> data);
+
+    /// Add a blank (zero-length) entry with a null type tag.
+    void addBlank();
+
+    /// Number of entries currently in the package (excluding the ROF sentinel).
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    /// Size of the decrypted package image, including the 32-byte padding.
+    [[nodiscard]] std::size_t serializedSize() const;
+
+    /// Encrypt and write the package to the given path.
+    /// Creates parent directories as needed.
+    /// Returns true on success, false on any I/O failure.
+    [[nodiscard]] bool write(const std::filesystem::path &filename) const;
+
+  private:
+    struct Entry
+    {
+        ResourceType type{};
+        std::span<const uint8_t> data{};
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<std::vector<uint8_t>> m_owned; // moved-in buffers; their storage never moves
+    std::unordered_multimap<uint64_t, std::size_t> m_byHash;
+    std::size_t m_hashed = 0;
+};
+
+/// Read-only view of an encrypted Okami resource package.
+///
+/// The file is memory-mapped copy-on-write and decrypted in place, but only
+/// where it is read: open() decrypts the header blocks and entry() decrypts
+/// the blocks an entry spans the first time it is asked for. ECB makes every
+/// 8-byte block independent, so untouched entries are never decrypted and
+/// their pages never leave the page cache. The file on disk is not modified.
+///
+/// entry() spans stay valid until the reader is closed, moved from or
+/// destroyed. Not safe for concurrent use.
+class ResourcePackageReader
+{
+  public:
+    ResourcePackageReader() = default;
+    ~ResourcePackageReader();
+
+    ResourcePackageReader(const ResourcePackageReader &) = delete;
+    ResourcePackageReader &operator=(const ResourcePackageReader &) = delete;
+    ResourcePackageReader(ResourcePackageReader &&other) noexcept;
+    ResourcePackageReader &operator=(ResourcePackageReader &&other) noexcept;
+
+    /// Map the package and decrypt its header. Closes any package already open.
+    /// Returns false if the file can't be mapped or the header is malformed.
+    [[nodiscard]] bool open(const std::filesystem::path &filename);
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept
+    {
+        return !m_view.empty();
+    }
+
+    /// Number of entries (excluding the ROF sentinel).
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+    [[nodiscard]] ResourceType type(std::size_t index) const noexcept;
+
+    /// Decrypted bytes of one entry, decrypting them on first access. The span
+    /// is writable so callers can patch the private copy; the file never changes.
+    [[nodiscard]] std::span<uint8_t> entry(std::size_t index);
+
+    /// Bytes decrypted so far, header included.
+    [[nodiscard]] std::size_t decryptedBytes() const noexcept
+    {
+        return m_decryptedBlocks * 8;
+    }
+
+  private:
+    [[nodiscard]] uint32_t offset(std::size_t index) const noexcept;
+    void decryptRange(std::size_t begin, std::size_t end);
+
+    std::span<uint8_t> m_view;           // whole mapped file
+    std::size_t m_count = 0;             // entries, excluding the ROF sentinel
+    std::vector<uint64_t> m_decrypted{}; // one bit per 8-byte block
+    std::size_t m_decryptedBlocks = 0;
 };
 
 } // namespace okami
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace okami
+{
+
+/// Anything that can be written by copying its object representation.
+template <typename T>
+concept ByteCopyable = std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief Binary serialization for the game's file formats (ISL, MSD, .dat)
+ *
+ * A serializer is a callable taking `auto &out` and calling write(),
+ * writeRange(), fill() and padTo() on it. It runs against a SizeCounter to
+ * get the exact output size, then against a SpanWriter over a buffer of that
+ * size, so every write is a bounds check plus one memcpy and the buffer
+ * never grows. Contiguous ranges of trivially copyable elements are copied
+ * in one memcpy rather than element by element.
+ *
+ * The serializer must write the same bytes on both passes.
+ */
+
+/// Counts bytes without writing them. Sized ranges cost O(1).
+class SizeCounter
+{
+  public:
+    template <ByteCopyable T> void write(const T &) noexcept
+    {
+        size_ += sizeof(T);
+    }
+
+    template <std::ranges::input_range R>
+        requires ByteCopyable<std::ranges::range_value_t<R>>
+    void writeRange(const R &range) noexcept
+    {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::sized_range<R>)
+            size_ += static_cast<size_t>(std::ranges::size(range)) * sizeof(T);
+        else
+            for (const auto &value : range)
+                write(value);
+    }
+
+    void fill(size_t count, [[maybe_unused]] uint8_t value = 0) noexcept
+    {
+        size_ += count;
+    }
+
+    void padTo(size_t alignment, [[maybe_unused]] uint8_t value = 0) noexcept
+    {
+        if (const size_t rem = size_ % alignment; rem != 0)
+            size_ += alignment - rem;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+  private:
+    size_t size_ = 0;
+};
+
+/// Writes into a fixed buffer it does not own. Writes past the end are
+/// dropped and latch overflowed().
+class SpanWriter
+{
+  public:
+    explicit SpanWriter(std::span<uint8_t> out) noexcept : out_(out)
+    {
+    }
+
+    template <ByteCopyable T> void write(const T &value) noexcept
+    {
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <std::ranges::input_range R>
+        requires ByteCopyable<std::ranges::range_value_t<R>>
+    void writeRange(const R &range) noexcept
+    {
+        using T = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> && std::ranges::sized_range<R>)
+            writeBytes(std::ranges::data(range), static_cast<size_t>(std::ranges::size(range)) * sizeof(T));
+        else
+            for (const auto &value : range)
+                write(value);
+    }
+
+    void fill(size_t count, uint8_t value = 0) noexcept
+    {
+        if (uint8_t *dst = reserve(count))
+            std::memset(dst, value, count);
+    }
+
+    void padTo(size_t alignment, uint8_t value = 0) noexcept
+    {
+        if (const size_t rem = pos_ % alignment; rem != 0)
+            fill(alignment - rem, value);
+    }
+
+    /// Bytes written so far.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return pos_;
+    }
+
+    [[nodiscard]] bool overflowed() const noexcept
+    {
+        return overflowed_;
+    }
+
+  private:
+    uint8_t *reserve(size_t count) noexcept
+    {
+        if (overflowed_ || count > out_.size() - pos_)
+        {
+            overflowed_ = true;
+            return nullptr;
+        }
+        uint8_t *dst = out_.data() + pos_;
+        pos_ += count;
+        return dst;
+    }
+
+    void writeBytes(const void *src, size_t count) noexcept
+    {
+        if (count == 0)
+            return;
+        if (uint8_t *dst = reserve(count))
+            std::memcpy(dst, src, count);
+    }
+
+    std::span<uint8_t> out_;
+    size_t pos_ = 0;
+    bool overflowed_ = false;
+};
+
+/// Exact output size of a serializer.
+template <typename Fn> [[nodiscard]] size_t serializedSize(Fn &&serialize)
+{
+    SizeCounter counter;
+    serialize(counter);
+    return counter.size();
+}
+
+/**
+ * @brief Serialize into a caller- or game-owned buffer
+ * @return Bytes written, or 0 if the output doesn't fit (the buffer may then
+ *         hold a partial image)
+ */
+template <typename Fn> [[nodiscard]] size_t serializeInto(std::span<uint8_t> out, Fn &&serialize)
+{
+    SpanWriter writer(out);
+    serialize(writer);
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+/// Owned output buffer, sized exactly once per build. Capacity is kept
+/// across rebuilds.
+class ByteBuffer
+{
+  public:
+    template <typename Fn> void build(Fn &&serialize)
+    {
+        buffer_.resize(serializedSize(serialize));
+        SpanWriter writer(buffer_);
+        serialize(writer);
+    }
+
+    void clear() noexcept
+    {
+        buffer_.clear();
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return buffer_.size();
+    }
+
+    [[nodiscard]] const uint8_t *data() const noexcept
+    {
+        return buffer_.data();
+    }
+
+    [[nodiscard]] std::vector<uint8_t> &bytes() noexcept
+    {
+        return buffer_;
+    }
+
+  private:
+    std::vector<uint8_t> buffer_;
+};
+
+} // namespace okami
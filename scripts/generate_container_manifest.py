@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Code generator for the container manifest.
+Reads containers.yml and generates a constexpr per-map table of container
+spawn indices for checks/container_manifest.hpp.
+"""
+
+import sys
+from pathlib import Path
+from typing import Any, Dict, List
+
+import yaml
+
+from generate_apitems import format_file_with_clang_format
+
+SPAWN_TABLE_ENTRY_COUNT = 128
+CONTAINER_BASE = 900000
+
+
+def container_check_id(level_id: int, spawn_idx: int) -> int:
+    """Mirror of checks::getContainerCheckId."""
+    return CONTAINER_BASE + (level_id << 8) + spawn_idx
+
+
+def validate(maps: List[Dict[str, Any]]) -> None:
+    seen_levels = set()
+    for m in maps:
+        level_id = m['level_id']
+        if level_id in seen_levels:
+            raise ValueError(f"level 0x{level_id:04X} listed twice")
+        seen_levels.add(level_id)
+
+        indices = m.get('containers', [])
+        if len(indices) != len(set(indices)):
+            raise ValueError(f"level 0x{level_id:04X} has duplicate spawn indices")
+        for idx in indices:
+            if not 0 <= idx < SPAWN_TABLE_ENTRY_COUNT:
+                raise ValueError(f"level 0x{level_id:04X} spawn index {idx} out of range")
+
+
+def generate_header(maps: List[Dict[str, Any]]) -> str:
+    """Generate the C++ header file content."""
+    maps = sorted(maps, key=lambda m: m['level_id'])
+    total = sum(len(m.get('containers', [])) for m in maps)
+
+    header = """#pragma once
+// Auto-generated by scripts/generate_container_manifest.py
+// Do not edit manually - regenerate by modifying src/okami-apclient/data/containers.yml
+
+#include <array>
+#include <cstdint>
+
+#include "container_manifest.hpp"
+
+namespace checks::container_manifest_data
+{
+
+"""
+
+    header += f"inline constexpr std::array<uint8_t, {total}> kSpawnIndices = {{"
+    header += "\n" if total else ""
+    for m in maps:
+        indices = sorted(m.get('containers', []))
+        if not indices:
+            continue
+        header += f"    // 0x{m['level_id']:04X} {m.get('name', '')}".rstrip() + "\n"
+        for idx in indices:
+            header += f"    {idx}, // {container_check_id(m['level_id'], idx)}\n"
+    header += "};\n\n"
+
+    header += f"inline constexpr std::array<ManifestMap, {len(maps)}> kMaps = {{"
+    header += "\n" if maps else ""
+    first = 0
+    for m in maps:
+        count = len(m.get('containers', []))
+        header += f"    ManifestMap{{0x{m['level_id']:04X}, {first}, {count}}},\n"
+        first += count
+    header += "};\n\n"
+
+    header += """} // namespace checks::container_manifest_data
+
+namespace checks
+{
+
+inline constexpr ContainerManifest kContainerManifest{container_manifest_data::kMaps, container_manifest_data::kSpawnIndices};
+static_assert(kContainerManifest.isValid(), "container manifest must be sorted by level with in-range spawn indices");
+
+} // namespace checks
+"""
+    return header
+
+
+def main():
+    if len(sys.argv) < 3:
+        print("Usage: generate_container_manifest.py <containers.yml> <output.hpp>")
+        sys.exit(1)
+
+    input_path = Path(sys.argv[1])
+    output_header = Path(sys.argv[2])
+
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent
+
+    with open(input_path, 'r', encoding='utf-8') as f:
+        data = yaml.safe_load(f) or {}
+
+    maps = data.get('maps') or []
+    validate(maps)
+
+    header_content = generate_header(maps)
+
+    output_header.parent.mkdir(parents=True, exist_ok=True)
+    with open(output_header, 'w', encoding='utf-8') as f:
+        f.write(header_content)
+
+    format_file_with_clang_format(output_header, project_root)
+
+    total = sum(len(m.get('containers', [])) for m in maps)
+    print(f"Generated manifest for {total} containers in {len(maps)} maps")
+    print(f"  Header: {output_header}")
+
+
+if __name__ == '__main__':
+    main()
@@ -3,6 +3,7 @@
 #include <wolf_framework.hpp>
 
 #include "checkman.h"
+#include "lifecycle.h"
 #include "rewardman.h"
 #include "ui/loginwindow.h"
 #include "ui/notificationwindow.h"
@@ -14,8 +15,10 @@
 #include <cinttypes>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include <version.h>
 
@@ -132,6 +135,14 @@ void ArchipelagoSocket::queueMainThreadTask(std::function<void()> task)
     mainThreadTasks_.push(std::move(task));
 }
 
+// Clears the connected flag and, if a live connection was actually dropped,
+// publishes Disconnected on the main thread.
+void ArchipelagoSocket::markDisconnected()
+{
+    if (connected_.exchange(false))
+        queueMainThreadTask([]() { lifecycle::publish(lifecycle::Disconnected{}); });
+}
+
 void ArchipelagoSocket::setStatus(const std::string &status)
 {
     {
@@ -299,14 +310,10 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
         [this]()
         {
             wolf::logDebug("[Socket] Socket disconnected");
-            connected_.store(false);
+            markDisconnected();
 
-            // Clear any pending scout requests so scoutLocationsSync doesn't hang
-            {
-                std::lock_guard<std::mutex> lock(scoutMutex_);
-                scoutPending_ = false;
-            }
-            scoutCondition_.notify_all();
+            // No reply will come for scouts still in flight
+            failPendingScouts();
 
             queueMainThreadTask([this]() { setStatus("Disconnected"); });
         });
@@ -325,12 +332,12 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
             wolf::logInfo("[Socket] Connected successfully!");
             connected_.store(true);
 
-            if (checkMan_)
-            {
-                checkMan_->enableSending(true);
-            }
-
-            queueMainThreadTask([this]() { setStatus("Connected successfully!"); });
+            queueMainThreadTask(
+                [this]()
+                {
+                    setStatus("Connected successfully!");
+                    lifecycle::publish(lifecycle::Connected{});
+                });
 
             // Load last processed item index for this session
             std::string saveKey = client_->get_slot() + "_" + client_->get_seed();
@@ -360,6 +367,7 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
                 slotConfig_ = SlotConfig::defaults();
             }
             slotConfigReady_.store(true, std::memory_order_release);
+            queueMainThreadTask([]() { lifecycle::publish(lifecycle::SlotConfigReady{}); });
 
             // Build valid location set from Connected packet
             {
@@ -379,14 +387,14 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
         [this]()
         {
             wolf::logWarning("[Socket] Slot disconnected");
-            connected_.store(false);
+            markDisconnected();
             queueMainThreadTask([this]() { setStatus("Disconnected from slot"); });
         });
 
     client_->set_slot_refused_handler(
         [this](const std::list<std::string> &errors)
         {
-            connected_.store(false);
+            markDisconnected();
             std::string errorMsg = "Connection refused: ";
             for (const auto &error : errors)
             {
@@ -466,18 +474,23 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
         {
             wolf::logDebug("[Socket] Received location info for %zu items", items.size());
 
-            // Store scouted items and signal waiting threads
+            if (scoutReplies_.empty())
             {
-                std::lock_guard<std::mutex> lock(scoutMutex_);
-                scoutedItems_.clear();
-                scoutedItems_.reserve(items.size());
-                for (const auto &item : items)
-                {
-                    scoutedItems_.push_back(ScoutedItem{.item = item.item, .location = item.location, .player = item.player, .flags = item.flags});
-                }
-                scoutPending_ = false;
+                wolf::logWarning("[Socket] Location info with no scout in flight; ignored");
+                return;
             }
-            scoutCondition_.notify_all();
+            ScoutReplyCallback onReply = std::move(scoutReplies_.front());
+            scoutReplies_.pop_front();
+            if (!onReply)
+                return;
+
+            std::vector<ScoutedItem> scouted;
+            scouted.reserve(items.size());
+            for (const auto &item : items)
+            {
+                scouted.push_back(ScoutedItem{.item = item.item, .location = item.location, .player = item.player, .flags = item.flags});
+            }
+            onReply(std::move(scouted));
         });
 
     client_->set_print_json_handler(
@@ -501,7 +514,7 @@ void ArchipelagoSocket::setupHandlers(const std::string &slot, const std::string
 
 void ArchipelagoSocket::disconnect()
 {
-    connected_.store(false);
+    markDisconnected();
     slotConfigReady_.store(false, std::memory_order_release);
     lastProcessedItemIndex_ = -1;
 
@@ -513,6 +526,7 @@ void ArchipelagoSocket::disconnect()
     std::lock_guard<std::mutex> lock(clientMutex_);
     if (client_)
     {
+        failPendingScouts();
         client_.reset();
         setStatus("Disconnected");
     }
@@ -546,6 +560,7 @@ void ArchipelagoSocket::poll()
                         connected_.store(false);
                         queueMainThreadTask([this]() { setStatus("Connection timed out"); });
                         // Clean up and return - don't throw
+                        failPendingScouts();
                         {
                             std::lock_guard<std::mutex> lock(clientMutex_);
                             client_.reset();
@@ -564,7 +579,7 @@ void ArchipelagoSocket::poll()
     catch (const std::exception &e)
     {
         bool wasConnected = connected_.load();
-        connected_.store(false);
+        markDisconnected();
 
         // Only log if we thought we were connected
         if (wasConnected)
@@ -576,6 +591,7 @@ void ArchipelagoSocket::poll()
         // Clean up failed connection
         {
             std::lock_guard<std::mutex> lock(clientMutex_);
+            failPendingScouts();
             client_.reset();
         }
     }
@@ -704,9 +720,9 @@ std::string ArchipelagoSocket::getConnectionInfo() const
     }
 }
 
-bool ArchipelagoSocket::scoutLocations(const std::list<int64_t> &locations, int createAsHint)
+std::list<int64_t> ArchipelagoSocket::validScoutLocations(const std::list<int64_t> &locations) const
 {
-    // Filter out invalid locations
+    // Scouting a location the APWorld lacks crashes the server, and no reply would come
     std::list<int64_t> validLocs;
     for (int64_t loc : locations)
     {
@@ -715,13 +731,23 @@ bool ArchipelagoSocket::scoutLocations(const std::list<int64_t> &locations, int
         else
             wolf::logWarning("[Socket] Skipping scout of invalid location %" PRId64, loc);
     }
+    return validLocs;
+}
 
-    if (validLocs.empty())
-        return true;
-
+bool ArchipelagoSocket::sendScouts(const std::list<int64_t> &validLocs, int createAsHint, const ScoutReplyCallback &onReply)
+{
     try
     {
-        return withClient([&validLocs, createAsHint](APClient &client) { return client.LocationScouts(validLocs, createAsHint); });
+        return withClient(
+            [&](APClient &client)
+            {
+                // Queued before sending so the reply always finds its handler
+                scoutReplies_.push_back(onReply);
+                if (client.LocationScouts(validLocs, createAsHint))
+                    return true;
+                scoutReplies_.pop_back();
+                return false;
+            });
     }
     catch (const std::exception &e)
     {
@@ -730,6 +756,41 @@ bool ArchipelagoSocket::scoutLocations(const std::list<int64_t> &locations, int
     }
 }
 
+void ArchipelagoSocket::failPendingScouts()
+{
+    auto pending = std::exchange(scoutReplies_, {});
+    for (auto &onReply : pending)
+    {
+        if (onReply)
+            onReply({});
+    }
+}
+
+bool ArchipelagoSocket::scoutLocations(const std::list<int64_t> &locations, int createAsHint)
+{
+    const auto validLocs = validScoutLocations(locations);
+    if (validLocs.empty())
+        return true;
+
+    return sendScouts(validLocs, createAsHint, {});
+}
+
+void ArchipelagoSocket::scoutLocationsAsync(const std::list<int64_t> &locations, int createAsHint, ScoutReplyCallback onReply)
+{
+    // The location info handler runs inside poll() with the client locked;
+    // the caller's handler runs afterwards from processMainThreadTasks()
+    ScoutReplyCallback deliver = [this, onReply = std::move(onReply)](std::vector<ScoutedItem> items)
+    { queueMainThreadTask([onReply, items = std::move(items)]() mutable { onReply(std::move(items)); }); };
+
+    const auto validLocs = isConnected() ? validScoutLocations(locations) : std::list<int64_t>{};
+    if (validLocs.empty() || !sendScouts(validLocs, createAsHint, deliver))
+    {
+        deliver({});
+        return;
+    }
+    wolf::logDebug("[Socket] Scouting %zu locations", validLocs.size());
+}
+
 std::vector<ScoutedItem> ArchipelagoSocket::scoutLocationsSync(const std::list<int64_t> &locations, int createAsHint, std::chrono::milliseconds timeout)
 {
     if (locations.empty())
@@ -743,17 +804,7 @@ std::vector<ScoutedItem> ArchipelagoSocket::scoutLocationsSync(const std::list<i
         return {};
     }
 
-    // Pre-filter invalid locations before setting scoutPending_ to avoid
-    // hanging on a response that will never arrive.
-    std::list<int64_t> validLocs;
-    for (int64_t loc : locations)
-    {
-        if (isValidLocation(loc))
-            validLocs.push_back(loc);
-        else
-            wolf::logWarning("[Socket] Skipping scout of invalid location %" PRId64, loc);
-    }
-
+    const auto validLocs = validScoutLocations(locations);
     if (validLocs.empty())
     {
         return {};
@@ -761,18 +812,22 @@ std::vector<ScoutedItem> ArchipelagoSocket::scoutLocationsSync(const std::list<i
 
     wolf::logDebug("[Socket] Scouting %zu locations synchronously", validLocs.size());
 
-    // Set up pending state
+    // Shared with the reply handler, which may outlive this call if it times out
+    struct Reply
+    {
+        bool done = false;
+        std::vector<ScoutedItem> items;
+    };
+    auto reply = std::make_shared<Reply>();
+    const bool sent = sendScouts(validLocs, createAsHint,
+                                 [this, reply](std::vector<ScoutedItem> items)
+                                 {
+                                     std::lock_guard<std::mutex> lock(scoutMutex_);
+                                     reply->items = std::move(items);
+                                     reply->done = true;
+                                 });
+    if (!sent)
     {
-        std::lock_guard<std::mutex> lock(scoutMutex_);
-        scoutedItems_.clear();
-        scoutPending_ = true;
-    }
-
-    // Send the scout request (validLocs already filtered above)
-    if (!scoutLocations(validLocs, createAsHint))
-    {
-        std::lock_guard<std::mutex> lock(scoutMutex_);
-        scoutPending_ = false;
         return {};
     }
 
@@ -784,11 +839,11 @@ std::vector<ScoutedItem> ArchipelagoSocket::scoutLocationsSync(const std::list<i
     {
         // Check if we got a response
         {
-            std::unique_lock<std::mutex> lock(scoutMutex_);
-            if (!scoutPending_)
+            std::lock_guard<std::mutex> lock(scoutMutex_);
+            if (reply->done)
             {
-                wolf::logDebug("[Socket] Scout completed, received %zu items", scoutedItems_.size());
-                return std::move(scoutedItems_);
+                wolf::logDebug("[Socket] Scout completed, received %zu items", reply->items.size());
+                return std::move(reply->items);
             }
         }
 
@@ -796,8 +851,6 @@ std::vector<ScoutedItem> ArchipelagoSocket::scoutLocationsSync(const std::list<i
         if (std::chrono::steady_clock::now() >= deadline)
         {
             wolf::logWarning("[Socket] Scout timed out after %lldms", timeout.count());
-            std::lock_guard<std::mutex> lock(scoutMutex_);
-            scoutPending_ = false;
             return {};
         }
 
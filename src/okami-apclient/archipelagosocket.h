@@ -1,7 +1,7 @@
 #pragma once
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -38,6 +38,7 @@ class ArchipelagoSocket : public ISocket
     std::string getStatus() const override;
 
     bool scoutLocations(const std::list<int64_t> &locations, int createAsHint) override;
+    void scoutLocationsAsync(const std::list<int64_t> &locations, int createAsHint, ScoutReplyCallback onReply) override;
     std::vector<ScoutedItem> scoutLocationsSync(const std::list<int64_t> &locations, int createAsHint = 0,
                                                 std::chrono::milliseconds timeout = std::chrono::seconds(5)) override;
     int getPlayerSlot() const override;
@@ -83,11 +84,11 @@ class ArchipelagoSocket : public ISocket
     // Item tracking
     int lastProcessedItemIndex_;
 
-    // Scout synchronization
-    mutable std::mutex scoutMutex_;
-    std::condition_variable scoutCondition_;
-    std::vector<ScoutedItem> scoutedItems_;
-    bool scoutPending_{false};
+    // Reply handlers for LocationScouts in flight, oldest first: the server
+    // answers them in the order they were sent. Only touched with
+    // clientMutex_ held. An empty handler ignores its reply.
+    std::deque<ScoutReplyCallback> scoutReplies_;
+    std::mutex scoutMutex_; // guards scoutLocationsSync's reply
 
     // Manager references (injected)
     class RewardMan *rewardMan_{nullptr};
@@ -102,9 +103,15 @@ class ArchipelagoSocket : public ISocket
 
     // Helpers
     void queueMainThreadTask(std::function<void()> task);
+    void markDisconnected();
     void setStatus(const std::string &status);
     void setupHandlers(const std::string &slot, const std::string &password);
 
+    // Scout helpers
+    std::list<int64_t> validScoutLocations(const std::list<int64_t> &locations) const;
+    bool sendScouts(const std::list<int64_t> &validLocs, int createAsHint, const ScoutReplyCallback &onReply);
+    void failPendingScouts(); // clientMutex_ held
+
     // Save/load helpers
     std::string getSaveFilePath(const std::string &saveKey) const;
     void saveLastItemIndex(const std::string &saveKey, int lastIndex);
@@ -1,12 +1,22 @@
 #include "checkman.h"
 
+#include <charconv>
 #include <cinttypes>
+#include <string>
 
 #include "checks/brushes.hpp"
+#include "checks/check_sources.hpp"
 #include "checks/containers.hpp"
 #include "checks/gamestate_monitors.hpp"
 #include "checks/shops.hpp"
 #include "isocket.h"
+#include "itempatch.hpp"
+
+namespace
+{
+constexpr const char *kTraceCommand = "ap_checks";
+constexpr size_t kTraceCommandRecentCount = 20;
+} // namespace
 
 CheckMan::CheckMan(ISocket &socket) : socket_(socket)
 {
@@ -27,12 +37,45 @@ void CheckMan::initialize()
 
     wolf::logInfo("[CheckMan] Initializing check manager");
 
-    // Register gameplay state callbacks
-    wolf::onPlayStart([this]() { enableSending(true); });
-    wolf::onReturnToMenu([this]() { enableSending(false); });
-
-    // Create callback for all monitors
-    auto callback = [this](int64_t checkId) { sendCheck(checkId); };
+    // Gameplay and connection state drive sending and brush blocking. Slot
+    // config arrives asynchronously after connect, so it gets its own event.
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::PlayStart>([this](const auto &) { onPlayStart(); }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::ReturnToMenu>([this](const auto &) { onReturnToMenu(); }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::Connected>([this](const auto &) { enableSending(true); }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::SlotConfigReady>(
+        [this](const auto &)
+        {
+            // Scouted names from a different seed or slot are stale
+            const auto &config = socket_.getSlotConfig();
+            itempatch::beginScoutedNameSession(config.seedNumber + ':' + std::to_string(socket_.getPlayerSlot()));
+            syncBrushActiveState();
+            if (containerHandler_)
+                containerHandler_->prefetchScouts();
+            if (shopHandler_)
+                shopHandler_->prepareShops();
+        }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::Disconnected>(
+        [this](const auto &)
+        {
+            syncBrushActiveState();
+            dumpCheckTrace();
+            if (shopHandler_)
+                shopHandler_->discardPreparedShops();
+        }));
+
+    wolf::addCommand(kTraceCommand, [this](const std::vector<std::string> &args) { handleTraceCommand(args); },
+                     "Check latency percentiles and recent timelines. Usage: ap_checks [checkId|dump]");
+
+    // Each detector gets its own callback so the trace records provenance
+    // Scans and hooks that call back directly detect and hand off in one step
+    auto callbackFrom = [this](checks::CheckOrigin origin)
+    {
+        return [this, origin](int64_t checkId)
+        {
+            const auto now = TraceClock::now();
+            sendCheck(checkId, origin, now, now);
+        };
+    };
 
     // Gamestate bitfield monitors (gameProgress, globalFlags, worldState,
     // collectedObjects, areasRestored) are disabled for now — they fire
@@ -42,12 +85,14 @@ void CheckMan::initialize()
     // which takes g_CallbackMutex. Doing this from poll() would deadlock
     // because the game-tick dispatcher holds that same mutex across user
     // callbacks. The hook stays inactive (no-op) until setActive(true).
-    brushHandler_ = std::make_unique<checks::BrushMan>(callback);
+    brushHandler_ = std::make_unique<checks::BrushMan>(
+        checks::BrushMan::TimedCheckCallback([this](int64_t checkId, TraceClock::time_point detectedAt)
+                                             { sendCheck(checkId, checks::CheckOrigin::BrushHook, detectedAt, TraceClock::now()); }));
     brushHandler_->initialize();
     syncBrushActiveState();
 
     // Set up container handler
-    containerHandler_ = std::make_unique<checks::ContainerMan>(socket_, callback);
+    containerHandler_ = std::make_unique<checks::ContainerMan>(socket_, callbackFrom(checks::CheckOrigin::ContainerPoll));
     containerHandler_->initialize();
 
     // Block the game from granting items when the player picks up randomized container items
@@ -55,15 +100,29 @@ void CheckMan::initialize()
         [this](int itemId, int count) -> bool
         {
             (void)count;
-            if (containerHandler_)
-                return containerHandler_->shouldBlockItemPickup(itemId);
-            return false;
+            if (!containerHandler_)
+                return false;
+            containerHandler_->notifyItemPickup();
+            return containerHandler_->shouldBlockItemPickup(itemId);
         });
 
     // Set up shop handler
-    shopHandler_ = std::make_unique<checks::ShopMan>(socket_, callback);
+    shopHandler_ = std::make_unique<checks::ShopMan>(socket_, callbackFrom(checks::CheckOrigin::ShopPurchase));
     shopHandler_->initialize();
 
+    // Registry-driven sources. Only locations the APWorld defines are sent,
+    // so registering a source ahead of the APWorld is harmless.
+    sourceScanner_ = std::make_unique<checks::CheckSourceScanner>(
+        [this](int64_t checkId)
+        {
+            if (socket_.isValidLocation(checkId))
+            {
+                const auto now = TraceClock::now();
+                sendCheck(checkId, checks::CheckOrigin::Bitfield, now, now);
+            }
+        });
+    sourceScanner_->initialize();
+
     initialized_ = true;
     wolf::logInfo("[CheckMan] Check manager initialized");
 }
@@ -95,19 +154,47 @@ void CheckMan::shutdown()
         return;
     }
 
+    subscriptions_.clear();
+    wolf::removeCommand(kTraceCommand);
     destroyMonitors();
     brushHandler_.reset();
     containerHandler_.reset();
     shopHandler_.reset();
+    sourceScanner_.reset();
     initialized_ = false;
 }
 
 void CheckMan::enableSending(bool enabled)
 {
+    if (sourceScanner_ && inGameplay_ && enabled != sendingEnabled_)
+    {
+        // Flush player progress before a pause, and swallow whatever changed
+        // while paused (reward grants) so it isn't reported as a check.
+        if (!enabled)
+            sourceScanner_->scan();
+        else
+            sourceScanner_->rebaseline();
+    }
+
     sendingEnabled_ = enabled;
     syncBrushActiveState();
 }
 
+void CheckMan::onPlayStart()
+{
+    // The save was just loaded; its already-collected bits aren't new checks.
+    inGameplay_ = true;
+    if (sourceScanner_)
+        sourceScanner_->rebaseline();
+    enableSending(true);
+}
+
+void CheckMan::onReturnToMenu()
+{
+    enableSending(false);
+    inGameplay_ = false;
+}
+
 bool CheckMan::isSendingEnabled() const
 {
     return sendingEnabled_;
@@ -124,16 +211,16 @@ void CheckMan::syncBrushActiveState()
 
 void CheckMan::poll()
 {
-    // Re-evaluate brush active state every tick. Slot config arrival is
-    // asynchronous (post-connect) and we have no event for it; this is the
-    // cheap, no-callback way to pick it up.
-    syncBrushActiveState();
-
     if (brushHandler_)
     {
         brushHandler_->tick();
     }
 
+    if (sourceScanner_ && inGameplay_ && sendingEnabled_)
+    {
+        sourceScanner_->scan();
+    }
+
     if (containerHandler_)
     {
         containerHandler_->poll();
@@ -154,7 +241,8 @@ void CheckMan::onShopPurchase(int shopId, int itemSlot, int itemId)
     }
 
     int64_t checkId = checks::getShopCheckId(shopId, itemSlot);
-    sendCheck(checkId);
+    const auto now = TraceClock::now();
+    sendCheck(checkId, checks::CheckOrigin::ShopPurchase, now, now);
 }
 
 // ========================================
@@ -171,6 +259,8 @@ void CheckMan::clearSentChecks()
 
 void CheckMan::syncWithServer(const std::list<int64_t> &serverCheckedLocations)
 {
+    trace_.markConfirmed(serverCheckedLocations);
+
     // Add server-confirmed checks to local cache
     for (int64_t loc : serverCheckedLocations)
     {
@@ -233,11 +323,15 @@ size_t CheckMan::getSentCount() const
 // Check sending and deduplication
 // ========================================
 
-void CheckMan::sendCheck(int64_t checkId)
+void CheckMan::sendCheck(int64_t checkId, checks::CheckOrigin origin, TraceClock::time_point detectedAt, TraceClock::time_point queuedAt)
 {
+    checks::CheckTraceEntry trace{.checkId = checkId, .origin = origin, .detected = detectedAt, .queued = queuedAt};
+
     if (!sendingEnabled_ || !socket_.isConnected())
     {
         wolf::logDebug("[CheckMan] Skipped check %" PRId64 " (sending=%d, connected=%d)", checkId, sendingEnabled_ ? 1 : 0, socket_.isConnected() ? 1 : 0);
+        trace.outcome = checks::CheckOutcome::NotSending;
+        trace_.record(trace);
         return;
     }
 
@@ -246,10 +340,14 @@ void CheckMan::sendCheck(int64_t checkId)
         wolf::logDebug("[CheckMan] Skipped check %" PRId64 " (already sent in this session "
                        "or synced from server)",
                        checkId);
+        trace.outcome = checks::CheckOutcome::Duplicate;
+        trace_.record(trace);
         return;
     }
 
     socket_.sendLocation(checkId);
+    trace.sent = TraceClock::now();
+    trace_.record(trace);
     markCheckSent(checkId);
 
     wolf::logInfo("[CheckMan] Sent check: %" PRId64 " (total: %zu)", checkId, sentChecks_.size());
@@ -319,6 +417,58 @@ void CheckMan::setOnCheckSentCallback(std::function<void()> callback)
     onCheckSentCallback_ = std::move(callback);
 }
 
+// ========================================
+// Check tracing
+// ========================================
+
+const checks::CheckTrace &CheckMan::getCheckTrace() const
+{
+    return trace_;
+}
+
+void CheckMan::setTraceDumpPath(std::filesystem::path path)
+{
+    traceDumpPath_ = std::move(path);
+}
+
+bool CheckMan::dumpCheckTrace() const
+{
+    if (traceDumpPath_.empty() || trace_.size() == 0)
+        return false;
+    return trace_.dumpToFile(traceDumpPath_);
+}
+
+void CheckMan::handleTraceCommand(const std::vector<std::string> &args) const
+{
+    // args[0] is the command name
+    if (args.size() < 2)
+    {
+        for (const auto &line : trace_.formatReport(kTraceCommandRecentCount))
+            wolf::logInfo("[CheckMan] %s", line.c_str());
+        return;
+    }
+
+    if (args[1] == "dump")
+    {
+        if (!dumpCheckTrace())
+            wolf::logWarning("[CheckMan] Nothing to dump");
+        return;
+    }
+
+    int64_t checkId = 0;
+    const auto &arg = args[1];
+    if (std::from_chars(arg.data(), arg.data() + arg.size(), checkId).ec != std::errc{})
+    {
+        wolf::logWarning("[CheckMan] Usage: %s [checkId|dump]", kTraceCommand);
+        return;
+    }
+
+    if (auto entry = trace_.find(checkId))
+        wolf::logInfo("[CheckMan] %s", checks::CheckTrace::formatTimeline(*entry).c_str());
+    else
+        wolf::logInfo("[CheckMan] No trace for check %" PRId64 " in the last %zu checks", checkId, checks::CheckTrace::kCapacity);
+}
+
 bool CheckMan::isContainerInRando(int64_t locationId) const
 {
     if (containerHandler_)
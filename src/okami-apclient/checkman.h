@@ -1,15 +1,19 @@
 #pragma once
 
 #include <cstdint>
+#include <filesystem>
 #include <functional>
 #include <list>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
 #include <wolf_framework.hpp>
 
+#include "checks/check_trace.hpp"
 #include "checks/check_types.hpp"
+#include "lifecycle.h"
 
 // Forward declarations
 class ISocket;
@@ -17,6 +21,7 @@ class ISocket;
 namespace checks
 {
 class BrushMan;
+class CheckSourceScanner;
 class ContainerMan;
 class ShopMan;
 } // namespace checks
@@ -30,7 +35,12 @@ class ShopMan;
  * - Server communication
  * - Event forwarding to handlers
  * - Memory monitoring for bitfield-based checks
+ * - Registry-driven bitfield scanning (checks/check_sources.hpp)
  * - Container randomization polling
+ * - Per-check provenance and latency tracing (`ap_checks` console command)
+ *
+ * Sending and brush blocking follow lifecycle events (connect, slot config,
+ * play start, return to menu, disconnect) rather than per-tick polling.
  */
 class CheckMan
 {
@@ -138,12 +148,36 @@ class CheckMan
      */
     void setOnCheckSentCallback(std::function<void()> callback);
 
+    /**
+     * @brief Provenance and latency ring for recently detected checks
+     */
+    [[nodiscard]] const checks::CheckTrace &getCheckTrace() const;
+
+    /**
+     * @brief Where the check trace is written on disconnect (empty disables)
+     */
+    void setTraceDumpPath(std::filesystem::path path);
+
+    /**
+     * @brief Write the check trace to the configured dump path now
+     * @return true if a file was written
+     */
+    bool dumpCheckTrace() const;
+
   private:
+    using TraceClock = checks::CheckTrace::Clock;
+
     /**
      * @brief Send a check to the server
      * @param checkId The check ID to send
+     * @param origin Which detector produced the check (for tracing)
+     * @param detectedAt When the detector saw it; earlier than queuedAt for hooks that queue
+     * @param queuedAt When the detector handed it to CheckMan (BrushMan drain, scan callback)
      */
-    void sendCheck(int64_t checkId);
+    void sendCheck(int64_t checkId, checks::CheckOrigin origin, TraceClock::time_point detectedAt, TraceClock::time_point queuedAt);
+
+    // Console command handler: `ap_checks [checkId|dump]`
+    void handleTraceCommand(const std::vector<std::string> &args) const;
 
     /**
      * @brief Check if a check has already been sent
@@ -160,8 +194,12 @@ class CheckMan
      */
     void destroyMonitors();
 
+    // PlayStart / ReturnToMenu handlers
+    void onPlayStart();
+    void onReturnToMenu();
+
     // Recomputes whether BrushMan should block-and-send and pushes that to
-    // the handler. Cheap (atomic exchange); safe to call every tick.
+    // the handler. Runs on every lifecycle event that can change the answer.
     void syncBrushActiveState();
 
     // Socket reference for sending checks
@@ -189,9 +227,22 @@ class CheckMan
     // Shop handler (owns hooks and shop definitions)
     std::unique_ptr<checks::ShopMan> shopHandler_;
 
+    // Scanner for every registered CheckSource (tomes, dig spots, fights)
+    std::unique_ptr<checks::CheckSourceScanner> sourceScanner_;
+
+    // Between PlayStart and ReturnToMenu; the scanner only runs in gameplay
+    bool inGameplay_ = false;
+
     // Callback invoked after each check is sent (for auto-save)
     std::function<void()> onCheckSentCallback_;
 
+    // Detection-to-confirmation timeline of recent checks
+    checks::CheckTrace trace_;
+    std::filesystem::path traceDumpPath_ = "./check_trace.log";
+
     // Initialization state
     bool initialized_ = false;
+
+    // Lifecycle bus subscriptions (released first on destruction)
+    std::vector<lifecycle::Subscription> subscriptions_;
 };
@@ -80,14 +80,24 @@ bool dispatchBrushEdit(int bitIndex, int operation, BrushMan &handler)
         return false;
 
     const int64_t checkId = getBrushCheckId(bitIndex);
+    const auto detectedAt = std::chrono::steady_clock::now();
     {
         std::lock_guard<std::mutex> lock(handler.pendingMutex_);
-        handler.pendingChecks_.push_back(checkId);
+        handler.pendingChecks_.push_back({checkId, detectedAt});
     }
     return true;
 }
 
-BrushMan::BrushMan(CheckCallback checkCallback) : checkCallback_(std::move(checkCallback))
+BrushMan::BrushMan(CheckCallback checkCallback)
+    : BrushMan(TimedCheckCallback([cb = std::move(checkCallback)](int64_t id, std::chrono::steady_clock::time_point)
+                                  {
+                                      if (cb)
+                                          cb(id);
+                                  }))
+{
+}
+
+BrushMan::BrushMan(TimedCheckCallback checkCallback) : checkCallback_(std::move(checkCallback))
 {
     wolf::logDebug("[BrushMan] constructed");
 }
@@ -164,16 +174,16 @@ void BrushMan::tick()
 
     // Drain queued checks. We swap-out under the lock so checkCallback runs
     // outside it (callback may take other mutexes / do I/O).
-    std::vector<int64_t> drained;
+    std::vector<PendingCheck> drained;
     {
         std::lock_guard<std::mutex> lock(pendingMutex_);
         drained.swap(pendingChecks_);
     }
-    for (int64_t id : drained)
+    for (const auto &[id, detectedAt] : drained)
     {
         wolf::logInfo("[BrushMan] check sent for bit=%d (id=%" PRId64 ")", static_cast<int>(id - checks::kBrushAcquisitionBase), id);
         if (checkCallback_)
-            checkCallback_(id);
+            checkCallback_(id, detectedAt);
     }
 
     // Clear Celestial Brush Locked UI gate. The game sets this bit during
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <mutex>
@@ -13,8 +14,8 @@ namespace checks
  *
  * Hooks main.dll +0x17C270 via wolf::onBrushEdit. The hook runs inside wolf's
  * g_CallbackMutex, so we do as little as possible there: bounds-check,
- * transition-check, queue, return. checkCallback runs from tick() on the
- * game tick.
+ * transition-check, timestamp, queue, return. checkCallback runs from tick()
+ * on the game tick.
  *
  * Blocking is gated by setActive(true). Inactive = diagnostic no-op.
  */
@@ -22,8 +23,11 @@ class BrushMan
 {
   public:
     using CheckCallback = std::function<void(int64_t)>;
+    // Also receives when the hook fired, so check tracing sees the queueing delay.
+    using TimedCheckCallback = std::function<void(int64_t, std::chrono::steady_clock::time_point)>;
 
     explicit BrushMan(CheckCallback checkCallback);
+    explicit BrushMan(TimedCheckCallback checkCallback);
     ~BrushMan();
 
     BrushMan(const BrushMan &) = delete;
@@ -43,11 +47,17 @@ class BrushMan
     void tick();
 
   private:
-    CheckCallback checkCallback_;
+    struct PendingCheck
+    {
+        int64_t checkId;
+        std::chrono::steady_clock::time_point detectedAt;
+    };
+
+    TimedCheckCallback checkCallback_;
     bool initialized_ = false;
 
     std::mutex pendingMutex_;
-    std::vector<int64_t> pendingChecks_;
+    std::vector<PendingCheck> pendingChecks_;
 
     friend bool dispatchBrushEdit(int bitIndex, int operation, BrushMan &handler);
 };
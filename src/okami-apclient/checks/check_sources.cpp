@@ -0,0 +1,127 @@
+#include "check_sources.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <wolf_framework.hpp>
+
+namespace checks
+{
+
+namespace
+{
+constexpr size_t kMaxRegionBytes = 32;
+static_assert(std::ranges::all_of(kCheckSources, [](const CheckSource &src) { return src.byteCount() <= kMaxRegionBytes; }),
+              "check source region larger than the scan buffer");
+} // namespace
+
+namespace detail
+{
+
+void forEachRisingBit(BitOrder order, unsigned bitCount, const uint8_t *oldBytes, const uint8_t *newBytes, size_t byteCount,
+                      const std::function<void(unsigned)> &fn)
+{
+    if (order == BitOrder::Msb0Word32)
+    {
+        for (size_t w = 0; w < byteCount / 4u; w++)
+        {
+            uint32_t oldWord;
+            uint32_t newWord;
+            std::memcpy(&oldWord, oldBytes + w * 4, sizeof(uint32_t));
+            std::memcpy(&newWord, newBytes + w * 4, sizeof(uint32_t));
+            for (uint32_t rising = ~oldWord & newWord; rising != 0; rising &= rising - 1)
+            {
+                const unsigned bit = static_cast<unsigned>(w * 32 + (31 - std::countr_zero(rising)));
+                if (bit < bitCount)
+                    fn(bit);
+            }
+        }
+        return;
+    }
+
+    for (size_t b = 0; b < byteCount; b++)
+    {
+        for (unsigned rising = static_cast<uint8_t>(~oldBytes[b] & newBytes[b]); rising != 0; rising &= rising - 1)
+        {
+            const unsigned bit = static_cast<unsigned>(b * 8 + std::countr_zero(rising));
+            if (bit < bitCount)
+                fn(bit);
+        }
+    }
+}
+
+} // namespace detail
+
+CheckSourceScanner::CheckSourceScanner(CheckCallback checkCallback) : checkCallback_(std::move(checkCallback))
+{
+}
+
+void CheckSourceScanner::initialize()
+{
+    const uintptr_t base = wolf::getModuleBase("main.dll");
+    if (base == 0)
+    {
+        wolf::logError("[CheckSources] main.dll not found; check sources disabled");
+        return;
+    }
+
+    regions_.clear();
+    size_t shadowSize = 0;
+    for (size_t s = 0; s < kCheckSources.size(); s++)
+    {
+        const auto &src = kCheckSources[s];
+        for (uint16_t n = 0; n < src.instanceCount; n++)
+        {
+            regions_.push_back(Region{
+                .live = reinterpret_cast<const uint8_t *>(base + src.offset + static_cast<uintptr_t>(n) * src.instanceStride),
+                .shadowOffset = shadowSize,
+                .sourceIndex = static_cast<uint16_t>(s),
+                .instance = n,
+                .byteCount = static_cast<uint16_t>(src.byteCount()),
+            });
+            shadowSize += src.byteCount();
+        }
+    }
+    shadow_.assign(shadowSize, 0);
+    rebaseline();
+
+    wolf::logInfo("[CheckSources] Watching %zu sources (%zu regions, %zu bytes)", kCheckSources.size(), regions_.size(), shadow_.size());
+}
+
+void CheckSourceScanner::rebaseline()
+{
+    for (const auto &region : regions_)
+        std::memcpy(shadow_.data() + region.shadowOffset, region.live, region.byteCount);
+}
+
+void CheckSourceScanner::scan()
+{
+    for (const auto &region : regions_)
+    {
+        uint8_t *shadow = shadow_.data() + region.shadowOffset;
+        if (std::memcmp(shadow, region.live, region.byteCount) == 0)
+            continue;
+
+        // Copy first: the callback may grant/toggle state, and the live bytes
+        // can change under us. Decode against a stable snapshot.
+        uint8_t current[kMaxRegionBytes];
+        std::memcpy(current, region.live, region.byteCount);
+
+        const auto &src = kCheckSources[region.sourceIndex];
+        detail::forEachRisingBit(src.order, src.bitCount, shadow, current, region.byteCount,
+                                 [&](unsigned bit)
+                                 {
+                                     if (checkCallback_)
+                                         checkCallback_(src.checkId(region.instance, bit));
+                                 });
+        std::memcpy(shadow, current, region.byteCount);
+    }
+}
+
+size_t CheckSourceScanner::regionCount() const
+{
+    return regions_.size();
+}
+
+} // namespace checks
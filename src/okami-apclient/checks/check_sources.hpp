@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <okami/maptype.hpp>
+#include <okami/offsets.hpp>
+#include <okami/structs.hpp>
+
+#include "check_types.hpp"
+
+namespace checks
+{
+
+/**
+ * @brief How a source's logical bit index maps onto memory
+ */
+enum class BitOrder : uint8_t
+{
+    Msb0Word32, // okami::BitField<N>: bit i at word i/32, mask 0x80000000 >> (i%32)
+    Lsb0Byte,   // raw game bytes: bit i at byte i/8, mask 1 << (i%8)
+};
+
+/**
+ * @brief Declarative description of one bitfield that produces checks
+ *
+ * A 0->1 transition of logical bit `b` in instance `n` sends check
+ * idBase + n*idStride + b. Single-instance sources leave the instance
+ * fields at their defaults.
+ */
+struct CheckSource
+{
+    const char *name;
+    uintptr_t offset; // main.dll-relative address of instance 0
+    uint16_t bitCount;
+    BitOrder order;
+    int64_t idBase;
+    uint16_t instanceCount = 1;
+    uint32_t instanceStride = 0; // bytes between instances
+    int64_t idStride = 0;        // check IDs between instances
+
+    /// Bytes to read per instance (whole words for Msb0Word32)
+    constexpr size_t byteCount() const
+    {
+        return order == BitOrder::Msb0Word32 ? ((bitCount + 31u) / 32u) * 4u : (bitCount + 7u) / 8u;
+    }
+
+    constexpr int64_t checkId(unsigned instance, unsigned bitIndex) const
+    {
+        return idBase + static_cast<int64_t>(instance) * idStride + bitIndex;
+    }
+};
+
+namespace detail
+{
+constexpr uintptr_t collectionField(size_t fieldOffset)
+{
+    return okami::main::collectionData + fieldOffset;
+}
+
+constexpr uintptr_t mapStateField(size_t fieldOffset)
+{
+    return okami::main::mapData + fieldOffset;
+}
+
+inline constexpr uint16_t kNumMapTypes = static_cast<uint16_t>(okami::MapTypes::NUM_MAP_TYPES);
+} // namespace detail
+
+// clang-format off
+/// Every bitfield-backed check source the scanner watches.
+inline constexpr std::array kCheckSources = {
+    CheckSource{"StrayBeads", detail::collectionField(offsetof(okami::CollectionData, strayBeadsCollected)),
+                okami::BitField<okami::StrayBeads::NUM_STRAY_BEADS>::count, BitOrder::Msb0Word32, kStrayBeadBase},
+    CheckSource{"TravelGuides", detail::collectionField(offsetof(okami::CollectionData, travelGuidesCollected)),
+                okami::BitField<okami::TravelGuides::NUM_TRAVEL_GUIDES>::count, BitOrder::Msb0Word32, kTravelGuideBase},
+    CheckSource{"DojoMoves", detail::collectionField(offsetof(okami::CollectionData, dojoMovesCollected)),
+                okami::BitField<okami::MoveListTome::NUM_MOVE_LIST_ENTRIES>::count, BitOrder::Msb0Word32, kDojoMoveBase},
+    CheckSource{"FishTome", detail::collectionField(offsetof(okami::CollectionData, fishTomesCollected)),
+                okami::BitField<okami::FishTome::NUM_FISH_ENTRIES>::count, BitOrder::Msb0Word32, kFishTomeBase},
+    CheckSource{"AnimalTome", detail::collectionField(offsetof(okami::CollectionData, animalTomesCollected)),
+                okami::BitField<okami::Animals::NUM_ANIMALS>::count, BitOrder::Msb0Word32, kAnimalTomeBase},
+    CheckSource{"TreasureTome", detail::collectionField(offsetof(okami::CollectionData, treasureTomesCollected)),
+                okami::BitField<okami::Treasures::NUM_TREASURES>::count, BitOrder::Msb0Word32, kTreasureTomeBase},
+    CheckSource{"DigSpots", detail::mapStateField(offsetof(okami::MapState, unburiedObjects)),
+                96, BitOrder::Msb0Word32, kDigSpotBase, detail::kNumMapTypes, sizeof(okami::MapState), kPerMapCheckStride},
+    CheckSource{"FightsCleared", detail::mapStateField(offsetof(okami::MapState, fightsCleared)),
+                128, BitOrder::Msb0Word32, kFightClearedBase, detail::kNumMapTypes, sizeof(okami::MapState), kPerMapCheckStride},
+};
+// clang-format on
+
+// Registry invariants: every source fits its ID range without spilling into the next.
+static_assert(decltype(okami::MapState::unburiedObjects)::count == 96);
+static_assert(decltype(okami::MapState::fightsCleared)::count == 128);
+static_assert([]
+              {
+                  for (const auto &src : kCheckSources)
+                  {
+                      const int64_t span = src.instanceCount > 1 ? src.idStride : 1000;
+                      if (src.bitCount > span)
+                          return false;
+                  }
+                  return true;
+              }(),
+              "check source bit count overflows its ID stride");
+static_assert(getDigSpotCheckId(detail::kNumMapTypes, 0) <= kFightClearedBase, "dig spot IDs overlap fights cleared");
+static_assert(getFightClearedCheckId(detail::kNumMapTypes, 0) <= kFightClearedEnd, "fights cleared IDs overflow their range");
+
+namespace detail
+{
+/// Decode every 0->1 bit between two snapshots of one region, as logical
+/// indices < bitCount in the given bit order.
+void forEachRisingBit(BitOrder order, unsigned bitCount, const uint8_t *oldBytes, const uint8_t *newBytes, size_t byteCount,
+                      const std::function<void(unsigned)> &fn);
+} // namespace detail
+
+/**
+ * @brief Single diff-based scanner over every registered CheckSource
+ *
+ * Keeps one shadow copy of all watched bytes. scan() compares each region
+ * against its shadow with a memcmp and only decodes regions that changed,
+ * so adding a source costs a few bytes of compare, not a monitor or hook.
+ *
+ * Main-thread only.
+ */
+class CheckSourceScanner
+{
+  public:
+    using CheckCallback = std::function<void(int64_t)>;
+
+    explicit CheckSourceScanner(CheckCallback checkCallback);
+
+    /// Resolve addresses against main.dll and take the initial baseline.
+    void initialize();
+
+    /// Accept current memory as the baseline without emitting checks
+    /// (save loads, reward grants).
+    void rebaseline();
+
+    /// Emit a check for every 0->1 transition since the last scan/baseline.
+    void scan();
+
+    /// Number of watched byte regions (source instances)
+    [[nodiscard]] size_t regionCount() const;
+
+  private:
+    struct Region
+    {
+        const uint8_t *live;
+        size_t shadowOffset;
+        uint16_t sourceIndex;
+        uint16_t instance;
+        uint16_t byteCount;
+    };
+
+    CheckCallback checkCallback_;
+    std::vector<Region> regions_;
+    std::vector<uint8_t> shadow_;
+};
+
+} // namespace checks
@@ -0,0 +1,247 @@
+#include "check_trace.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+
+#include <wolf_framework.hpp>
+
+namespace checks
+{
+
+namespace
+{
+
+using Clock = CheckTrace::Clock;
+
+bool reached(Clock::time_point t)
+{
+    return t != Clock::time_point{};
+}
+
+std::chrono::microseconds toMicros(Clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(d);
+}
+
+// Nearest-rank percentile over an ascending sample set.
+std::chrono::microseconds percentile(const std::vector<std::chrono::microseconds> &sorted, unsigned pct)
+{
+    const size_t rank = (sorted.size() * pct + 99) / 100;
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+CheckTrace::LatencySummary summarize(const std::vector<CheckTraceEntry> &entries, Clock::time_point CheckTraceEntry::*from,
+                                     Clock::time_point CheckTraceEntry::*to)
+{
+    std::vector<std::chrono::microseconds> samples;
+    samples.reserve(entries.size());
+    for (const auto &e : entries)
+    {
+        if (reached(e.*from) && reached(e.*to))
+            samples.push_back(toMicros(e.*to - e.*from));
+    }
+
+    CheckTrace::LatencySummary summary;
+    summary.samples = samples.size();
+    if (samples.empty())
+        return summary;
+
+    std::ranges::sort(samples);
+    summary.p50 = percentile(samples, 50);
+    summary.p90 = percentile(samples, 90);
+    summary.p99 = percentile(samples, 99);
+    summary.max = samples.back();
+    return summary;
+}
+
+std::string formatSummary(const char *label, const CheckTrace::LatencySummary &s)
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "%s: n=%zu p50=%lldus p90=%lldus p99=%lldus max=%lldus", label, s.samples, static_cast<long long>(s.p50.count()),
+                  static_cast<long long>(s.p90.count()), static_cast<long long>(s.p99.count()), static_cast<long long>(s.max.count()));
+    return line;
+}
+
+} // namespace
+
+const char *toString(CheckOrigin origin)
+{
+    switch (origin)
+    {
+    case CheckOrigin::BrushHook:
+        return "brush";
+    case CheckOrigin::ContainerPoll:
+        return "container";
+    case CheckOrigin::ShopPurchase:
+        return "shop";
+    case CheckOrigin::Bitfield:
+        return "bitfield";
+    case CheckOrigin::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+const char *toString(CheckOutcome outcome)
+{
+    switch (outcome)
+    {
+    case CheckOutcome::Sent:
+        return "sent";
+    case CheckOutcome::Duplicate:
+        return "duplicate";
+    case CheckOutcome::NotSending:
+        return "not-sending";
+    }
+    return "unknown";
+}
+
+void CheckTrace::record(const CheckTraceEntry &entry)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring_[head_ % kCapacity] = entry;
+    ++head_;
+}
+
+size_t CheckTrace::markConfirmed(const std::list<int64_t> &serverCheckedLocations, Clock::time_point now)
+{
+    // Sent, unconfirmed IDs, sorted, so the server's list is walked only once
+    std::vector<int64_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = std::min(head_, kCapacity);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (ring_[i].outcome == CheckOutcome::Sent && !reached(ring_[i].confirmed))
+                pending.push_back(ring_[i].checkId);
+        }
+    }
+    if (pending.empty())
+        return 0;
+    std::ranges::sort(pending);
+
+    // The list can hold every checked location of the slot; walk it unlocked
+    std::vector<int64_t> checked;
+    for (const int64_t id : serverCheckedLocations)
+    {
+        if (std::ranges::binary_search(pending, id))
+            checked.push_back(id);
+    }
+    if (checked.empty())
+        return 0;
+    std::ranges::sort(checked);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = std::min(head_, kCapacity);
+    size_t confirmed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto &e = ring_[i];
+        if (e.outcome != CheckOutcome::Sent || reached(e.confirmed))
+            continue;
+        if (std::ranges::binary_search(checked, e.checkId))
+        {
+            e.confirmed = now;
+            ++confirmed;
+        }
+    }
+    return confirmed;
+}
+
+std::vector<CheckTraceEntry> CheckTrace::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = std::min(head_, kCapacity);
+    std::vector<CheckTraceEntry> out;
+    out.reserve(count);
+    for (size_t i = head_ - count; i < head_; ++i)
+        out.push_back(ring_[i % kCapacity]);
+    return out;
+}
+
+std::optional<CheckTraceEntry> CheckTrace::find(int64_t checkId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = std::min(head_, kCapacity);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto &e = ring_[(head_ - 1 - i) % kCapacity];
+        if (e.checkId == checkId)
+            return e;
+    }
+    return std::nullopt;
+}
+
+CheckTrace::LatencySummary CheckTrace::detectToSend() const
+{
+    return summarize(snapshot(), &CheckTraceEntry::detected, &CheckTraceEntry::sent);
+}
+
+CheckTrace::LatencySummary CheckTrace::sendToConfirm() const
+{
+    return summarize(snapshot(), &CheckTraceEntry::sent, &CheckTraceEntry::confirmed);
+}
+
+size_t CheckTrace::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::min(head_, kCapacity);
+}
+
+void CheckTrace::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    head_ = 0;
+}
+
+std::string CheckTrace::formatTimeline(const CheckTraceEntry &entry)
+{
+    // Stages are shown relative to detection; "-" marks a stage never reached.
+    auto stage = [&](Clock::time_point t) -> std::string
+    {
+        if (!reached(t))
+            return "-";
+        return "+" + std::to_string(toMicros(t - entry.detected).count()) + "us";
+    };
+
+    char line[192];
+    std::snprintf(line, sizeof(line), "%" PRId64 " %-9s %-11s queued=%s sent=%s confirmed=%s", entry.checkId, toString(entry.origin), toString(entry.outcome),
+                  stage(entry.queued).c_str(), stage(entry.sent).c_str(), stage(entry.confirmed).c_str());
+    return line;
+}
+
+std::vector<std::string> CheckTrace::formatReport(size_t recentCount) const
+{
+    const auto entries = snapshot();
+
+    std::vector<std::string> lines;
+    lines.push_back(formatSummary("detect->send", summarize(entries, &CheckTraceEntry::detected, &CheckTraceEntry::sent)));
+    lines.push_back(formatSummary("send->confirm", summarize(entries, &CheckTraceEntry::sent, &CheckTraceEntry::confirmed)));
+
+    const size_t first = entries.size() > recentCount ? entries.size() - recentCount : 0;
+    for (size_t i = first; i < entries.size(); ++i)
+        lines.push_back(formatTimeline(entries[i]));
+    return lines;
+}
+
+bool CheckTrace::dumpToFile(const std::filesystem::path &path) const
+{
+    const auto lines = formatReport(kCapacity);
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        wolf::logWarning("[CheckTrace] Failed to open %s for writing", path.string().c_str());
+        return false;
+    }
+
+    for (const auto &line : lines)
+        file << line << '\n';
+
+    wolf::logInfo("[CheckTrace] Wrote %zu check timeline(s) to %s", lines.size() - 2, path.string().c_str());
+    return true;
+}
+
+} // namespace checks
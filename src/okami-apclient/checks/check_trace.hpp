@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace checks
+{
+
+/**
+ * @brief Which detector produced a check
+ */
+enum class CheckOrigin : uint8_t
+{
+    Unknown,
+    BrushHook,     // wolf::onBrushEdit, drained on the next tick
+    ContainerPoll, // ContainerMan::poll
+    ShopPurchase,  // ShopMan purchase hooks / onShopPurchase
+    Bitfield,      // CheckSourceScanner diff
+};
+
+/**
+ * @brief What CheckMan did with a detected check
+ */
+enum class CheckOutcome : uint8_t
+{
+    Sent,
+    Duplicate,  // already sent this session or synced from the server
+    NotSending, // sending disabled or socket disconnected
+};
+
+const char *toString(CheckOrigin origin);
+const char *toString(CheckOutcome outcome);
+
+/**
+ * @brief One check's journey from detection to server confirmation
+ *
+ * A default-constructed time_point means the stage was never reached.
+ */
+struct CheckTraceEntry
+{
+    using Clock = std::chrono::steady_clock;
+
+    int64_t checkId = 0;
+    CheckOrigin origin = CheckOrigin::Unknown;
+    CheckOutcome outcome = CheckOutcome::Sent;
+    Clock::time_point detected{};  // detector saw the transition
+    Clock::time_point queued{};    // detector handed it to CheckMan (BrushMan drain, scan callback)
+    Clock::time_point sent{};      // handed to the socket
+    Clock::time_point confirmed{}; // server echoed it in location_checked
+};
+
+/**
+ * @brief Fixed-size provenance and latency ring for sent checks
+ *
+ * record() writes one POD slot under an uncontended mutex and never
+ * allocates, so tracing costs nanoseconds per check. Everything that
+ * formats or sorts (summaries, timelines, dumps) copies the ring first and
+ * runs off the hot path; it may be called from the console thread.
+ */
+class CheckTrace
+{
+  public:
+    using Clock = CheckTraceEntry::Clock;
+
+    static constexpr size_t kCapacity = 512;
+
+    /// Latency between two stages over every entry that reached both
+    struct LatencySummary
+    {
+        size_t samples = 0;
+        std::chrono::microseconds p50{};
+        std::chrono::microseconds p90{};
+        std::chrono::microseconds p99{};
+        std::chrono::microseconds max{};
+    };
+
+    /// Overwrites the oldest entry once the ring is full.
+    void record(const CheckTraceEntry &entry);
+
+    /**
+     * @brief Stamp the confirmation time on sent, unconfirmed entries
+     * @return Number of entries confirmed by this call
+     */
+    size_t markConfirmed(const std::list<int64_t> &serverCheckedLocations, Clock::time_point now = Clock::now());
+
+    /// Entries oldest to newest.
+    [[nodiscard]] std::vector<CheckTraceEntry> snapshot() const;
+
+    /// Most recent entry for a check ID.
+    [[nodiscard]] std::optional<CheckTraceEntry> find(int64_t checkId) const;
+
+    /// detected -> sent, over entries that were sent.
+    [[nodiscard]] LatencySummary detectToSend() const;
+
+    /// sent -> confirmed, over entries the server has confirmed.
+    [[nodiscard]] LatencySummary sendToConfirm() const;
+
+    [[nodiscard]] size_t size() const;
+    void clear();
+
+    /// One-line "id origin outcome +queued +sent +confirmed" for a single entry.
+    [[nodiscard]] static std::string formatTimeline(const CheckTraceEntry &entry);
+
+    /// Percentile summaries followed by the newest `recentCount` timelines.
+    [[nodiscard]] std::vector<std::string> formatReport(size_t recentCount) const;
+
+    /// Write the summaries and every timeline in the ring to a text file.
+    bool dumpToFile(const std::filesystem::path &path) const;
+
+  private:
+    mutable std::mutex mutex_;
+    std::array<CheckTraceEntry, kCapacity> ring_{};
+    size_t head_ = 0; // total entries ever recorded; slot = head_ % kCapacity
+};
+
+} // namespace checks
@@ -10,6 +10,14 @@
  * game-specific identifiers.
  *
  * ID Range Scheme:
+ * - 110000 + bitIndex:                  Stray beads collected
+ * - 111000 + bitIndex:                  Travel guides collected
+ * - 112000 + bitIndex:                  Dojo move tome entries
+ * - 113000 + bitIndex:                  Fish tome entries
+ * - 114000 + bitIndex:                  Animal tome entries
+ * - 115000 + bitIndex:                  Treasure tome entries
+ * - 120000 + mapId*200 + bitIndex:      Dig spots (MapState::unburiedObjects)
+ * - 140000 + mapId*200 + bitIndex:      Fights cleared (MapState::fightsCleared)
  * - 200000 + brushIndex:                Brush acquisitions
  * - 300000 + shopId*1000 + itemSlot:    Shop purchases
  * - 400000 + mapId*10000 + bitIndex:    World state changes
@@ -38,7 +46,19 @@ inline constexpr unsigned int monitorToGameBitIndex(unsigned int monitorBitIndex
 }
 
 // Check ID range bases
+inline constexpr int64_t kStrayBeadBase = 110000;
+inline constexpr int64_t kTravelGuideBase = 111000;
+inline constexpr int64_t kDojoMoveBase = 112000;
+inline constexpr int64_t kFishTomeBase = 113000;
+inline constexpr int64_t kAnimalTomeBase = 114000;
+inline constexpr int64_t kTreasureTomeBase = 115000;
+inline constexpr int64_t kDigSpotBase = 120000;
+inline constexpr int64_t kFightClearedBase = 140000;
+inline constexpr int64_t kFightClearedEnd = 170000;
 inline constexpr int64_t kBrushAcquisitionBase = 200000;
+
+// Per-map ID stride for the 120000/140000 ranges (covers BitField<128>)
+inline constexpr int64_t kPerMapCheckStride = 200;
 inline constexpr int64_t kShopPurchaseBase = 300000;
 inline constexpr int64_t kWorldStateBase = 400000;
 inline constexpr int64_t kCollectedObjectBase = 500000;
@@ -121,6 +141,28 @@ inline constexpr int64_t getGameProgressCheckId(int bitIndex)
     return kGameProgressBase + bitIndex;
 }
 
+/**
+ * @brief Calculate check ID for a dug-up object
+ * @param mapId The map (MapTypes index) containing the dig spot
+ * @param bitIndex The unburiedObjects bit that was set
+ * @return Archipelago check ID (120000 + mapId*200 + bitIndex)
+ */
+inline constexpr int64_t getDigSpotCheckId(int mapId, int bitIndex)
+{
+    return kDigSpotBase + (mapId * kPerMapCheckStride) + bitIndex;
+}
+
+/**
+ * @brief Calculate check ID for a cleared fight
+ * @param mapId The map (MapTypes index) where the fight was cleared
+ * @param bitIndex The fightsCleared bit that was set
+ * @return Archipelago check ID (140000 + mapId*200 + bitIndex)
+ */
+inline constexpr int64_t getFightClearedCheckId(int mapId, int bitIndex)
+{
+    return kFightClearedBase + (mapId * kPerMapCheckStride) + bitIndex;
+}
+
 /**
  * @brief Calculate check ID for container pickup
  * @param levelId The level ID where the container exists
@@ -145,6 +187,14 @@ enum class CheckCategory
     GlobalFlag,
     GameProgress,
     Container,
+    StrayBead,
+    TravelGuide,
+    DojoMove,
+    FishTome,
+    AnimalTome,
+    TreasureTome,
+    DigSpot,
+    FightCleared,
     Unknown
 };
 
@@ -169,6 +219,24 @@ inline constexpr CheckCategory getCheckCategory(int64_t checkId)
         return CheckCategory::ShopPurchase;
     if (checkId >= kBrushAcquisitionBase)
         return CheckCategory::BrushAcquisition;
+    if (checkId >= kFightClearedEnd)
+        return CheckCategory::Unknown;
+    if (checkId >= kFightClearedBase)
+        return CheckCategory::FightCleared;
+    if (checkId >= kDigSpotBase)
+        return CheckCategory::DigSpot;
+    if (checkId >= kTreasureTomeBase)
+        return CheckCategory::TreasureTome;
+    if (checkId >= kAnimalTomeBase)
+        return CheckCategory::AnimalTome;
+    if (checkId >= kFishTomeBase)
+        return CheckCategory::FishTome;
+    if (checkId >= kDojoMoveBase)
+        return CheckCategory::DojoMove;
+    if (checkId >= kTravelGuideBase)
+        return CheckCategory::TravelGuide;
+    if (checkId >= kStrayBeadBase)
+        return CheckCategory::StrayBead;
     return CheckCategory::Unknown;
 }
 
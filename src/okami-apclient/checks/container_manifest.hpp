@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "check_types.hpp"
+
+namespace checks
+{
+
+/**
+ * @brief One map's slice of the container manifest
+ *
+ * Spawn indices for the map are spawnIndices[first, first + count).
+ */
+struct ManifestMap
+{
+    uint16_t levelId;
+    uint16_t first;
+    uint16_t count;
+};
+
+/**
+ * @brief Build-time list of container spawn indices per map
+ *
+ * Generated from data/containers.yml by scripts/generate_container_manifest.py
+ * (see container_manifest_data.hpp). Lets the spawn table hook touch only the
+ * listed entries and lets every container location be scouted at connect,
+ * before any map has loaded.
+ *
+ * Maps must be sorted by levelId; maps not listed fall back to a full spawn
+ * table scan.
+ */
+class ContainerManifest
+{
+  public:
+    constexpr ContainerManifest() = default;
+    constexpr ContainerManifest(std::span<const ManifestMap> maps, std::span<const uint8_t> spawnIndices) : maps_(maps), spawnIndices_(spawnIndices)
+    {
+    }
+
+    [[nodiscard]] constexpr bool hasLevel(uint16_t levelId) const
+    {
+        return findMap(levelId) != nullptr;
+    }
+
+    /// The map's manifest slice, or nullptr if the map isn't listed.
+    [[nodiscard]] constexpr const ManifestMap *map(uint16_t levelId) const
+    {
+        return findMap(levelId);
+    }
+
+    /// Listed spawn indices for a map; empty if the map isn't in the manifest.
+    [[nodiscard]] constexpr std::span<const uint8_t> spawnIndices(uint16_t levelId) const
+    {
+        const ManifestMap *map = findMap(levelId);
+        if (!map)
+            return {};
+        return spawnIndices_.subspan(map->first, map->count);
+    }
+
+    [[nodiscard]] constexpr std::span<const ManifestMap> maps() const
+    {
+        return maps_;
+    }
+
+    [[nodiscard]] constexpr size_t containerCount() const
+    {
+        return spawnIndices_.size();
+    }
+
+    /// Invoke fn(checkId) for every container in the manifest.
+    template <typename Fn> constexpr void forEachCheckId(Fn &&fn) const
+    {
+        for (const auto &map : maps_)
+        {
+            for (uint8_t idx : spawnIndices_.subspan(map.first, map.count))
+                fn(getContainerCheckId(map.levelId, idx));
+        }
+    }
+
+    /// Sorted, non-overlapping slices covering spawnIndices, all indices < 128.
+    [[nodiscard]] constexpr bool isValid() const
+    {
+        size_t expectedFirst = 0;
+        for (size_t i = 0; i < maps_.size(); ++i)
+        {
+            if (i > 0 && maps_[i - 1].levelId >= maps_[i].levelId)
+                return false;
+            if (maps_[i].first != expectedFirst)
+                return false;
+            expectedFirst += maps_[i].count;
+        }
+        if (expectedFirst != spawnIndices_.size())
+            return false;
+        return std::ranges::all_of(spawnIndices_, [](uint8_t idx) { return idx < 128; });
+    }
+
+  private:
+    constexpr const ManifestMap *findMap(uint16_t levelId) const
+    {
+        auto it = std::ranges::lower_bound(maps_, levelId, {}, &ManifestMap::levelId);
+        if (it == maps_.end() || it->levelId != levelId)
+            return nullptr;
+        return &*it;
+    }
+
+    std::span<const ManifestMap> maps_;
+    std::span<const uint8_t> spawnIndices_;
+};
+
+} // namespace checks
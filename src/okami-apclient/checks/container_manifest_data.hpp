@@ -0,0 +1,25 @@
+#pragma once
+// Auto-generated by scripts/generate_container_manifest.py
+// Do not edit manually - regenerate by modifying src/okami-apclient/data/containers.yml
+
+#include <array>
+#include <cstdint>
+
+#include "container_manifest.hpp"
+
+namespace checks::container_manifest_data
+{
+
+inline constexpr std::array<uint8_t, 0> kSpawnIndices = {};
+
+inline constexpr std::array<ManifestMap, 0> kMaps = {};
+
+} // namespace checks::container_manifest_data
+
+namespace checks
+{
+
+inline constexpr ContainerManifest kContainerManifest{container_manifest_data::kMaps, container_manifest_data::kSpawnIndices};
+static_assert(kContainerManifest.isValid(), "container manifest must be sorted by level with in-range spawn indices");
+
+} // namespace checks
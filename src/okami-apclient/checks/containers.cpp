@@ -1,7 +1,10 @@
 #include "containers.hpp"
 
+#include <algorithm>
 #include <cinttypes>
 #include <list>
+#include <string>
+#include <vector>
 
 #include <okami/spawntable.h>
 
@@ -17,12 +20,14 @@ namespace checks
 {
 
 constexpr uint8_t DUMMY_ITEM_ID = 0x83; // Chestnut
+constexpr const char *kPollingCommand = "ap_container_polling";
 
 // Static member initialization
 ContainerMan::SpawnTablePopulatorFn ContainerMan::originalSpawnTablePopulator_ = nullptr;
 ContainerMan *ContainerMan::activeInstance_ = nullptr;
 
-ContainerMan::ContainerMan(ISocket &socket, CheckCallback checkCallback) : socket_(socket), checkCallback_(std::move(checkCallback))
+ContainerMan::ContainerMan(ISocket &socket, CheckCallback checkCallback, ContainerManifest manifest)
+    : socket_(socket), checkCallback_(std::move(checkCallback)), manifest_(manifest)
 {
 }
 
@@ -48,6 +53,16 @@ void ContainerMan::initialize()
         return;
     }
 
+    wolf::addCommand(
+        kPollingCommand,
+        [this](const std::vector<std::string> &args)
+        {
+            if (args.size() >= 2)
+                setDetectionMode(args[1] == "on" ? DetectionMode::Polling : DetectionMode::PickupEvent);
+            wolf::logInfo("[ContainerMan] Container polling fallback: %s", detectionMode_ == DetectionMode::Polling ? "on" : "off");
+        },
+        "Poll containers every tick instead of on item pickup. Usage: ap_container_polling [on|off]");
+
     initialized_ = true;
     wolf::logDebug("[ContainerMan] Container hook installed");
 }
@@ -59,16 +74,20 @@ void ContainerMan::shutdown()
         return;
     }
 
-    trackedContainerIndices_.clear();
+    wolf::removeCommand(kPollingCommand);
+    trackedContainers_.reset();
+    pickupsAwaitingResolve_ = 0;
     activeInstance_ = nullptr;
     initialized_ = false;
 }
 
 void ContainerMan::reset()
 {
-    trackedContainerIndices_.clear();
+    trackedContainers_.reset();
     scoutedItems_.clear();
-    pendingContainerItems_.clear();
+    prefetchedScouts_.clear();
+    pendingContainerItems_.fill(0);
+    pickupsAwaitingResolve_ = 0;
 }
 
 void ContainerMan::hookSpawnTablePopulator(void *spawnTable)
@@ -96,37 +115,31 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
     currentLevelId_ = *currentMapPtr;
 
     // Clear tracking from previous level
-    trackedContainerIndices_.clear();
+    trackedContainers_.reset();
     scoutedItems_.clear();
-    pendingContainerItems_.clear();
+    pendingContainerItems_.fill(0);
+    pickupsAwaitingResolve_ = 0;
 
-    // First pass: scan spawn table entries for containers, track indices (don't replace yet)
-    for (int i = 0; i < 128; i++)
+    // First pass: track randomized containers (don't replace yet). Manifest
+    // maps only touch their listed entries; others scan the whole table.
+    if (manifest_.hasLevel(currentLevelId_))
     {
-        okami::SpawnTableEntry *entry = &table->entries[i];
-
-        // Check if entry is enabled and has spawn_data
-        if (!(entry->flags & 1) || !entry->spawn_data)
-        {
-            continue;
-        }
-
-        // Only process container entries
-        if (entry->spawn_type_1 != 1)
+        for (uint8_t i : manifest_.spawnIndices(currentLevelId_))
         {
-            continue;
+            if (!considerSpawnEntry(*table, i))
+                wolf::logWarning("[ContainerMan] Manifest lists spawn index %d in level 0x%04X, but it is not a container", i, currentLevelId_);
         }
-
-        // Calculate check ID for this container
-        int64_t checkId = getContainerCheckId(currentLevelId_, i);
-
-        // Check if this container is part of randomization
-        if (!isContainerInRando(checkId))
+    }
+    else
+    {
+        std::string found;
+        for (int i = 0; i < SPAWN_TABLE_ENTRY_COUNT; i++)
         {
-            continue;
+            if (considerSpawnEntry(*table, i))
+                found += (found.empty() ? "" : ", ") + std::to_string(i);
         }
-
-        trackedContainerIndices_.insert(i);
+        if (!found.empty())
+            wolf::logDebug("[ContainerMan] Level 0x%04X not in container manifest; containers: [%s]", currentLevelId_, found.c_str());
     }
 
     // Scout all tracked container locations to get item classification data
@@ -142,10 +155,15 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
         return okami::ItemTypes::OkamiStandardItem;
     };
 
-    // Second pass: replace items using scouted data
+    // Second pass: replace items using scouted data. Names are registered as
+    // one batch once the pass is done.
+    std::vector<std::pair<int64_t, std::string>> scoutedNames;
     int replacedCount = 0;
-    for (int i : trackedContainerIndices_)
+    for (int i = 0; i < SPAWN_TABLE_ENTRY_COUNT; i++)
     {
+        if (!trackedContainers_.test(i))
+            continue;
+
         okami::SpawnTableEntry *entry = &table->entries[i];
         okami::ContainerData *containerData = entry->spawn_data;
 
@@ -156,7 +174,6 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
         {
             // No scouted data — fallback to chestnut
             containerData->item_id = DUMMY_ITEM_ID;
-            pendingContainerItems_[containerData->item_id]++;
             wolf::logDebug("[ContainerMan] Container %d: no scout data, using fallback dummy 0x%02X", i, DUMMY_ITEM_ID);
         }
         else
@@ -177,7 +194,7 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
             {
                 // Progressive weapons need dummy
                 gameItem = nativeDummy(scouted.flags);
-                itempatch::registerScoutedItemName(checkId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
+                scoutedNames.emplace_back(checkId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
                 wolf::logDebug("[ContainerMan] Container %d: native AP item %" PRId64 " -> progressive weapon, using dummy %d", i, scouted.item,
                                static_cast<int>(gameItem));
             }
@@ -185,7 +202,7 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
             {
                 // Native brushes, event flags, etc.
                 gameItem = nativeDummy(scouted.flags);
-                itempatch::registerScoutedItemName(checkId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
+                scoutedNames.emplace_back(checkId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
                 wolf::logDebug("[ContainerMan] Container %d: native AP item %" PRId64 " -> non-game item, using dummy %d (flags=0x%x)", i, scouted.item,
                                static_cast<int>(gameItem), scouted.flags);
             }
@@ -198,7 +215,7 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
                     gameItem = okami::ItemTypes::ForeignProgressionItem;
                 else
                     gameItem = okami::ItemTypes::ForeignStandardItem;
-                itempatch::registerScoutedItemName(checkId, socket_.getItemName(scouted.item, scouted.player));
+                scoutedNames.emplace_back(checkId, socket_.getItemName(scouted.item, scouted.player));
                 wolf::logDebug("[ContainerMan] Container %d: foreign AP item %" PRId64 " -> dummy type %d (flags=0x%x)", i, scouted.item,
                                static_cast<int>(gameItem), scouted.flags);
             }
@@ -209,6 +226,7 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
         pendingContainerItems_[containerData->item_id]++;
         replacedCount++;
     }
+    itempatch::registerScoutedItemNames(scoutedNames);
 
     if (replacedCount > 0)
     {
@@ -216,20 +234,72 @@ void ContainerMan::onSpawnTablePopulate(void *spawnTable)
     }
 }
 
+bool ContainerMan::considerSpawnEntry(const okami::SpawnTable &table, int i)
+{
+    const okami::SpawnTableEntry &entry = table.entries[i];
+
+    // Only enabled container entries with spawn_data
+    if (!(entry.flags & 1) || !entry.spawn_data || entry.spawn_type_1 != 1)
+    {
+        return false;
+    }
+
+    // Check if this container is part of randomization
+    if (isContainerInRando(getContainerCheckId(currentLevelId_, i)))
+    {
+        trackedContainers_.set(i);
+    }
+    return true;
+}
+
 void ContainerMan::poll()
 {
-    if (trackedContainerIndices_.empty() || !socket_.isConnected())
+    if (detectionMode_ == DetectionMode::PickupEvent && pickupsAwaitingResolve_ == 0)
+    {
+        return;
+    }
+
+    if (trackedContainers_.none() || !socket_.isConnected())
+    {
+        pickupsAwaitingResolve_ = 0;
+        return;
+    }
+
+    const int collected = collectPickedUpContainers();
+    if (detectionMode_ == DetectionMode::Polling)
     {
         return;
     }
 
+    pickupsAwaitingResolve_ = std::max(0, pickupsAwaitingResolve_ - collected);
+    if (pickupsAwaitingResolve_ > 0 && --resolveTicksLeft_ <= 0)
+    {
+        // Picked up something that wasn't a tracked container (e.g. a ground item)
+        wolf::logDebug("[ContainerMan] %d pickup(s) matched no tracked container", pickupsAwaitingResolve_);
+        pickupsAwaitingResolve_ = 0;
+    }
+}
+
+void ContainerMan::notifyItemPickup()
+{
+    if (trackedContainers_.none())
+    {
+        return;
+    }
+
+    pickupsAwaitingResolve_++;
+    resolveTicksLeft_ = kPickupResolveTicks;
+}
+
+int ContainerMan::collectPickedUpContainers()
+{
     uintptr_t mainBase = reinterpret_cast<uintptr_t>(wolf::getModuleBase("main.dll"));
     auto *table = reinterpret_cast<okami::SpawnTable *>(mainBase + SPAWN_TABLE_OFFSET);
 
-    std::vector<int> pickedUp;
-    for (int containerIdx : trackedContainerIndices_)
+    int collected = 0;
+    for (int containerIdx = 0; containerIdx < SPAWN_TABLE_ENTRY_COUNT; containerIdx++)
     {
-        if (containerIdx < 0 || containerIdx >= 128)
+        if (!trackedContainers_.test(containerIdx))
         {
             continue;
         }
@@ -244,23 +314,38 @@ void ContainerMan::poll()
             itempatch::setContainerContext(checkId);
             checkCallback_(checkId);
             itempatch::clearContainerContext();
-            pickedUp.push_back(containerIdx);
+            trackedContainers_.reset(containerIdx);
+            collected++;
         }
     }
+    return collected;
+}
 
-    for (int idx : pickedUp)
-    {
-        trackedContainerIndices_.erase(idx);
-    }
+void ContainerMan::setDetectionMode(DetectionMode mode)
+{
+    detectionMode_ = mode;
+    pickupsAwaitingResolve_ = 0;
+}
+
+ContainerMan::DetectionMode ContainerMan::getDetectionMode() const
+{
+    return detectionMode_;
 }
 
 void ContainerMan::scoutContainerLocations()
 {
     std::list<int64_t> locationsToScout;
 
-    for (int idx : trackedContainerIndices_)
+    for (int idx = 0; idx < SPAWN_TABLE_ENTRY_COUNT; idx++)
     {
-        locationsToScout.push_back(getContainerCheckId(currentLevelId_, idx));
+        if (!trackedContainers_.test(idx))
+            continue;
+
+        const int64_t checkId = getContainerCheckId(currentLevelId_, idx);
+        if (auto it = prefetchedScouts_.find(checkId); it != prefetchedScouts_.end())
+            scoutedItems_[checkId] = it->second;
+        else
+            locationsToScout.push_back(checkId);
     }
 
     if (locationsToScout.empty() || !socket_.isConnected())
@@ -283,6 +368,50 @@ void ContainerMan::scoutContainerLocations()
     }
 }
 
+void ContainerMan::prefetchScouts()
+{
+    prefetchedScouts_.clear();
+    prefetchRequest_.reset(); // a reply to an earlier prefetch is stale
+
+    if (manifest_.containerCount() == 0 || !socket_.isConnected() || !socket_.isSlotConfigReady() || !socket_.getSlotConfig().randomizeContainers)
+    {
+        return;
+    }
+
+    std::list<int64_t> locations;
+    manifest_.forEachCheckId(
+        [&](int64_t checkId)
+        {
+            if (socket_.isValidLocation(checkId))
+                locations.push_back(checkId);
+        });
+
+    if (locations.empty())
+    {
+        return;
+    }
+
+    // The reply arrives on a later game tick; maps loaded before it scout on their own
+    prefetchRequest_ = std::make_shared<int>();
+    socket_.scoutLocationsAsync(locations, 0,
+                                [this, request = std::weak_ptr<int>(prefetchRequest_), requested = locations.size()](std::vector<ScoutedItem> items)
+                                {
+                                    if (request.expired())
+                                        return; // superseded, or ContainerMan is gone
+
+                                    for (const auto &item : items)
+                                    {
+                                        prefetchedScouts_[item.location] = item;
+                                    }
+                                    wolf::logInfo("[ContainerMan] Prefetched %zu of %zu manifest container scouts", prefetchedScouts_.size(), requested);
+                                });
+}
+
+size_t ContainerMan::getPrefetchedScoutCount() const
+{
+    return prefetchedScouts_.size();
+}
+
 bool ContainerMan::isContainerInRando(int64_t locationId) const
 {
     // Check if connected and config indicates containers are randomized
@@ -302,16 +431,12 @@ bool ContainerMan::isContainerInRando(int64_t locationId) const
 
 bool ContainerMan::shouldBlockItemPickup(int itemId)
 {
-    auto it = pendingContainerItems_.find(static_cast<uint8_t>(itemId));
-    if (it != pendingContainerItems_.end() && it->second > 0)
-    {
-        it->second--;
-        if (it->second <= 0)
-            pendingContainerItems_.erase(it);
-        wolf::logDebug("[ContainerMan] Blocked item pickup for item 0x%02X from randomized container", itemId);
-        return true;
-    }
-    return false;
+    uint8_t &pending = pendingContainerItems_[static_cast<uint8_t>(itemId)];
+    if (pending == 0)
+        return false;
+
+    --pending;
+    return true;
 }
 
 } // namespace checks
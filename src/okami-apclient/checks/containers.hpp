@@ -1,12 +1,16 @@
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <functional>
-#include <map>
+#include <memory>
 #include <unordered_map>
-#include <unordered_set>
+
+#include <okami/spawntable.h>
 
 #include "../isocket.h"
+#include "container_manifest_data.hpp"
 
 namespace checks
 {
@@ -15,24 +19,41 @@ namespace checks
 constexpr uintptr_t SPAWN_TABLE_POPULATOR_OFFSET = 0x49e570;
 constexpr uintptr_t SPAWN_TABLE_OFFSET = 0xB66800;
 constexpr uintptr_t CURRENT_MAP_ID_OFFSET = 0xB6B240;
+constexpr int SPAWN_TABLE_ENTRY_COUNT = 128;
 
 /**
  * @brief Handler for container-based checks
  *
  * Manages the spawn table hook for replacing container items with dummies,
- * and polls for container collection to send checks.
+ * and sends a check when a tracked container is collected.
+ *
+ * Collection is detected from the item pickup path: notifyItemPickup() arms
+ * a short resolve window, and poll() only inspects the spawn table while
+ * that window is open (the collected entry's spawn_type_1 drops to 0 on the
+ * same or next frame). With nothing being collected, poll() is a single
+ * branch. Polling every tick remains available as a fallback mode.
  */
 class ContainerMan
 {
   public:
     using CheckCallback = std::function<void(int64_t)>;
 
+    enum class DetectionMode : uint8_t
+    {
+        PickupEvent, // inspect the spawn table only after an item pickup
+        Polling,     // inspect every tracked container every tick
+    };
+
+    // Ticks poll() keeps looking for a collected container after a pickup
+    static constexpr int kPickupResolveTicks = 60;
+
     /**
      * @brief Construct a ContainerMan
      * @param socket Reference to socket for connection status checks
      * @param checkCallback Callback to invoke when a container is collected
+     * @param manifest Known container spawn indices per map (generated)
      */
-    explicit ContainerMan(ISocket &socket, CheckCallback checkCallback);
+    explicit ContainerMan(ISocket &socket, CheckCallback checkCallback, ContainerManifest manifest = kContainerManifest);
 
     ~ContainerMan();
 
@@ -58,10 +79,31 @@ class ContainerMan
     void reset();
 
     /**
-     * @brief Poll for collected containers
+     * @brief Resolve pending pickups (or scan every tracked container in Polling mode)
      */
     void poll();
 
+    /**
+     * @brief Item pickup observed on the game's collect path
+     *
+     * Opens the resolve window if any container in the level is tracked.
+     */
+    void notifyItemPickup();
+
+    /**
+     * @brief Scout every manifest container location up front
+     *
+     * Called once slot config is available. Sends one scout and returns; the
+     * reply fills the prefetch cache on a later game tick. Maps whose
+     * containers were all prefetched need no scout round trip when they load.
+     */
+    void prefetchScouts();
+
+    [[nodiscard]] size_t getPrefetchedScoutCount() const;
+
+    void setDetectionMode(DetectionMode mode);
+    [[nodiscard]] DetectionMode getDetectionMode() const;
+
     /**
      * @brief Check if a container location is part of randomization
      * @param locationId The container location ID
@@ -71,6 +113,8 @@ class ContainerMan
 
     /**
      * @brief Check if an item pickup should be blocked (from a randomized container)
+     *
+     * Runs on the game thread for every pickup; does not allocate or log.
      * @param itemId The item ID being picked up
      * @return true if the pickup should be blocked
      */
@@ -80,16 +124,32 @@ class ContainerMan
     void onSpawnTablePopulate(void *spawnTable);
     void scoutContainerLocations();
 
+    // Tracks entry i if it is an enabled container in the rando; returns
+    // whether it is a container at all.
+    bool considerSpawnEntry(const okami::SpawnTable &table, int i);
+
+    // Sends checks for collected tracked containers; returns how many
+    int collectPickedUpContainers();
+
     // Hook function (needs to be static for function pointer)
     static void hookSpawnTablePopulator(void *spawnTable);
 
     ISocket &socket_;
     CheckCallback checkCallback_;
+    ContainerManifest manifest_;
 
-    std::unordered_set<int> trackedContainerIndices_;
+    std::bitset<SPAWN_TABLE_ENTRY_COUNT> trackedContainers_;
     std::unordered_map<int64_t, ScoutedItem> scoutedItems_;
+    std::unordered_map<int64_t, ScoutedItem> prefetchedScouts_;
+    std::shared_ptr<int> prefetchRequest_; // replaced per prefetch; its reply is dropped once this expires
     uint16_t currentLevelId_ = 0;
-    std::map<uint8_t, int> pendingContainerItems_;
+    // Per item ID: randomized containers in the level still holding that item.
+    // Fixed table so the pickup hook never touches the heap.
+    std::array<uint8_t, 256> pendingContainerItems_{};
+
+    DetectionMode detectionMode_ = DetectionMode::PickupEvent;
+    int pickupsAwaitingResolve_ = 0;
+    int resolveTicksLeft_ = 0;
 
     // Hook state
     using SpawnTablePopulatorFn = void (*)(void *);
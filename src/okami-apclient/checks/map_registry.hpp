@@ -0,0 +1,273 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <okami/maps.hpp>
+#include <okami/maptype.hpp>
+
+#include "container_manifest_data.hpp"
+
+/**
+ * @brief Compile-time per-map metadata registry
+ *
+ * Everything the mod keys on a map ID - MapTypes index, save-slot area name,
+ * item and demon fang shop IDs, container manifest slice - is folded into one
+ * constexpr table when the mod is compiled. The table is built from the source
+ * tables below and from okami/maptype.hpp, okami/maps.hpp and the generated
+ * container manifest, so those stay the single place to edit.
+ *
+ * mapInfo() packs the map ID into a dense key, reads the map's ordinal from a
+ * 1 KiB table and returns the entry: no hashing, no scan.
+ */
+namespace checks
+{
+
+// Item shops in the data-driven registry (shop IDs 0..NUM_ITEM_SHOPS-1)
+constexpr int NUM_ITEM_SHOPS = 21;
+
+// Demon fang shops follow the item shops (shop IDs NUM_ITEM_SHOPS..NUM_SHOPS-1)
+constexpr int NUM_FANG_SHOPS = 3;
+constexpr int FANG_SHOP_ID_BASE = NUM_ITEM_SHOPS;
+constexpr int NUM_SHOPS = NUM_ITEM_SHOPS + NUM_FANG_SHOPS;
+
+// ============================================================================
+// Source tables
+// ============================================================================
+
+struct ShopMapEntry
+{
+    uint16_t mapId;
+    int shopId;
+    uint32_t shopNum; // kAnyShopNum = wildcard (any shopNum), otherwise exact match
+};
+
+inline constexpr uint32_t kAnyShopNum = UINT32_MAX;
+
+inline constexpr auto kShopMap = std::to_array<ShopMapEntry>({
+    {okami::MapID::AgataForestCursed, 0, kAnyShopNum},
+    {okami::MapID::AgataForestHealed, 0, kAnyShopNum},
+    {okami::MapID::ArkofYamato, 1, kAnyShopNum},
+    {okami::MapID::CityCheckpoint, 2, kAnyShopNum},
+    {okami::MapID::DragonPalace, 3, kAnyShopNum},
+    {okami::MapID::KamikiVillagePostTei, 4, kAnyShopNum},
+    {okami::MapID::KamikiVillageCursed, 5, kAnyShopNum},
+    {okami::MapID::KamikiVillage, 5, kAnyShopNum},
+    {okami::MapID::KamikiVillagePast, 6, kAnyShopNum},
+    {okami::MapID::KamuiCursed, 7, kAnyShopNum},
+    {okami::MapID::KamuiHealed, 7, kAnyShopNum},
+    {okami::MapID::KusaVillage, 8, kAnyShopNum},
+    {okami::MapID::MoonCaveInterior, 9, kAnyShopNum},
+    {okami::MapID::MoonCaveStaircaseAndOrochiArena, 10, kAnyShopNum},
+    {okami::MapID::NRyoshimaCoast, 11, kAnyShopNum},
+    {okami::MapID::OniIslandLowerInterior, 12, kAnyShopNum},
+    {okami::MapID::Ponctan, 13, kAnyShopNum},
+    {okami::MapID::RyoshimaCoastCursed, 14, kAnyShopNum},
+    {okami::MapID::RyoshimaCoastHealed, 14, kAnyShopNum},
+    {okami::MapID::SasaSanctuary, 15, kAnyShopNum},
+    {okami::MapID::SeianCityCommonersQuarter, 16, 0}, // weapon shop
+    {okami::MapID::SeianCityCommonersQuarter, 17, 1}, // fish shop
+    {okami::MapID::ShinshuFieldCursed, 18, kAnyShopNum},
+    {okami::MapID::ShinshuFieldHealed, 18, kAnyShopNum},
+    {okami::MapID::TakaPassCursed, 19, kAnyShopNum},
+    {okami::MapID::TakaPassHealed, 19, kAnyShopNum},
+    {okami::MapID::WawkuShrine, 20, kAnyShopNum},
+});
+
+struct FangShopMapEntry
+{
+    uint16_t mapId;
+    int shopId;
+};
+
+inline constexpr auto kFangShopMap = std::to_array<FangShopMapEntry>({
+    {okami::MapID::AgataForestCursed, FANG_SHOP_ID_BASE + 0},
+    {okami::MapID::AgataForestHealed, FANG_SHOP_ID_BASE + 0},
+    {okami::MapID::ArkofYamato, FANG_SHOP_ID_BASE + 1},
+    {okami::MapID::ImperialPalaceAmmySize, FANG_SHOP_ID_BASE + 2},
+});
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+/**
+ * @brief Everything known about one map ID
+ *
+ * Maps missing from every source table resolve to a shared entry with
+ * known() == false and the same defaults the individual lookups use.
+ */
+struct MapInfo
+{
+    static constexpr uint16_t kUnknownMapId = 0xFFFF;
+    static constexpr size_t kMaxShopsPerMap = 2;
+
+    uint16_t mapId = kUnknownMapId;
+    uint8_t mapType = okami::MapTypes::None;
+    uint8_t areaNameStrId = okami::kDefaultAreaNameID;
+    std::array<int8_t, kMaxShopsPerMap> shopIds{-1, -1}; // indexed by shopNum
+    int8_t anyShopId = -1;                               // shopNum >= kMaxShopsPerMap
+    int8_t fangShopId = -1;
+    const ManifestMap *containers = nullptr; // slice of kContainerManifest
+
+    [[nodiscard]] constexpr bool known() const
+    {
+        return mapId != kUnknownMapId;
+    }
+
+    [[nodiscard]] constexpr std::optional<int> shopId(uint32_t shopNum) const
+    {
+        const int8_t id = shopNum < kMaxShopsPerMap ? shopIds[shopNum] : anyShopId;
+        if (id < 0)
+            return std::nullopt;
+        return id;
+    }
+
+    [[nodiscard]] constexpr std::optional<int> fangShop() const
+    {
+        if (fangShopId < 0)
+            return std::nullopt;
+        return fangShopId;
+    }
+};
+
+namespace detail
+{
+
+// Every known map ID is 0xHLL with LL < 0x40, so (H << 6) | LL is a dense
+// 1024-slot key. Anything else lands on the trailing slot, ordinal 0.
+inline constexpr size_t kMapKeyCount = 0x10 << 6;
+
+constexpr size_t mapKey(uint16_t mapId)
+{
+    if (mapId >= 0x1000 || (mapId & 0xFF) >= 0x40)
+        return kMapKeyCount;
+    return (static_cast<size_t>(mapId >> 8) << 6) | (mapId & 0x3F);
+}
+
+constexpr uint16_t mapIdForKey(size_t key)
+{
+    return static_cast<uint16_t>(((key >> 6) << 8) | (key & 0x3F));
+}
+
+template <typename Fn> constexpr void forEachSourceMapId(Fn &&fn)
+{
+    for (const auto &[mapId, type] : okami::MapTypes::mapidToIndex)
+        fn(mapId);
+    for (const auto &[mapId, areaNameId] : okami::MapToAreaNameID)
+        fn(mapId);
+    for (const auto &entry : kShopMap)
+        fn(entry.mapId);
+    for (const auto &entry : kFangShopMap)
+        fn(entry.mapId);
+    for (const auto &map : kContainerManifest.maps())
+        fn(map.levelId);
+}
+
+constexpr bool sourcesFitRegistry()
+{
+    bool ok = true;
+    forEachSourceMapId([&](unsigned mapId) { ok = ok && mapId <= UINT16_MAX && mapKey(static_cast<uint16_t>(mapId)) < kMapKeyCount; });
+    for (const auto &[mapId, type] : okami::MapTypes::mapidToIndex)
+        ok = ok && type <= UINT8_MAX;
+    for (const auto &[mapId, areaNameId] : okami::MapToAreaNameID)
+        ok = ok && areaNameId <= UINT8_MAX;
+    for (const auto &entry : kShopMap)
+        ok = ok && entry.shopId >= 0 && entry.shopId < NUM_ITEM_SHOPS && (entry.shopNum == kAnyShopNum || entry.shopNum < MapInfo::kMaxShopsPerMap);
+    for (const auto &entry : kFangShopMap)
+        ok = ok && entry.shopId >= FANG_SHOP_ID_BASE && entry.shopId < NUM_SHOPS;
+    return ok;
+}
+
+static_assert(sourcesFitRegistry(), "map registry source tables must fit the packed key and entry fields");
+
+constexpr std::array<bool, kMapKeyCount> presentKeys()
+{
+    std::array<bool, kMapKeyCount> present{};
+    forEachSourceMapId([&](unsigned mapId) { present[mapKey(static_cast<uint16_t>(mapId))] = true; });
+    return present;
+}
+
+constexpr size_t countMaps()
+{
+    size_t count = 0;
+    for (bool present : presentKeys())
+        count += present ? 1 : 0;
+    return count;
+}
+
+// Ordinal 0 is the unknown-map entry
+inline constexpr size_t kMapCount = countMaps() + 1;
+static_assert(kMapCount <= UINT8_MAX + 1, "map ordinals must fit in uint8_t");
+
+struct Registry
+{
+    std::array<uint8_t, kMapKeyCount + 1> ordinals{};
+    std::array<MapInfo, kMapCount> maps{};
+};
+
+constexpr Registry buildRegistry()
+{
+    Registry registry;
+
+    const auto present = presentKeys();
+    size_t next = 1;
+    for (size_t key = 0; key < kMapKeyCount; ++key)
+    {
+        if (!present[key])
+            continue;
+        registry.ordinals[key] = static_cast<uint8_t>(next);
+        registry.maps[next].mapId = mapIdForKey(key);
+        ++next;
+    }
+
+    auto entry = [&](unsigned mapId) -> MapInfo & { return registry.maps[registry.ordinals[mapKey(static_cast<uint16_t>(mapId))]]; };
+
+    for (const auto &[mapId, type] : okami::MapTypes::mapidToIndex)
+        entry(mapId).mapType = static_cast<uint8_t>(type);
+    for (const auto &[mapId, areaNameId] : okami::MapToAreaNameID)
+        entry(mapId).areaNameStrId = static_cast<uint8_t>(areaNameId);
+
+    // Wildcard entries claim every shopNum; exact entries only their own
+    for (const auto &shop : kShopMap)
+    {
+        MapInfo &info = entry(shop.mapId);
+        const auto shopId = static_cast<int8_t>(shop.shopId);
+        if (shop.shopNum == kAnyShopNum)
+        {
+            info.shopIds.fill(shopId);
+            info.anyShopId = shopId;
+        }
+        else
+        {
+            info.shopIds[shop.shopNum] = shopId;
+        }
+    }
+
+    for (const auto &shop : kFangShopMap)
+        entry(shop.mapId).fangShopId = static_cast<int8_t>(shop.shopId);
+    for (const auto &map : kContainerManifest.maps())
+        entry(map.levelId).containers = &map;
+
+    return registry;
+}
+
+inline constexpr Registry kRegistry = buildRegistry();
+
+} // namespace detail
+
+/// Metadata for a map ID. Two array reads; never fails.
+[[nodiscard]] constexpr const MapInfo &mapInfo(uint16_t mapId)
+{
+    return detail::kRegistry.maps[detail::kRegistry.ordinals[detail::mapKey(mapId)]];
+}
+
+/// Number of map IDs in the registry (excluding the unknown-map entry).
+[[nodiscard]] constexpr size_t knownMapCount()
+{
+    return detail::kMapCount - 1;
+}
+
+} // namespace checks
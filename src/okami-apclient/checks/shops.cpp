@@ -1,8 +1,12 @@
 #include "shops.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cinttypes>
 #include <cstring>
 #include <list>
+#include <string>
 
 #include <okami/itemtype.hpp>
 #include <okami/maptype.hpp>
@@ -60,19 +64,22 @@ ShopMan *ShopMan::activeInstance_ = nullptr;
 
 ShopDefinition::ShopDefinition() = default;
 
-void ShopDefinition::RebuildISL()
+template <typename Sink> void ShopDefinition::SerializeISL(Sink &out) const
 {
-    dataISL.clear();
-    dataISL.reserve(sizeof(okami::ISLHeader) + sizeof(uint32_t) + sizeof(okami::ItemShopStock) * itemStock.size() + sizeof(okami::SellValueArray));
-
-    okami::ISLHeader header = {"ISL", 1, 0, 0};
-    dataISL.append(header);
+    out.write(okami::ISLHeader{"ISL", 1, 0, 0});
+    out.write(static_cast<uint32_t>(itemStock.size()));
+    out.writeRange(itemStock);
+    out.write(sellValues);
+}
 
-    uint32_t numItems = static_cast<uint32_t>(itemStock.size());
-    dataISL.append(numItems);
+void ShopDefinition::RebuildISL()
+{
+    dataISL.build([this](auto &out) { SerializeISL(out); });
+}
 
-    dataISL.append_range(itemStock);
-    dataISL.append(sellValues);
+size_t ShopDefinition::WriteISL(std::span<uint8_t> out) const
+{
+    return okami::serializeInto(out, [this](auto &sink) { SerializeISL(sink); });
 }
 
 void ShopDefinition::CheckDirty()
@@ -139,62 +146,14 @@ void ShopDefinition::SetSellValues(const okami::SellValueArray &replacementSellV
 // Data-driven shop registry (21 item shops + 3 demon fang shops)
 // ============================================================================
 
-constexpr int NUM_ITEM_SHOPS = 21;
-
 static std::array<ShopDefinition, NUM_ITEM_SHOPS> itemShops;
 static std::vector<okami::ItemShopStock> AgataFangShop;
 static std::vector<okami::ItemShopStock> ArkOfYamatoFangShop;
 static std::vector<okami::ItemShopStock> ImperialPalaceFangShop;
 
-struct ShopMapEntry
-{
-    okami::MapID::Enum mapId;
-    int shopId;
-    uint32_t shopNum; // UINT32_MAX = wildcard (any shopNum), otherwise exact match
-};
-
-constexpr uint32_t kAnyShopNum = UINT32_MAX;
-
-static constexpr auto kShopMap = std::to_array<ShopMapEntry>({
-    {okami::MapID::AgataForestCursed, 0, kAnyShopNum},
-    {okami::MapID::AgataForestHealed, 0, kAnyShopNum},
-    {okami::MapID::ArkofYamato, 1, kAnyShopNum},
-    {okami::MapID::CityCheckpoint, 2, kAnyShopNum},
-    {okami::MapID::DragonPalace, 3, kAnyShopNum},
-    {okami::MapID::KamikiVillagePostTei, 4, kAnyShopNum},
-    {okami::MapID::KamikiVillageCursed, 5, kAnyShopNum},
-    {okami::MapID::KamikiVillage, 5, kAnyShopNum},
-    {okami::MapID::KamikiVillagePast, 6, kAnyShopNum},
-    {okami::MapID::KamuiCursed, 7, kAnyShopNum},
-    {okami::MapID::KamuiHealed, 7, kAnyShopNum},
-    {okami::MapID::KusaVillage, 8, kAnyShopNum},
-    {okami::MapID::MoonCaveInterior, 9, kAnyShopNum},
-    {okami::MapID::MoonCaveStaircaseAndOrochiArena, 10, kAnyShopNum},
-    {okami::MapID::NRyoshimaCoast, 11, kAnyShopNum},
-    {okami::MapID::OniIslandLowerInterior, 12, kAnyShopNum},
-    {okami::MapID::Ponctan, 13, kAnyShopNum},
-    {okami::MapID::RyoshimaCoastCursed, 14, kAnyShopNum},
-    {okami::MapID::RyoshimaCoastHealed, 14, kAnyShopNum},
-    {okami::MapID::SasaSanctuary, 15, kAnyShopNum},
-    {okami::MapID::SeianCityCommonersQuarter, 16, 0}, // weapon shop
-    {okami::MapID::SeianCityCommonersQuarter, 17, 1}, // fish shop
-    {okami::MapID::ShinshuFieldCursed, 18, kAnyShopNum},
-    {okami::MapID::ShinshuFieldHealed, 18, kAnyShopNum},
-    {okami::MapID::TakaPassCursed, 19, kAnyShopNum},
-    {okami::MapID::TakaPassHealed, 19, kAnyShopNum},
-    {okami::MapID::WawkuShrine, 20, kAnyShopNum},
-});
-
 std::optional<int> GetShopIdForMap(uint16_t mapId, uint32_t shopNum)
 {
-    auto id = static_cast<okami::MapID::Enum>(mapId);
-
-    for (const auto &[map, shop, num] : kShopMap)
-    {
-        if (map == id && (num == kAnyShopNum || num == shopNum))
-            return shop;
-    }
-    return std::nullopt;
+    return mapInfo(mapId).shopId(shopNum);
 }
 
 static ShopDefinition *GetShopById(int shopId)
@@ -236,6 +195,99 @@ okami::ItemShopStock *GetCurrentDemonFangShopData(uint16_t mapId, uint32_t *pNum
     return nullptr;
 }
 
+std::optional<int> GetFangShopIdForMap(uint16_t mapId)
+{
+    return mapInfo(mapId).fangShop();
+}
+
+// ============================================================================
+// Scouted item resolution (shared by lazy and prepared shops)
+// ============================================================================
+
+namespace
+{
+
+// TODO: Get actual price from AP data or slot_data
+constexpr int32_t kPlaceholderCost = 100;
+
+/// What a shop slot displays for a scouted item. `name` is the AP name to
+/// register for the slot, or empty when the game's own name is correct.
+struct ShopSlotItem
+{
+    okami::ItemTypes::Enum gameItem;
+    std::string name;
+};
+
+// Weapons (divine instruments) can't be displayed in item shops
+bool isWeapon(int itemId)
+{
+    return itemId >= okami::ItemTypes::DivineRetribution && itemId <= okami::ItemTypes::ThunderEdge;
+}
+
+// Native Okami dummy item based on AP classification flags
+okami::ItemTypes::Enum nativeDummy(unsigned flags)
+{
+    if (rewards::isTrap(flags))
+        return okami::ItemTypes::OkamiTrapItem;
+    if (rewards::isProgression(flags))
+        return okami::ItemTypes::OkamiProgressionItem;
+    return okami::ItemTypes::OkamiStandardItem;
+}
+
+ShopSlotItem resolveShopSlotItem(ISocket &socket, const ScoutedItem &scouted, int playerSlot)
+{
+    const bool isNative = !rewards::isForeignItem(scouted.player, playerSlot);
+
+    if (isNative && rewards::game_items::isDirectGameItem(scouted.item))
+    {
+        int rawItem = rewards::game_items::getItemId(scouted.item);
+        if (isWeapon(rawItem))
+        {
+            // Weapons can't be displayed in item shops - use dummy
+            wolf::logDebug("[ShopMan] Loc %" PRId64 ": native AP item %" PRId64 " -> weapon %d, using dummy", scouted.location, scouted.item, rawItem);
+            return {nativeDummy(scouted.flags), socket.getItemName(scouted.item, playerSlot)};
+        }
+
+        // Displayable native item — use raw type for vanilla icon and name
+        wolf::logDebug("[ShopMan] Loc %" PRId64 ": native AP item %" PRId64 " -> game item %d", scouted.location, scouted.item, rawItem);
+        return {static_cast<okami::ItemTypes::Enum>(rawItem), {}};
+    }
+
+    if (isNative)
+    {
+        // Progressive weapons, brushes, event flags, etc.
+        wolf::logDebug("[ShopMan] Loc %" PRId64 ": native AP item %" PRId64 " -> non-game item, using dummy (flags=0x%x)", scouted.location, scouted.item,
+                       scouted.flags);
+        return {nativeDummy(scouted.flags), socket.getItemName(scouted.item, playerSlot)};
+    }
+
+    // Foreign item — select AP dummy type based on classification flags
+    okami::ItemTypes::Enum gameItem = okami::ItemTypes::ForeignStandardItem;
+    if (rewards::isTrap(scouted.flags))
+        gameItem = okami::ItemTypes::ForeignTrapItem;
+    else if (rewards::isProgression(scouted.flags))
+        gameItem = okami::ItemTypes::ForeignProgressionItem;
+    wolf::logDebug("[ShopMan] Loc %" PRId64 ": foreign AP item %" PRId64 " -> dummy type %d (flags=0x%x)", scouted.location, scouted.item,
+                   static_cast<int>(gameItem), scouted.flags);
+    return {gameItem, socket.getItemName(scouted.item, scouted.player)};
+}
+
+} // namespace
+
+// ============================================================================
+// Prepared shops
+// ============================================================================
+
+/// Every shop's finished data from one batch scout. Immutable once published.
+struct ShopMan::PreparedShops
+{
+    std::array<ShopDefinition, NUM_ITEM_SHOPS> itemShops;
+    std::array<const uint8_t *, NUM_ITEM_SHOPS> isl{}; // nullptr: nothing scouted, use vanilla
+    std::array<std::vector<okami::ItemShopStock>, NUM_FANG_SHOPS> fangStock;
+    std::array<std::vector<std::pair<int64_t, std::string>>, NUM_SHOPS> names; // location -> AP name
+    int shopCount = 0;
+};
+
 // ============================================================================
 // ShopMan Implementation
 // ============================================================================
@@ -359,7 +411,22 @@ void ShopMan::reset()
     scoutedMapId_ = 0;
     scoutedItems_.clear();
     currentShopId_ = -1;
-    purchasedChecks_.clear();
+    for (auto &slots : purchasedSlots_)
+        slots.reset();
+}
+
+bool ShopMan::isSlotPurchased(int slot) const
+{
+    if (currentShopId_ < 0 || currentShopId_ >= NUM_SHOPS || slot < 0 || slot >= static_cast<int>(MaxShopStockSize))
+        return false;
+    return purchasedSlots_[static_cast<size_t>(currentShopId_)].test(static_cast<size_t>(slot));
+}
+
+void ShopMan::markSlotPurchased(int slot)
+{
+    if (currentShopId_ < 0 || currentShopId_ >= NUM_SHOPS || slot < 0 || slot >= static_cast<int>(MaxShopStockSize))
+        return;
+    purchasedSlots_[static_cast<size_t>(currentShopId_)].set(static_cast<size_t>(slot));
 }
 
 void ShopMan::scoutShopsForMap(uint16_t mapId)
@@ -438,6 +505,8 @@ void ShopMan::populateShopFromScoutedData(int shopId)
     int slotCount = socket_.getSlotConfig().shopSlots;
     wolf::logDebug("[ShopMan] Populating %d slots", slotCount);
 
+    const int mySlot = socket_.getPlayerSlot();
+    std::vector<std::pair<int64_t, std::string>> names;
     for (int slot = 0; slot < slotCount; ++slot)
     {
         int64_t locationId = checks::getShopCheckId(shopId, slot);
@@ -448,79 +517,113 @@ void ShopMan::populateShopFromScoutedData(int shopId)
             break;
         }
 
-        const ScoutedItem &scouted = it->second;
+        ShopSlotItem item = resolveShopSlotItem(socket_, it->second, mySlot);
+        if (!item.name.empty())
+            names.emplace_back(locationId, std::move(item.name));
+        shop->AddItem(item.gameItem, kPlaceholderCost);
+    }
+    itempatch::registerScoutedItemNames(names);
 
-        // Convert AP item ID to game item
-        okami::ItemTypes::Enum gameItem;
+    wolf::logDebug("[ShopMan] Shop population complete");
+}
 
-        // Helper to check if a game item is a weapon (divine instruments can't be displayed in shops)
-        auto isWeapon = [](int itemId) { return itemId >= okami::ItemTypes::DivineRetribution && itemId <= okami::ItemTypes::ThunderEdge; };
+std::unique_ptr<ShopMan::PreparedShops> ShopMan::buildPreparedShops(ISocket &socket, const std::vector<ScoutedItem> &scouted, int shopSlots, int playerSlot)
+{
+    std::unordered_map<int64_t, const ScoutedItem *> byLocation;
+    byLocation.reserve(scouted.size());
+    for (const auto &item : scouted)
+        byLocation.emplace(item.location, &item);
 
-        const int mySlot = socket_.getPlayerSlot();
-        const bool isNative = !rewards::isForeignItem(scouted.player, mySlot);
+    auto prepared = std::make_unique<PreparedShops>();
+    for (int shopId = 0; shopId < NUM_SHOPS; ++shopId)
+    {
+        const auto shopIdx = static_cast<size_t>(shopId);
+        std::vector<okami::ItemShopStock> stock;
 
-        // Helper to select a native Okami dummy item based on AP classification flags
-        auto nativeDummy = [](unsigned flags)
+        // Slots fill in order; the first unscouted slot ends the shop, as in the lazy path
+        for (int slot = 0; slot < shopSlots; ++slot)
         {
-            if (rewards::isTrap(flags))
-                return okami::ItemTypes::OkamiTrapItem;
-            if (rewards::isProgression(flags))
-                return okami::ItemTypes::OkamiProgressionItem;
-            return okami::ItemTypes::OkamiStandardItem;
-        };
-
-        if (isNative && rewards::game_items::isDirectGameItem(scouted.item))
-        {
-            int rawItem = rewards::game_items::getItemId(scouted.item);
-            if (isWeapon(rawItem))
-            {
-                // Weapons can't be displayed in item shops - use dummy
-                gameItem = nativeDummy(scouted.flags);
-                itempatch::registerScoutedItemName(locationId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
-                wolf::logDebug("[ShopMan] Slot %d: native AP item %lld -> weapon %d, using dummy %d", slot, scouted.item, rawItem, static_cast<int>(gameItem));
-            }
-            else
-            {
-                // Displayable native item — use raw type for vanilla icon and name
-                gameItem = static_cast<okami::ItemTypes::Enum>(rawItem);
-                wolf::logDebug("[ShopMan] Slot %d: native AP item %lld -> game item %d", slot, scouted.item, rawItem);
-            }
+            const int64_t locationId = checks::getShopCheckId(shopId, slot);
+            auto it = byLocation.find(locationId);
+            if (it == byLocation.end())
+                break;
+
+            ShopSlotItem item = resolveShopSlotItem(socket, *it->second, playerSlot);
+            if (!item.name.empty())
+                prepared->names[shopIdx].emplace_back(locationId, std::move(item.name));
+            stock.push_back(okami::ItemShopStock{item.gameItem, kPlaceholderCost, 0});
         }
-        else if (isNative && rewards::game_items::isProgressiveWeapon(scouted.item))
-        {
-            // Progressive weapons always need dummy in shops
-            gameItem = nativeDummy(scouted.flags);
-            itempatch::registerScoutedItemName(locationId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
-            wolf::logDebug("[ShopMan] Slot %d: native AP item %lld -> progressive weapon, using dummy %d", slot, scouted.item, static_cast<int>(gameItem));
-        }
-        else if (isNative)
+
+        if (stock.empty())
+            continue;
+
+        ++prepared->shopCount;
+        if (shopId < NUM_ITEM_SHOPS)
         {
-            // Native brushes, event flags, etc.
-            gameItem = nativeDummy(scouted.flags);
-            itempatch::registerScoutedItemName(locationId, socket_.getItemName(scouted.item, socket_.getPlayerSlot()));
-            wolf::logDebug("[ShopMan] Slot %d: native AP item %lld -> non-game item, using dummy %d (flags=0x%x)", slot, scouted.item,
-                           static_cast<int>(gameItem), scouted.flags);
+            prepared->itemShops[shopIdx].SetStock(stock);
+            prepared->isl[shopIdx] = prepared->itemShops[shopIdx].GetData();
         }
         else
         {
-            // Foreign item — select AP dummy type based on classification flags
-            if (rewards::isTrap(scouted.flags))
-                gameItem = okami::ItemTypes::ForeignTrapItem;
-            else if (rewards::isProgression(scouted.flags))
-                gameItem = okami::ItemTypes::ForeignProgressionItem;
-            else
-                gameItem = okami::ItemTypes::ForeignStandardItem;
-            itempatch::registerScoutedItemName(locationId, socket_.getItemName(scouted.item, scouted.player));
-            wolf::logDebug("[ShopMan] Slot %d: foreign AP item %lld -> dummy type %d (flags=0x%x)", slot, scouted.item, static_cast<int>(gameItem),
-                           scouted.flags);
+            prepared->fangStock[static_cast<size_t>(shopId - FANG_SHOP_ID_BASE)] = std::move(stock);
         }
-
-        // TODO: Get actual price from AP data or slot_data
-        constexpr int32_t placeholderCost = 100;
-        shop->AddItem(gameItem, placeholderCost);
     }
+    return prepared;
+}
 
-    wolf::logDebug("[ShopMan] Shop population complete");
+void ShopMan::registerPreparedNames(const PreparedShops &prepared, int shopId)
+{
+    itempatch::registerScoutedItemNames(prepared.names[static_cast<size_t>(shopId)]);
+}
+
+void ShopMan::prepareShops()
+{
+    if (!socket_.isConnected() || !socket_.getSlotConfig().randomizeShops)
+        return;
+
+    const int shopSlots = std::clamp(socket_.getSlotConfig().shopSlots, 0, static_cast<int>(MaxShopStockSize));
+    const int playerSlot = socket_.getPlayerSlot();
+
+    std::list<int64_t> locations;
+    for (int shopId = 0; shopId < NUM_SHOPS; ++shopId)
+    {
+        for (int slot = 0; slot < shopSlots; ++slot)
+            locations.push_back(checks::getShopCheckId(shopId, slot));
+    }
+
+    // Replacing the request drops the reply to any earlier one
+    prepareRequest_ = std::make_shared<int>();
+    socket_.scoutLocationsAsync(locations, 0,
+                                [this, request = std::weak_ptr<int>(prepareRequest_), shopSlots, playerSlot,
+                                 start = std::chrono::steady_clock::now()](std::vector<ScoutedItem> scouted)
+                                {
+                                    if (request.expired())
+                                        return; // discarded, superseded, or ShopMan is gone
+                                    if (scouted.empty())
+                                    {
+                                        wolf::logWarning("[ShopMan] Shop preparation scouted nothing; shops will scout when opened");
+                                        return;
+                                    }
+
+                                    auto prepared = buildPreparedShops(socket_, scouted, shopSlots, playerSlot);
+                                    const int shopCount = prepared->shopCount;
+                                    preparedShops_.store(prepared.get(), std::memory_order_release);
+                                    preparedHistory_.push_back(std::move(prepared));
+
+                                    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                                    wolf::logInfo("[ShopMan] Prepared %d shop(s) %lldms after connect", shopCount, static_cast<long long>(elapsed.count()));
+                                });
+}
+
+void ShopMan::discardPreparedShops()
+{
+    prepareRequest_.reset();
+    preparedShops_.store(nullptr, std::memory_order_release);
+}
+
+bool ShopMan::hasPreparedShops() const
+{
+    return preparedShops_.load(std::memory_order_acquire) != nullptr;
 }
 
 // ============================================================================
@@ -565,30 +668,44 @@ const void *__fastcall ShopMan::hookLoadRsc(void *pRscPackage, const char *pszTy
                 activeInstance_->currentShopId_ = *shopId;
                 itempatch::setCurrentShopId(*shopId);
 
-                // Lazy scouting: scout on first shop access for this map
-                activeInstance_->scoutShopsForMap(mapId);
-
-                // Only populate from scouted data if we got results
-                if (!activeInstance_->scoutedItems_.empty())
+                // Prepared at connect: hand over the finished buffer. A shop
+                // with nothing scouted stays vanilla.
+                const PreparedShops *prepared = activeInstance_->preparedShops_.load(std::memory_order_acquire);
+                if (prepared)
                 {
-                    wolf::logDebug("[ShopMan] Have %zu scouted items, populating shop", activeInstance_->scoutedItems_.size());
-                    activeInstance_->populateShopFromScoutedData(*shopId);
+                    if (const uint8_t *isl = prepared->isl[static_cast<size_t>(*shopId)])
+                    {
+                        registerPreparedNames(*prepared, *shopId);
+                        return isl;
+                    }
+                }
+                else
+                {
+                    // Lazy scouting: scout on first shop access for this map
+                    activeInstance_->scoutShopsForMap(mapId);
 
-                    const void *pResult = GetCurrentItemShopData(mapId, nIdx);
-                    if (pResult != nullptr)
+                    // Only populate from scouted data if we got results
+                    if (!activeInstance_->scoutedItems_.empty())
                     {
-                        wolf::logDebug("[ShopMan] Returning custom ISL data at %p", pResult);
-                        return pResult;
+                        wolf::logDebug("[ShopMan] Have %zu scouted items, populating shop", activeInstance_->scoutedItems_.size());
+                        activeInstance_->populateShopFromScoutedData(*shopId);
+
+                        const void *pResult = GetCurrentItemShopData(mapId, nIdx);
+                        if (pResult != nullptr)
+                        {
+                            wolf::logDebug("[ShopMan] Returning custom ISL data at %p", pResult);
+                            return pResult;
+                        }
+                        else
+                        {
+                            wolf::logWarning("[ShopMan] GetCurrentItemShopData returned nullptr!");
+                        }
                     }
                     else
                     {
-                        wolf::logWarning("[ShopMan] GetCurrentItemShopData returned nullptr!");
+                        wolf::logDebug("[ShopMan] No scouted items, falling through to original");
                     }
                 }
-                else
-                {
-                    wolf::logDebug("[ShopMan] No scouted items, falling through to original");
-                }
             }
             else
             {
@@ -622,6 +739,23 @@ okami::ItemShopStock *__fastcall ShopMan::hookCKibaShop_GetShopStockList(void *p
         auto *currentMapPtr = reinterpret_cast<uint16_t *>(mainBase + EXTERIOR_MAP_ID_OFFSET);
         uint16_t mapId = *currentMapPtr;
 
+        // Vanilla fang shops must not report purchases against the last item shop
+        activeInstance_->currentShopId_ = -1;
+
+        auto fangShopId = GetFangShopIdForMap(mapId);
+        PreparedShops *prepared = activeInstance_->preparedShops_.load(std::memory_order_acquire);
+        if (prepared && fangShopId)
+        {
+            auto &stock = prepared->fangStock[static_cast<size_t>(*fangShopId - FANG_SHOP_ID_BASE)];
+            if (!stock.empty())
+            {
+                activeInstance_->currentShopId_ = *fangShopId;
+                registerPreparedNames(*prepared, *fangShopId);
+                *numItems = static_cast<uint32_t>(stock.size());
+                return stock.data();
+            }
+        }
+
         okami::ItemShopStock *pResult = GetCurrentDemonFangShopData(mapId, numItems);
         if (pResult != nullptr)
         {
@@ -690,7 +824,7 @@ void __fastcall ShopMan::hookCItemShop_PurchaseItem(void *pShop)
         int selectedSlot = scrollOffset + visualSelectIndex;
 
         int64_t checkId = checks::getShopCheckId(activeInstance_->currentShopId_, selectedSlot);
-        activeInstance_->purchasedChecks_.insert(checkId);
+        activeInstance_->markSlotPurchased(selectedSlot);
         activeInstance_->checkCallback_(checkId);
     }
 }
@@ -735,7 +869,7 @@ void __fastcall ShopMan::hookCKibaShop_PurchaseItem(void *pShop)
         int selectedSlot = scrollOffset + visualSelectIndex;
 
         int64_t checkId = checks::getShopCheckId(activeInstance_->currentShopId_, selectedSlot);
-        activeInstance_->purchasedChecks_.insert(checkId);
+        activeInstance_->markSlotPurchased(selectedSlot);
         activeInstance_->checkCallback_(checkId);
     }
 }
@@ -769,10 +903,8 @@ int __fastcall ShopMan::hookIsGrayedOut(void *pShop, int slotIndex)
 {
     if (activeInstance_ && activeInstance_->currentShopId_ >= 0 && activeInstance_->socket_.getSlotConfig().randomizeShops)
     {
-        int64_t checkId = checks::getShopCheckId(activeInstance_->currentShopId_, slotIndex);
-
         // Already purchased this AP slot
-        if (activeInstance_->purchasedChecks_.contains(checkId))
+        if (activeInstance_->isSlotPurchased(slotIndex))
             return 0; // grayed
 
         // Check if player can afford it
@@ -797,8 +929,7 @@ int __fastcall ShopMan::hookIsPurchased(void *pShop, int slotIndex)
 {
     if (activeInstance_ && activeInstance_->currentShopId_ >= 0 && activeInstance_->socket_.getSlotConfig().randomizeShops)
     {
-        int64_t checkId = checks::getShopCheckId(activeInstance_->currentShopId_, slotIndex);
-        return activeInstance_->purchasedChecks_.contains(checkId) ? 1 : 0;
+        return activeInstance_->isSlotPurchased(slotIndex) ? 1 : 0;
     }
 
     return originalIsPurchased_ ? originalIsPurchased_(pShop, slotIndex) : 0;
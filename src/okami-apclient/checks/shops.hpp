@@ -1,16 +1,21 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <bitset>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
-#include <okami/filebuffer.h>
+#include <okami/serializer.hpp>
 #include <okami/shopdata.h>
 
+#include "map_registry.hpp"
+
 // Forward declarations
 class ISocket;
 struct ScoutedItem;
@@ -30,12 +35,13 @@ constexpr size_t MaxShopStockSize = 50;
 class ShopDefinition
 {
   private:
-    FileBuffer dataISL;
+    okami::ByteBuffer dataISL;
 
     bool dirty = true;
     okami::SellValueArray sellValues = okami::DefaultItemSellPrices;
     std::vector<okami::ItemShopStock> itemStock;
 
+    template <typename Sink> void SerializeISL(Sink &out) const;
     void RebuildISL();
     void CheckDirty();
 
@@ -45,6 +51,10 @@ class ShopDefinition
     // Warning: Do NOT call when shop is currently open.
     const uint8_t *GetData();
 
+    // Write the ISL image into a caller- or game-owned buffer.
+    // Returns the bytes written, or 0 if it doesn't fit.
+    size_t WriteISL(std::span<uint8_t> out) const;
+
     void SetStock(const std::vector<okami::ItemShopStock> &stock);
     void AddItem(okami::ItemTypes::Enum item, int32_t cost);
     void ClearStock();
@@ -59,6 +69,9 @@ okami::ItemShopStock *GetCurrentDemonFangShopData(uint16_t mapId, uint32_t *pNum
 // Get shop ID for a given map (returns nullopt if no shop on this map)
 [[nodiscard]] std::optional<int> GetShopIdForMap(uint16_t mapId, uint32_t shopNum);
 
+// Get the demon fang shop ID for a given map (returns nullopt if none)
+[[nodiscard]] std::optional<int> GetFangShopIdForMap(uint16_t mapId);
+
 // Get the number of slots for a shop (max items it can hold)
 [[nodiscard]] constexpr int GetShopSlotCount([[maybe_unused]] int shopId)
 {
@@ -69,6 +82,13 @@ okami::ItemShopStock *GetCurrentDemonFangShopData(uint16_t mapId, uint32_t *pNum
  * @brief Manager for shop randomization and purchase detection
  *
  * Follows the ContainerMan pattern for WOLF hook management.
+ *
+ * After slot connect, prepareShops() scouts every item and demon fang shop
+ * in one batch without waiting for the reply. When it arrives, a later game
+ * tick builds each ISL image and stock list and publishes the result with
+ * an atomic pointer swap. The resource hooks then hand the game a finished
+ * buffer. Until a preparation is published (or if it failed), shops fall
+ * back to scouting lazily on first open.
  */
 class ShopMan
 {
@@ -88,7 +108,22 @@ class ShopMan
     void shutdown();
     void reset();
 
+    /**
+     * @brief Scout every shop and build them when the reply arrives
+     *
+     * Call once slot config is ready. Does nothing unless shops are
+     * randomized. Returns without waiting; the reply is built and published
+     * from processMainThreadTasks(). Supersedes a preparation still in flight.
+     */
+    void prepareShops();
+
+    /// Drop the published shops (e.g. on disconnect); lazy scouting resumes.
+    void discardPreparedShops();
+
+    [[nodiscard]] bool hasPreparedShops() const;
+
   private:
+    struct PreparedShops;
     // Hook function types
     using GetShopVariationFn = int64_t(__fastcall *)(void *, uint32_t, char **);
     using LoadRscFn = const void *(__fastcall *)(void *, const char *, uint32_t);
@@ -130,6 +165,12 @@ class ShopMan
     void scoutShopsForMap(uint16_t mapId);
     void populateShopFromScoutedData(int shopId);
 
+    // Builds every shop from prepareShops()'s scout reply
+    static std::unique_ptr<PreparedShops> buildPreparedShops(ISocket &socket, const std::vector<ScoutedItem> &scouted, int shopSlots, int playerSlot);
+
+    // Registers the shop's scouted names with itempatch (game thread, idempotent)
+    static void registerPreparedNames(const PreparedShops &prepared, int shopId);
+
     ISocket &socket_;
     CheckCallback checkCallback_;
     bool initialized_ = false;
@@ -141,8 +182,20 @@ class ShopMan
     // Current shop tracking (set when ISL loads, used by purchase hooks)
     int currentShopId_ = -1;
 
-    // Tracks AP locations that have been purchased this session
-    std::unordered_set<int64_t> purchasedChecks_;
+    // Slot purchased-this-session flags for the current shop ID. Read by the
+    // isGrayedOut/isPurchased hooks every frame the shop is open, so this is a
+    // fixed table rather than a set of check IDs.
+    std::array<std::bitset<MaxShopStockSize>, NUM_SHOPS> purchasedSlots_;
+
+    [[nodiscard]] bool isSlotPurchased(int slot) const;
+    void markSlotPurchased(int slot);
+
+    // Published preparation, read lock-free by the resource hooks. Every
+    // preparation stays alive until ShopMan is destroyed, since the game may
+    // still hold an ISL pointer from an earlier one (a few KB per reconnect).
+    std::atomic<PreparedShops *> preparedShops_{nullptr};
+    std::vector<std::unique_ptr<PreparedShops>> preparedHistory_;
+    std::shared_ptr<int> prepareRequest_; // replaced per prepare, reset by discard; a reply is dropped once this expires
 };
 
 } // namespace checks
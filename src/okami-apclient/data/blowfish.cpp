@@ -25,7 +25,14 @@ SOFTWARE.
 
 #include "okami/blowfish.hpp"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace Nippon
 {
@@ -144,175 +151,322 @@ static uint32_t const sS[4][256] = {
     },
 };
 
-// Mutable working copies of P-array and S-boxes (populated by Create())
-static uint32_t sPP[16 + 2] = {};
-static uint32_t mSS[4][256] = {};
+// ============================================================================
+// Worker pool
+// ============================================================================
 
-void BlowFish::Create(std::string const &Key)
+namespace
+{
+
+/// Slices smaller than this aren't worth a hand-off to another thread.
+constexpr std::size_t kMinSliceBytes = 64 * 1024;
+/// Past this, slices mostly wait on memory rather than on the S-boxes.
+constexpr unsigned kMaxPoolWorkers = 7;
+
+/**
+ * Fixed set of workers that run index-sliced jobs. The caller of run() works
+ * on its own job too and returns once every slice has finished, so jobs can
+ * live on the caller's stack. Several threads may call run() at once; their
+ * jobs are served in order.
+ */
+class WorkerPool
 {
-    uint32_t i, j, k;
-    uint32_t data, datal, datar;
+  public:
+    using SliceFn = void (*)(const void *ctx, std::size_t slice);
 
-    for (i = 0; i < 4; i++)
+    /// Never destroyed: joining threads from a static destructor can deadlock
+    /// while the DLL is unloading, so the workers simply outlive it.
+    static WorkerPool &instance()
     {
-        for (j = 0; j < 256; j++)
-        {
-            mSS[i][j] = sS[i][j];
-        }
+        static WorkerPool *s_pool = new WorkerPool(std::clamp(std::thread::hardware_concurrency(), 2u, kMaxPoolWorkers + 1) - 1);
+        return *s_pool;
+    }
+
+    /// Threads a job can use, caller included.
+    [[nodiscard]] unsigned concurrency() const noexcept
+    {
+        return workers_ + 1;
+    }
+
+    void run(std::size_t slices, SliceFn fn, const void *ctx)
+    {
+        Job job{fn, ctx, slices, 0, slices};
+
+        std::unique_lock lock(mutex_);
+        queue_.push_back(&job);
+        work_.notify_all();
+
+        // Help with our own job, then wait for slices still running elsewhere
+        while (job.next < job.slices)
+            runSlice(lock, job);
+        done_.wait(lock, [&] { return job.remaining == 0; });
+    }
+
+  private:
+    struct Job
+    {
+        SliceFn fn;
+        const void *ctx;
+        std::size_t slices;
+        std::size_t next;      // next slice to hand out
+        std::size_t remaining; // slices not yet finished
+    };
+
+    explicit WorkerPool(unsigned workers) : workers_(workers)
+    {
+        for (unsigned i = 0; i < workers; ++i)
+            std::thread([this] { workerLoop(); }).detach();
+    }
+
+    /// Claims the next slice of job and runs it unlocked. Called with mutex_ held.
+    void runSlice(std::unique_lock<std::mutex> &lock, Job &job)
+    {
+        const std::size_t slice = job.next++;
+        if (job.next == job.slices)
+            queue_.erase(std::ranges::find(queue_, &job));
+
+        lock.unlock();
+        job.fn(job.ctx, slice);
+        lock.lock();
+
+        if (--job.remaining == 0)
+            done_.notify_all();
     }
 
-    j = 0;
-    for (i = 0; i < 16 + 2; ++i)
+    void workerLoop()
     {
-        data = 0x00000000;
-        for (k = 0; k < 4; ++k)
+        std::unique_lock lock(mutex_);
+        for (;;)
         {
-            data = (data << 8) | static_cast<uint8_t>(Key[j]);
-            j = j + 1;
-            if (j >= Key.size())
-            {
-                j = 0;
-            }
+            work_.wait(lock, [this] { return !queue_.empty(); });
+            runSlice(lock, *queue_.front());
         }
-        sPP[i] = sP[i] ^ data;
     }
 
-    datal = 0x00000000;
-    datar = 0x00000000;
+    unsigned workers_;
+    std::mutex mutex_;
+    std::condition_variable work_; // queue_ became non-empty
+    std::condition_variable done_; // some job finished its last slice
+    std::deque<Job *> queue_;      // jobs with slices left to hand out
+};
+
+} // namespace
+
+// ============================================================================
+// BlowfishContext
+// ============================================================================
 
-    for (i = 0; i < 16 + 2; i += 2)
+BlowfishContext::BlowfishContext(std::string_view key)
+{
+    for (std::size_t i = 0; i < 4; ++i)
+        std::copy(std::begin(sS[i]), std::end(sS[i]), s_[i].begin());
+
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < 16 + 2; ++i)
     {
-        Encrypt(&datal, &datar);
-        sPP[i] = datal;
-        sPP[i + 1] = datar;
+        uint32_t data = 0;
+        for (int k = 0; k < 4 && !key.empty(); ++k)
+        {
+            data = (data << 8) | static_cast<uint8_t>(key[j]);
+            j = (j + 1) % key.size();
+        }
+        p_[i] = sP[i] ^ data;
     }
 
-    for (i = 0; i < 4; ++i)
+    uint32_t datal = 0;
+    uint32_t datar = 0;
+    for (std::size_t i = 0; i < 16 + 2; i += 2)
+    {
+        encryptBlock(datal, datar);
+        p_[i] = datal;
+        p_[i + 1] = datar;
+    }
+    for (auto &box : s_)
     {
-        for (j = 0; j < 256; j += 2)
+        for (std::size_t i = 0; i < 256; i += 2)
         {
-            Encrypt(&datal, &datar);
-            mSS[i][j] = datal;
-            mSS[i][j + 1] = datar;
+            encryptBlock(datal, datar);
+            box[i] = datal;
+            box[i + 1] = datar;
         }
     }
 }
 
-void BlowFish::Encrypt(uint32_t *XL, uint32_t *XR)
+uint32_t BlowfishContext::feistel(uint32_t x) const noexcept
 {
-    uint32_t xl = *XL;
-    uint32_t xr = *XR;
-    uint32_t tesPP = 0;
+    uint32_t y = s_[0][x >> 24] + s_[1][(x >> 16) & 0xFF];
+    y ^= s_[2][(x >> 8) & 0xFF];
+    return y + s_[3][x & 0xFF];
+}
 
-    for (int i = 0; i < 16; ++i)
+template <bool Decrypt, std::size_t Lanes> void BlowfishContext::processGroup(uint8_t *data) const noexcept
+{
+    std::array<uint32_t, Lanes> l;
+    std::array<uint32_t, Lanes> r;
+    for (std::size_t j = 0; j < Lanes; ++j)
     {
-        xl = xl ^ sPP[i];
-        xr = Feistel(xl) ^ xr;
-        tesPP = xl;
-        xl = xr;
-        xr = tesPP;
+        std::memcpy(&l[j], data + j * 8, sizeof(uint32_t));
+        std::memcpy(&r[j], data + j * 8 + 4, sizeof(uint32_t));
     }
 
-    tesPP = xl;
-    xl = xr;
-    xr = tesPP;
+    // Lane-major inner loop: the lanes' S-box loads are independent, so they
+    // overlap instead of each round waiting on the previous one's lookups
+    for (std::size_t round = 0; round < 16; ++round)
+    {
+        const uint32_t key = Decrypt ? p_[17 - round] : p_[round];
+        for (std::size_t j = 0; j < Lanes; ++j)
+        {
+            l[j] ^= key;
+            r[j] ^= feistel(l[j]);
+            std::swap(l[j], r[j]);
+        }
+    }
 
-    xr = xr ^ sPP[16];
-    xl = xl ^ sPP[16 + 1];
+    // Undo the last swap and apply the output whitening
+    const uint32_t keyR = Decrypt ? p_[1] : p_[16];
+    const uint32_t keyL = Decrypt ? p_[0] : p_[17];
+    for (std::size_t j = 0; j < Lanes; ++j)
+    {
+        const uint32_t outL = r[j] ^ keyL;
+        const uint32_t outR = l[j] ^ keyR;
+        std::memcpy(data + j * 8, &outL, sizeof(uint32_t));
+        std::memcpy(data + j * 8 + 4, &outR, sizeof(uint32_t));
+    }
+}
 
-    *XL = xl;
-    *XR = xr;
+template <bool Decrypt> void BlowfishContext::processBlocks(uint8_t *data, std::size_t blocks) const noexcept
+{
+    std::size_t b = 0;
+    for (; b + kLanes <= blocks; b += kLanes)
+        processGroup<Decrypt, kLanes>(data + b * 8);
+    for (; b < blocks; ++b)
+        processGroup<Decrypt, 1>(data + b * 8);
 }
 
-void BlowFish::Decrypt(uint32_t *XL, uint32_t *XR)
+template <bool Decrypt> void BlowfishContext::process(std::span<uint8_t> bytes, unsigned maxThreads) const
 {
-    uint32_t xl = *XL;
-    uint32_t xr = *XR;
-    uint32_t tesPP = 0;
+    const std::size_t blocks = bytes.size() / 8;
+    if (bytes.size() < kParallelBytes)
+    {
+        processBlocks<Decrypt>(bytes.data(), blocks);
+        return;
+    }
 
-    for (int i = 16 + 1; i > 1; --i)
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    WorkerPool &pool = WorkerPool::instance();
+    const std::size_t slices = std::min<std::size_t>({maxThreads, pool.concurrency(), bytes.size() / kMinSliceBytes});
+    if (slices <= 1)
     {
-        xl = xl ^ sPP[i];
-        xr = Feistel(xl) ^ xr;
-        tesPP = xl;
-        xl = xr;
-        xr = tesPP;
+        processBlocks<Decrypt>(bytes.data(), blocks);
+        return;
     }
 
-    tesPP = xl;
-    xl = xr;
-    xr = tesPP;
+    struct Work
+    {
+        const BlowfishContext *self;
+        uint8_t *data;
+        std::size_t blocks;
+        std::size_t slices;
+    };
+    const Work work{this, bytes.data(), blocks, slices};
+
+    pool.run(
+        slices,
+        [](const void *ctx, std::size_t slice)
+        {
+            const auto &w = *static_cast<const Work *>(ctx);
+            const std::size_t begin = w.blocks * slice / w.slices;
+            const std::size_t end = w.blocks * (slice + 1) / w.slices;
+            w.self->template processBlocks<Decrypt>(w.data + begin * 8, end - begin);
+        },
+        &work);
+}
+
+void BlowfishContext::encryptBlock(uint32_t &xl, uint32_t &xr) const noexcept
+{
+    uint8_t block[8];
+    std::memcpy(block, &xl, sizeof(xl));
+    std::memcpy(block + 4, &xr, sizeof(xr));
+    processGroup<false, 1>(block);
+    std::memcpy(&xl, block, sizeof(xl));
+    std::memcpy(&xr, block + 4, sizeof(xr));
+}
 
-    xr = xr ^ sPP[1];
-    xl = xl ^ sPP[0];
+void BlowfishContext::decryptBlock(uint32_t &xl, uint32_t &xr) const noexcept
+{
+    uint8_t block[8];
+    std::memcpy(block, &xl, sizeof(xl));
+    std::memcpy(block + 4, &xr, sizeof(xr));
+    processGroup<true, 1>(block);
+    std::memcpy(&xl, block, sizeof(xl));
+    std::memcpy(&xr, block + 4, sizeof(xr));
+}
 
-    *XL = xl;
-    *XR = xr;
+void BlowfishContext::encrypt(std::span<uint8_t> bytes, unsigned maxThreads) const
+{
+    process<false>(bytes, maxThreads);
 }
 
-// Internal block iteration helper used by both vector and span overloads
-static void encryptBlocks(std::span<uint8_t> bytes)
+void BlowfishContext::decrypt(std::span<uint8_t> bytes, unsigned maxThreads) const
 {
-    const std::size_t numBlocks = bytes.size() / 8;
-    for (std::size_t i = 0; i < numBlocks; ++i)
-    {
-        uint32_t xl{}, xr{};
-        std::memcpy(&xl, bytes.data() + i * 8, sizeof(xl));
-        std::memcpy(&xr, bytes.data() + i * 8 + 4, sizeof(xr));
-        Nippon::BlowFish::Encrypt(&xl, &xr);
-        std::memcpy(bytes.data() + i * 8, &xl, sizeof(xl));
-        std::memcpy(bytes.data() + i * 8 + 4, &xr, sizeof(xr));
-    }
+    process<true>(bytes, maxThreads);
 }
 
-static void decryptBlocks(std::span<uint8_t> bytes)
+const BlowfishContext &okamiCipher()
 {
-    const std::size_t numBlocks = bytes.size() / 8;
-    for (std::size_t i = 0; i < numBlocks; ++i)
-    {
-        uint32_t xl{}, xr{};
-        std::memcpy(&xl, bytes.data() + i * 8, sizeof(xl));
-        std::memcpy(&xr, bytes.data() + i * 8 + 4, sizeof(xr));
-        Nippon::BlowFish::Decrypt(&xl, &xr);
-        std::memcpy(bytes.data() + i * 8, &xl, sizeof(xl));
-        std::memcpy(bytes.data() + i * 8 + 4, &xr, sizeof(xr));
-    }
+    static const BlowfishContext s_cipher{kCipherKey};
+    return s_cipher;
+}
+
+// ============================================================================
+// BlowFish (process-wide key)
+// ============================================================================
+
+namespace
+{
+// Keyed with the game's cipher key until Create() says otherwise
+std::unique_ptr<BlowfishContext> s_context;
+
+const BlowfishContext &current()
+{
+    return s_context ? *s_context : okamiCipher();
+}
+} // namespace
+
+void BlowFish::Create(std::string const &Key)
+{
+    s_context = std::make_unique<BlowfishContext>(Key);
+}
+
+void BlowFish::Encrypt(uint32_t *XL, uint32_t *XR)
+{
+    current().encryptBlock(*XL, *XR);
+}
+
+void BlowFish::Decrypt(uint32_t *XL, uint32_t *XR)
+{
+    current().decryptBlock(*XL, *XR);
 }
 
 void BlowFish::Encrypt(std::vector<uint8_t> &Bytes)
 {
-    encryptBlocks(std::span<uint8_t>{Bytes});
+    current().encrypt(Bytes);
 }
 
 void BlowFish::Decrypt(std::vector<uint8_t> &Bytes)
 {
-    decryptBlocks(std::span<uint8_t>{Bytes});
+    current().decrypt(Bytes);
 }
 
 void BlowFish::Encrypt(std::span<uint8_t> Bytes)
 {
-    encryptBlocks(Bytes);
+    current().encrypt(Bytes);
 }
 
 void BlowFish::Decrypt(std::span<uint8_t> Bytes)
 {
-    decryptBlocks(Bytes);
-}
-
-uint32_t BlowFish::Feistel(uint32_t X)
-{
-    const auto d = static_cast<uint8_t>(X & 0xFF);
-    X >>= 8;
-    const auto c = static_cast<uint8_t>(X & 0xFF);
-    X >>= 8;
-    const auto b = static_cast<uint8_t>(X & 0xFF);
-    X >>= 8;
-    const auto a = static_cast<uint8_t>(X & 0xFF);
-
-    uint32_t y = mSS[0][a] + mSS[1][b];
-    y = y ^ mSS[2][c];
-    y = y + mSS[3][d];
-    return y;
+    current().decrypt(Bytes);
 }
 
 } // namespace Nippon
@@ -1,10 +1,14 @@
 #include "okami/customiconpkg.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <optional>
+#include <system_error>
+#include <type_traits>
 #include <vector>
 
-#include "okami/blowfish.hpp"
+#include "okami/contenthash.hpp"
 #include "okami/resourcepkg.hpp"
 
 namespace okami::customiconpkg
@@ -13,62 +17,86 @@ namespace okami::customiconpkg
 namespace
 {
 
-struct RawEntry
+std::vector<uint8_t> readFile(const std::filesystem::path &path)
 {
-    ResourceType type{};
-    std::vector<uint8_t> data{};
-};
-
-/// Decrypt and parse all entries from an Okami Blowfish DAT package.
-/// Returns an empty vector on any read or format error.
-static std::vector<RawEntry> readPackageEntries(const std::filesystem::path &path)
-{
-    // BlowFish::Create is idempotent with the same key — safe to call multiple times.
-    Nippon::BlowFish::Create(std::string(Nippon::kCipherKey));
-
-    std::ifstream f(path, std::ios::binary | std::ios::ate);
-    if (!f)
-        return {};
-    const auto sz = static_cast<std::size_t>(f.tellg());
-    if (sz < sizeof(uint32_t))
+    std::ifstream ifs{path, std::ios::binary | std::ios::ate};
+    if (!ifs)
         return {};
-    f.seekg(0);
+    const auto sz = static_cast<std::size_t>(ifs.tellg());
+    ifs.seekg(0);
     std::vector<uint8_t> buf(sz);
-    f.read(reinterpret_cast<char *>(buf.data()), static_cast<std::streamsize>(sz));
-    if (!f.good())
+    ifs.read(reinterpret_cast<char *>(buf.data()), static_cast<std::streamsize>(sz));
+    if (!ifs.good())
         return {};
+    return buf;
+}
 
-    Nippon::BlowFish::Decrypt(buf);
+// ============================================================================
+// Build manifest
+// ============================================================================
 
-    uint32_t numElems = 0;
-    std::memcpy(&numElems, buf.data(), sizeof(numElems));
-    if (numElems < 1)
-        return {};
+/// Bumped whenever the combined package layout changes, so old caches rebuild.
+constexpr uint32_t kManifestVersion = 2;
+constexpr uint32_t kManifestMagic = 0x4D434941; // "AICM"
 
-    const uint32_t actual = numElems - 1;                          // ROF sentinel is the last element
-    const std::size_t hdrSize = sizeof(uint32_t)                   // numElems
-                                + numElems * sizeof(uint32_t)      // offsets[]
-                                + numElems * sizeof(ResourceType); // type tags[]
-    if (buf.size() < hdrSize)
-        return {};
+/// Everything the combined package is built from.
+struct ManifestInputs
+{
+    uint64_t vanillaHash;
+    uint64_t standardHash;
+    uint64_t progressionHash;
+    uint64_t trapHash;
+    uint64_t entriesHash; // kIconEntries, so remapped icons rebuild too
+    bool operator==(const ManifestInputs &) const = default;
+};
 
-    const auto *offsets = reinterpret_cast<const uint32_t *>(buf.data() + sizeof(uint32_t));
-    const auto *types = reinterpret_cast<const ResourceType *>(buf.data() + sizeof(uint32_t) + numElems * sizeof(uint32_t));
+/// Written next to the combined package after a successful build.
+struct Manifest
+{
+    uint32_t magic;
+    uint32_t version;
+    ManifestInputs inputs;
+    uint64_t outputSize;
+    int32_t vanillaCount;
+    int32_t iconCount;
+    std::array<uint16_t, (kIconEntries.size() + 3) / 4 * 4> iconIndex; // rounded up so the struct has no padding
+};
+static_assert(std::is_trivially_copyable_v<Manifest> && std::has_unique_object_representations_v<Manifest>, "manifest is written as raw bytes");
 
-    std::vector<RawEntry> result;
-    result.reserve(actual);
-    for (uint32_t i = 0; i < actual; ++i)
+std::optional<Manifest> readManifest(const std::filesystem::path &path)
+{
+    const auto bytes = readFile(path);
+    if (bytes.size() != sizeof(Manifest))
+        return std::nullopt;
+    Manifest manifest;
+    std::memcpy(&manifest, bytes.data(), sizeof(manifest));
+    if (manifest.magic != kManifestMagic || manifest.version != kManifestVersion)
+        return std::nullopt;
+    return manifest;
+}
+
+bool writeManifest(const std::filesystem::path &path, const Manifest &manifest)
+{
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+        return false;
+    out.write(reinterpret_cast<const char *>(&manifest), sizeof(manifest));
+    return out.good();
+}
+
+/// True if outPath is exactly what a build from these inputs would produce.
+bool cachedOutputMatches(const std::filesystem::path &outPath, const Manifest &manifest, const ManifestInputs &inputs)
+{
+    if (!(manifest.inputs == inputs) || manifest.vanillaCount <= 0 || manifest.iconCount < 0)
+        return false;
+    for (uint16_t index : std::span(manifest.iconIndex).first<kIconEntries.size()>())
     {
-        const uint32_t start = offsets[i];
-        const uint32_t end = offsets[i + 1]; // next offset (or ROF sentinel offset)
-        if (start > end || end > static_cast<uint32_t>(buf.size()))
-            return {};
-        RawEntry e;
-        e.type = types[i];
-        e.data.assign(buf.begin() + start, buf.begin() + end);
-        result.push_back(std::move(e));
+        if (index >= manifest.vanillaCount + manifest.iconCount)
+            return false;
     }
-    return result;
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(outPath, ec);
+    return !ec && size == manifest.outputSize;
 }
 
 } // anonymous namespace
@@ -81,7 +109,7 @@ bool build(const std::filesystem::path &outPath, std::span<const uint8_t> standa
 
     const std::array<std::span<const uint8_t>, 3> ddsBuffers = {standardData, progressionData, trapData};
 
-    ResourcePackage pkg;
+    ResourcePackageWriter pkg;
     pkg.addBlank(); // index-0 reserved
 
     for (const auto &e : kIconEntries)
@@ -93,14 +121,6 @@ bool build(const std::filesystem::path &outPath, std::span<const uint8_t> standa
 bool buildFromFiles(const std::filesystem::path &outPath, const std::filesystem::path &standardPath, const std::filesystem::path &progressionPath,
                     const std::filesystem::path &trapPath)
 {
-    auto readFile = [](const std::filesystem::path &p) -> std::vector<uint8_t>
-    {
-        std::ifstream ifs{p, std::ios::binary};
-        if (!ifs)
-            return {};
-        return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
-    };
-
     const auto std_data = readFile(standardPath);
     const auto prog_data = readFile(progressionPath);
     const auto trap_data = readFile(trapPath);
@@ -108,44 +128,85 @@ bool buildFromFiles(const std::filesystem::path &outPath, const std::filesystem:
     return build(outPath, std_data, prog_data, trap_data);
 }
 
+std::filesystem::path manifestPath(const std::filesystem::path &outPath)
+{
+    return std::filesystem::path(outPath) += ".manifest";
+}
+
 bool buildCombinedFromFiles(const std::filesystem::path &outPath, const std::filesystem::path &vanillaPath, const std::filesystem::path &standardPath,
-                            const std::filesystem::path &progressionPath, const std::filesystem::path &trapPath, int &vanillaCount)
+                            const std::filesystem::path &progressionPath, const std::filesystem::path &trapPath, CombinedPackage &layout)
 {
-    vanillaCount = 0;
+    layout = {};
+
+    const auto vanillaData = readFile(vanillaPath);
+    const auto std_data = readFile(standardPath);
+    const auto prog_data = readFile(progressionPath);
+    const auto trap_data = readFile(trapPath);
 
-    const auto vanillaEntries = readPackageEntries(vanillaPath);
-    if (vanillaEntries.empty())
+    if (vanillaData.empty() || std_data.empty() || prog_data.empty() || trap_data.empty())
         return false;
-    vanillaCount = static_cast<int>(vanillaEntries.size());
 
-    auto readFile = [](const std::filesystem::path &p) -> std::vector<uint8_t>
-    {
-        std::ifstream ifs{p, std::ios::binary};
-        if (!ifs)
-            return {};
-        return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+    // Hashing the inputs is far cheaper than decrypting, rebuilding, re-encrypting and
+    // writing the package, so an unchanged install skips straight to the cached output.
+    const ManifestInputs inputs{
+        .vanillaHash = contentHash(vanillaData),
+        .standardHash = contentHash(std_data),
+        .progressionHash = contentHash(prog_data),
+        .trapHash = contentHash(trap_data),
+        .entriesHash = contentHash({reinterpret_cast<const uint8_t *>(kIconEntries.data()), sizeof(kIconEntries)}),
     };
 
-    const auto std_data = readFile(standardPath);
-    const auto prog_data = readFile(progressionPath);
-    const auto trap_data = readFile(trapPath);
+    const auto manifestFile = manifestPath(outPath);
+    if (const auto manifest = readManifest(manifestFile); manifest && cachedOutputMatches(outPath, *manifest, inputs))
+    {
+        layout.vanillaCount = manifest->vanillaCount;
+        layout.iconCount = manifest->iconCount;
+        std::ranges::copy(std::span(manifest->iconIndex).first<kIconEntries.size()>(), layout.iconIndex.begin());
+        return true;
+    }
+
+    // Drop the stale manifest first so an interrupted rebuild can never look current
+    std::error_code ec;
+    std::filesystem::remove(manifestFile, ec);
 
-    if (std_data.empty() || prog_data.empty() || trap_data.empty())
+    ResourcePackageReader vanilla;
+    if (!vanilla.open(vanillaPath) || vanilla.size() == 0)
         return false;
 
     const std::array<std::span<const uint8_t>, 3> ddsBuffers = {std_data, prog_data, trap_data};
 
-    ResourcePackage pkg;
+    // Vanilla entries and icons are borrowed straight from the reader and the DDS buffers
+    ResourcePackageWriter pkg;
 
     // Copy vanilla entries at their original indices (0..vanillaCount-1)
-    for (const auto &e : vanillaEntries)
-        pkg.addEntry(e.type, e.data);
+    for (std::size_t i = 0; i < vanilla.size(); ++i)
+        pkg.addEntry(vanilla.type(i), vanilla.entry(i));
+
+    // Append one entry per distinct icon after the vanilla ones. Most rows share the
+    // standard icon, so they resolve to the same index instead of repeating its bytes
+    // (an icon identical to a vanilla one simply reuses that entry).
+    CombinedPackage built;
+    built.vanillaCount = static_cast<int>(vanilla.size());
+    for (size_t i = 0; i < kIconEntries.size(); ++i)
+    {
+        const auto &dds = ddsBuffers[static_cast<size_t>(kIconEntries[i].ddsIndex)];
+        built.iconIndex[i] = static_cast<uint16_t>(pkg.addUniqueEntry(ResourceType{'D', 'D', 'S', '\0'}, dds));
+    }
+    built.iconCount = static_cast<int>(pkg.size() - vanilla.size());
 
-    // Append custom entries at indices vanillaCount..vanillaCount+kIconEntries.size()-1
-    for (const auto &e : kIconEntries)
-        pkg.addEntry(ResourceType{'D', 'D', 'S', '\0'}, ddsBuffers[static_cast<size_t>(e.ddsIndex)]);
+    if (!pkg.write(outPath))
+        return false;
+    layout = built;
 
-    return pkg.write(outPath);
+    // A missing manifest only costs a rebuild next launch
+    const auto outputSize = std::filesystem::file_size(outPath, ec);
+    if (!ec)
+    {
+        Manifest manifest{kManifestMagic, kManifestVersion, inputs, outputSize, layout.vanillaCount, layout.iconCount, {}};
+        std::ranges::copy(layout.iconIndex, manifest.iconIndex.begin());
+        writeManifest(manifestFile, manifest);
+    }
+    return true;
 }
 
 } // namespace okami::customiconpkg
@@ -1,5 +1,7 @@
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -142,38 +144,53 @@ static void writeU32(std::vector<uint8_t> &buf, uint32_t val)
     writeStruct(buf, val);
 }
 
-/// Generate an MD binary blob for a single-color box with 6 faces.
-static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
+// ------ Box layout ------
+// Every size and offset follows from the structure sizes alone, so the layout
+// is fixed at compile time and shared by every colour variant.
+
+constexpr size_t kMdHeaderAligned = ALIGN_UP_BY(sizeof(MdHeader), kAlignment);
+constexpr size_t kVerticesSize = ALIGN_UP_BY(sizeof(MdVertex) * kVerticesPerFace, kAlignment);
+constexpr size_t kTexMapSize = ALIGN_UP_BY(sizeof(TextureMap) * kVerticesPerFace, kAlignment);
+constexpr size_t kColorsSize = ALIGN_UP_BY(sizeof(ColorWeight) * kVerticesPerFace, kAlignment);
+constexpr size_t kSubMeshSize = ALIGN_UP_BY(kMdHeaderAligned + kVerticesSize + kTexMapSize + kColorsSize, kAlignment);
+
+// MdHeader offsets are relative to MdHeader start position.
+constexpr uint32_t kVertexOffset = static_cast<uint32_t>(kMdHeaderAligned);
+constexpr uint32_t kTextureMapOffset = static_cast<uint32_t>(kMdHeaderAligned + kVerticesSize);
+constexpr uint32_t kColorWeightOffset = static_cast<uint32_t>(kMdHeaderAligned + kVerticesSize + kTexMapSize);
+
+// SubMesh offsets are relative to MdbHeader start.
+// subMeshOffset[0] = sizeof(MdbHeader) + 6*sizeof(uint32_t), aligned to 0x10
+constexpr size_t kSubMeshOffsetBase = ALIGN_UP_BY(sizeof(MdbHeader) + kSubMeshCount * sizeof(uint32_t), kAlignment);
+
+// MdMeshSize = kSubMeshOffsetBase + 6 * kSubMeshSize, aligned to MESH_ALIGNMENT
+constexpr size_t kMdMeshSize = ALIGN_UP_BY(kSubMeshOffsetBase + kSubMeshCount * kSubMeshSize, kAlignment);
+
+// Transform offset from file start:
+//   ScrHeader(16) + 1*uint32_t(4) = 20, aligned to 0x10 = 32
+//   + kMdMeshSize
+//   aligned to TRANSFORM_ALIGNMENT
+constexpr size_t kAfterScrHeader = ALIGN_UP_BY(sizeof(ScrHeader) + sizeof(uint32_t), kAlignment);
+constexpr size_t kTransformOffset = ALIGN_UP_BY(kAfterScrHeader + kMdMeshSize, kAlignment);
+
+// Package header: entry count, one offset, one type tag. Aligned to 16 so the
+// MD data starts at a 16-byte boundary.
+constexpr uint32_t kPackageHeaderSize = sizeof(uint32_t) + sizeof(uint32_t) + 4;
+constexpr uint32_t kOffsetMd = ALIGN_UP_BY(kPackageHeaderSize, kAlignment);
+
+/// Package offset of a submesh's MdHeader. The MdbHeader sits right after the
+/// aligned ScrHeader and transform offset.
+constexpr size_t subMeshPackageOffset(uint32_t face)
 {
-    std::vector<uint8_t> buf;
-    buf.reserve(1024);
-
-    // ------ Compute sizes/offsets before writing ------
-
-    const size_t mdHeaderAligned = ALIGN_UP_BY(sizeof(MdHeader), kAlignment);
-    const size_t verticesSize = ALIGN_UP_BY(sizeof(MdVertex) * kVerticesPerFace, kAlignment);
-    const size_t texMapSize = ALIGN_UP_BY(sizeof(TextureMap) * kVerticesPerFace, kAlignment);
-    const size_t colorsSize = ALIGN_UP_BY(sizeof(ColorWeight) * kVerticesPerFace, kAlignment);
-    const size_t subMeshSize = ALIGN_UP_BY(mdHeaderAligned + verticesSize + texMapSize + colorsSize, kAlignment);
-
-    // MdHeader offsets are relative to MdHeader start position.
-    const uint32_t vertexOffset = static_cast<uint32_t>(mdHeaderAligned);
-    const uint32_t textureMapOffset = static_cast<uint32_t>(mdHeaderAligned + verticesSize);
-    const uint32_t colorWeightOffset = static_cast<uint32_t>(mdHeaderAligned + verticesSize + texMapSize);
-
-    // SubMesh offsets are relative to MdbHeader start.
-    // subMeshOffset[0] = sizeof(MdbHeader) + 6*sizeof(uint32_t), aligned to 0x10
-    const size_t subMeshOffsetBase = ALIGN_UP_BY(sizeof(MdbHeader) + kSubMeshCount * sizeof(uint32_t), kAlignment);
-
-    // MdMeshSize = subMeshOffsetBase + 6 * subMeshSize, aligned to MESH_ALIGNMENT
-    const size_t mdMeshSize = ALIGN_UP_BY(subMeshOffsetBase + kSubMeshCount * subMeshSize, kAlignment);
+    return kOffsetMd + kAfterScrHeader + kSubMeshOffsetBase + face * kSubMeshSize;
+}
 
-    // Transform offset from file start:
-    //   ScrHeader(16) + 1*uint32_t(4) = 20, aligned to 0x10 = 32
-    //   + mdMeshSize
-    //   aligned to TRANSFORM_ALIGNMENT
-    const size_t afterScrHeader = ALIGN_UP_BY(sizeof(ScrHeader) + sizeof(uint32_t), kAlignment);
-    const size_t transformOffset = ALIGN_UP_BY(afterScrHeader + mdMeshSize, kAlignment);
+/// Generate an MD binary blob for a box with 6 faces. Colour weights are left
+/// zeroed; BoxModelTemplate patches them per variant.
+static std::vector<uint8_t> generateBoxMD()
+{
+    std::vector<uint8_t> buf;
+    buf.reserve(kTransformOffset + sizeof(MdTransform));
 
     // ------ 1. ScrHeader ------
     ScrHeader scr{};
@@ -184,7 +201,7 @@ static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
     writeStruct(buf, scr);
 
     // ------ 2. Transform offset (1 mesh = 1 offset) ------
-    writeU32(buf, static_cast<uint32_t>(transformOffset));
+    writeU32(buf, static_cast<uint32_t>(kTransformOffset));
 
     // ------ 3. Align to 0x10 ------
     alignBuffer(buf, kAlignment);
@@ -201,7 +218,7 @@ static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
     // ------ 5. SubMesh offsets ------
     for (uint32_t i = 0; i < kSubMeshCount; i++)
     {
-        uint32_t offset = static_cast<uint32_t>(subMeshOffsetBase + i * subMeshSize);
+        uint32_t offset = static_cast<uint32_t>(kSubMeshOffsetBase + i * kSubMeshSize);
         writeU32(buf, offset);
     }
 
@@ -213,10 +230,10 @@ static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
     {
         // MdHeader
         MdHeader hdr{};
-        hdr.vertexOffset = vertexOffset;
+        hdr.vertexOffset = kVertexOffset;
         hdr.unknown1 = 0;
-        hdr.textureMapOffset = textureMapOffset;
-        hdr.colorWeightOffset = colorWeightOffset;
+        hdr.textureMapOffset = kTextureMapOffset;
+        hdr.colorWeightOffset = kColorWeightOffset;
         hdr.textureUvOffset = 0;
         hdr.vertexCount = kVerticesPerFace;
         hdr.textureIndex = 0;
@@ -249,16 +266,9 @@ static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
 
         alignBuffer(buf, kAlignment);
 
-        // Color weights
+        // Color weights (patched per variant)
         for (uint16_t v = 0; v < kVerticesPerFace; v++)
-        {
-            ColorWeight cw{};
-            cw.r = r;
-            cw.g = g;
-            cw.b = b;
-            cw.a = 255;
-            writeStruct(buf, cw);
-        }
+            writeStruct(buf, ColorWeight{});
 
         alignBuffer(buf, kAlignment);
 
@@ -276,7 +286,7 @@ static std::vector<uint8_t> generateBoxMD(uint8_t r, uint8_t g, uint8_t b)
     // MdTransform position back to the MdbHeader. The game engine computes:
     //   MdbHeader_ptr = MdTransform_ptr + *(int32_t*)MdTransform_ptr
     // (see FUN_18020d770 which reads *piVar11 as an offset adjustment)
-    const int32_t backOffset = static_cast<int32_t>(afterScrHeader) - static_cast<int32_t>(transformOffset);
+    const int32_t backOffset = static_cast<int32_t>(kAfterScrHeader) - static_cast<int32_t>(kTransformOffset);
 
     MdTransform xform{};
     std::memcpy(&xform.unk1, &backOffset, sizeof(backOffset)); // store as first 4 bytes
@@ -309,20 +319,15 @@ static std::vector<uint8_t> buildInMemoryPackage(const std::vector<uint8_t> &mdD
     //   [MD binary data...]
 
     constexpr uint32_t entryCount = 1;
-    constexpr uint32_t headerSize = sizeof(uint32_t)   // count
-                                    + sizeof(uint32_t) // one offset
-                                    + 4;               // one type tag
-    // headerSize = 12; align to 16 so MD data starts at a 16-byte boundary.
-    constexpr uint32_t offsetMd = ALIGN_UP_BY(headerSize, kAlignment);
 
     std::vector<uint8_t> pkg;
-    pkg.reserve(offsetMd + mdData.size());
+    pkg.reserve(kOffsetMd + mdData.size());
 
     // Entry count
     writeU32(pkg, entryCount);
 
     // Offset to MD data
-    writeU32(pkg, offsetMd);
+    writeU32(pkg, kOffsetMd);
 
     // Type tag "MD\0\0"
     const uint8_t tag[4] = {'M', 'D', '\0', '\0'};
@@ -342,28 +347,67 @@ static std::unordered_map<uint32_t, std::vector<uint8_t>> s_packages;
 
 } // anonymous namespace
 
+BoxModelTemplate::BoxModelTemplate() : m_image(buildInMemoryPackage(generateBoxMD()))
+{
+}
+
+bool BoxModelTemplate::buildInto(std::span<uint8_t> out, const ModelVariant &variant) const
+{
+    if (out.size() < m_image.size())
+        return false;
+
+    std::memcpy(out.data(), m_image.data(), m_image.size());
+
+    const ColorWeight color{variant.r, variant.g, variant.b, variant.a};
+    for (uint32_t face = 0; face < kSubMeshCount; face++)
+    {
+        uint8_t *subMesh = out.data() + subMeshPackageOffset(face);
+        std::memcpy(subMesh + offsetof(MdHeader, textureIndex), &variant.textureIndex, sizeof(variant.textureIndex));
+        for (uint16_t v = 0; v < kVerticesPerFace; v++)
+            std::memcpy(subMesh + kColorWeightOffset + v * sizeof(ColorWeight), &color, sizeof(color));
+    }
+    return true;
+}
+
+std::vector<uint8_t> BoxModelTemplate::build(const ModelVariant &variant) const
+{
+    std::vector<uint8_t> image(m_image.size());
+    (void)buildInto(image, variant);
+    return image;
+}
+
+std::vector<std::vector<uint8_t>> BoxModelTemplate::build(std::span<const ModelVariant> variants) const
+{
+    std::vector<std::vector<uint8_t>> images;
+    images.reserve(variants.size());
+    for (const auto &variant : variants)
+        images.push_back(build(variant));
+    return images;
+}
+
 void initialize()
 {
     struct DummyDef
     {
         uint8_t itemId;
-        uint8_t r, g, b;
+        ModelVariant variant;
     };
 
     constexpr DummyDef defs[] = {
-        {ItemTypes::ForeignStandardItem, 80, 120, 255},    // Blue
-        {ItemTypes::ForeignProgressionItem, 180, 80, 255}, // Purple
-        {ItemTypes::ForeignTrapItem, 255, 80, 80},         // Red
-        {ItemTypes::OkamiStandardItem, 80, 200, 200},      // Cyan
-        {ItemTypes::OkamiProgressionItem, 255, 200, 50},   // Gold
-        {ItemTypes::OkamiTrapItem, 255, 140, 50},          // Orange
+        {ItemTypes::ForeignStandardItem, {80, 120, 255}},    // Blue
+        {ItemTypes::ForeignProgressionItem, {180, 80, 255}}, // Purple
+        {ItemTypes::ForeignTrapItem, {255, 80, 80}},         // Red
+        {ItemTypes::OkamiStandardItem, {80, 200, 200}},      // Cyan
+        {ItemTypes::OkamiProgressionItem, {255, 200, 50}},   // Gold
+        {ItemTypes::OkamiTrapItem, {255, 140, 50}},          // Orange
     };
 
+    // One serialization of the box; each colour is a patched copy of it
+    const BoxModelTemplate model;
     for (const auto &d : defs)
     {
         uint32_t entityType = 0x0A00u | d.itemId;
-        auto md = generateBoxMD(d.r, d.g, d.b);
-        s_packages[entityType] = buildInMemoryPackage(md);
+        s_packages[entityType] = model.build(d.variant);
         wolf::logInfo("[custommodelpkg] Built model package for entity type 0x%04X (%zu bytes)", entityType, s_packages[entityType].size());
     }
 }
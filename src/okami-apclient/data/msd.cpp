@@ -1,12 +1,21 @@
 // For more information see https://okami.speedruns.wiki/Message_Data_(.MSD)_File_Format
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <okami/msd.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define OKAMI_MSD_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace okami
 {
 constexpr uint16_t EndDialog = 0x8001;
@@ -123,9 +132,252 @@ static constexpr auto buildASCIIToMSDTable() noexcept
 }
 static constexpr std::array<uint16_t, 128> kASCIIToMSDTable = buildASCIIToMSDTable();
 
+// ============================================================================
+// UTF-8 transcoding
+// ============================================================================
+
+// The MSD font only has the glyphs above, so other characters are spelled
+// with the nearest ASCII: accents are dropped, typographic punctuation is
+// flattened and full-width forms are narrowed. Anything else (CJK, Cyrillic,
+// symbols) becomes one UnsupportedChar per code point rather than per byte.
+
+// Base letters for U+00C0..U+017F (Latin-1 Supplement letters and Latin Extended-A)
+static constexpr std::string_view kLatinBaseLetters = "AAAAAAACEEEEIIII"
+                                                      "DNOOOOOxOUUUUYTs"
+                                                      "aaaaaaaceeeeiiii"
+                                                      "dnooooo/ouuuuyty"
+                                                      "AaAaAaCcCcCcCcDd"
+                                                      "DdEeEeEeEeEeGgGg"
+                                                      "GgGgHhHhIiIiIiIi"
+                                                      "IiIiJjKkkLlLlLlL"
+                                                      "lLlNnNnNnnNnOoOo"
+                                                      "OoOoRrRrRrSsSsSs"
+                                                      "SsTtTtTtUuUuUuUu"
+                                                      "UuUuWwYyYZzZzZzs";
+static constexpr char32_t kLatinBaseFirst = 0x00C0;
+static_assert(kLatinBaseLetters.size() == 0x0180 - kLatinBaseFirst);
+
+struct GlyphFallback
+{
+    char32_t codePoint;
+    std::string_view ascii;
+};
+
+// Everything outside the base-letter range, plus ligatures that spell out
+// better than one letter. Sorted by code point.
+static constexpr auto kGlyphFallbacks = std::to_array<GlyphFallback>({
+    // Latin-1 punctuation and ligatures
+    {0x00A0, " "},
+    {0x00A1, "!"},
+    {0x00AB, "\""},
+    {0x00B4, "'"},
+    {0x00B7, "."},
+    {0x00BB, "\""},
+    {0x00BF, "?"},
+    {0x00C6, "AE"},
+    {0x00DE, "Th"},
+    {0x00DF, "ss"},
+    {0x00E6, "ae"},
+    {0x00FE, "th"},
+    {0x0132, "IJ"},
+    {0x0133, "ij"},
+    {0x0152, "OE"},
+    {0x0153, "oe"},
+    // General punctuation
+    {0x2010, "-"},
+    {0x2011, "-"},
+    {0x2012, "-"},
+    {0x2013, "-"},
+    {0x2014, "-"},
+    {0x2015, "-"},
+    {0x2018, "'"},
+    {0x2019, "'"},
+    {0x201A, ","},
+    {0x201C, "\""},
+    {0x201D, "\""},
+    {0x201E, "\""},
+    {0x2022, "*"},
+    {0x2026, "..."},
+    {0x2032, "'"},
+    {0x2033, "\""},
+    {0x2122, "TM"},
+    // Ideographic space
+    {0x3000, " "},
+});
+
+// Full-width ASCII variants (U+FF01..U+FF5E) map onto '!'..'~'
+static constexpr char32_t kFullWidthFirst = 0xFF01;
+static constexpr char32_t kFullWidthLast = 0xFF5E;
+static constexpr char32_t kFullWidthOffset = 0xFEE0;
+
+static constexpr char32_t kReplacementChar = 0xFFFD;
+
+static constexpr size_t utf8Length(char32_t cp)
+{
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+// CompiledLength() is str.size() + 1, so no code point may spell out to more
+// glyphs than it has UTF-8 bytes
+static constexpr bool fallbacksFitInputLength()
+{
+    for (size_t i = 0; i < kGlyphFallbacks.size(); ++i)
+    {
+        if (i > 0 && kGlyphFallbacks[i - 1].codePoint >= kGlyphFallbacks[i].codePoint)
+            return false;
+        if (kGlyphFallbacks[i].ascii.size() > utf8Length(kGlyphFallbacks[i].codePoint))
+            return false;
+    }
+    return true;
+}
+static_assert(fallbacksFitInputLength(), "glyph fallbacks must be sorted and no longer than their UTF-8 encoding");
+
+/// Decodes the code point at str[i] and advances i. Malformed input yields
+/// kReplacementChar and consumes one byte.
+static char32_t decodeUTF8(std::string_view str, size_t &i)
+{
+    const auto lead = static_cast<uint8_t>(str[i]);
+    size_t length;
+    char32_t cp;
+    char32_t minimum;
+    if ((lead & 0xE0) == 0xC0)
+    {
+        length = 2;
+        cp = lead & 0x1F;
+        minimum = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length = 3;
+        cp = lead & 0x0F;
+        minimum = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length = 4;
+        cp = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        ++i;
+        return lead < 0x80 ? lead : kReplacementChar;
+    }
+
+    if (length > str.size() - i)
+    {
+        ++i;
+        return kReplacementChar;
+    }
+    for (size_t k = 1; k < length; ++k)
+    {
+        const auto cont = static_cast<uint8_t>(str[i + k]);
+        if ((cont & 0xC0) != 0x80)
+        {
+            ++i;
+            return kReplacementChar;
+        }
+        cp = (cp << 6) | (cont & 0x3F);
+    }
+    if (cp < minimum || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+    {
+        ++i;
+        return kReplacementChar;
+    }
+    i += length;
+    return cp;
+}
+
+/// Writes the glyphs for one non-ASCII code point; returns how many.
+static size_t writeCodePoint(char32_t cp, uint16_t *out)
+{
+    auto writeASCII = [out](std::string_view ascii)
+    {
+        for (size_t i = 0; i < ascii.size(); ++i)
+            out[i] = kASCIIToMSDTable[static_cast<unsigned char>(ascii[i])];
+        return ascii.size();
+    };
+
+    auto fallback = std::ranges::lower_bound(kGlyphFallbacks, cp, {}, &GlyphFallback::codePoint);
+    if (fallback != kGlyphFallbacks.end() && fallback->codePoint == cp)
+        return writeASCII(fallback->ascii);
+    if (cp >= kLatinBaseFirst && cp - kLatinBaseFirst < kLatinBaseLetters.size())
+        return writeASCII(kLatinBaseLetters.substr(cp - kLatinBaseFirst, 1));
+    if (cp >= kFullWidthFirst && cp <= kFullWidthLast)
+    {
+        out[0] = kASCIIToMSDTable[cp - kFullWidthOffset];
+        return 1;
+    }
+    out[0] = UnsupportedChar;
+    return 1;
+}
+
+#ifdef OKAMI_MSD_SSE2
+/// Converts 16 bytes if they are all ASCII. Letters, digits and spaces map to
+/// contiguous glyph ranges and are converted with compares and adds; the few
+/// other bytes are patched from the table afterwards. Returns false, writing
+/// nothing, if any byte is non-ASCII.
+static bool writeASCIIBlock(const char *src, uint16_t *out)
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    if (_mm_movemask_epi8(bytes) != 0)
+        return false;
+
+    // Bytes are < 0x80 here, so the signed compares are plain range checks
+    const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+    const __m128i isLower = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('z' + 1)));
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+    const __m128i isSpace = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+
+    __m128i glyphs = _mm_and_si128(isUpper, _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>('A' - kASCIIToMSDTable['A']))));
+    glyphs = _mm_or_si128(glyphs, _mm_and_si128(isLower, _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>('a' - kASCIIToMSDTable['a'])))));
+    glyphs = _mm_or_si128(glyphs, _mm_and_si128(isDigit, _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>('0' - kASCIIToMSDTable['0'])))));
+    static_assert(kASCIIToMSDTable[' '] == 0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(glyphs, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpackhi_epi8(glyphs, _mm_setzero_si128()));
+
+    const __m128i handled = _mm_or_si128(_mm_or_si128(isUpper, isLower), _mm_or_si128(isDigit, isSpace));
+    for (auto rest = static_cast<unsigned>(~_mm_movemask_epi8(handled)) & 0xFFFF; rest != 0; rest &= rest - 1)
+    {
+        const auto k = static_cast<size_t>(std::countr_zero(rest));
+        out[k] = kASCIIToMSDTable[static_cast<unsigned char>(src[k])];
+    }
+    return true;
+}
+#endif
+
+/// Converts the run of ASCII bytes starting at str[begin] to out[0...]; returns
+/// the index where the run stops.
+static size_t writeASCIIRun(std::string_view str, size_t begin, uint16_t *out)
+{
+    size_t i = begin;
+#ifdef OKAMI_MSD_SSE2
+    for (; i + 16 <= str.size(); i += 16)
+    {
+        if (!writeASCIIBlock(str.data() + i, out + (i - begin)))
+            break; // the scalar loop finishes the run up to the non-ASCII byte
+    }
+    // Finish a short ASCII tail with one overlapping block; rewriting bytes
+    // already converted is harmless
+    const size_t tail = str.size() - 16;
+    if (i < str.size() && i > tail && str.size() - begin >= 16 && writeASCIIBlock(str.data() + tail, out + (tail - begin)))
+        return str.size();
+#endif
+    for (; i < str.size(); ++i)
+    {
+        const auto c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x80)
+            break;
+        out[i - begin] = kASCIIToMSDTable[c];
+    }
+    return i;
+}
+
 // IMPORTANT:
 void MSDManager::ReadMSD(const void *pData)
 {
+    this->Clear();
+
     const MSDHeader *pHead = reinterpret_cast<const MSDHeader *>(pData);
     const uint8_t *pDataPtr = reinterpret_cast<const uint8_t *>(pData);
     for (uint32_t i = 0; i < pHead->numEntries; i++)
@@ -146,65 +398,183 @@ void MSDManager::ReadMSD(const void *pData)
     this->MakeDirty();
 }
 
-std::vector<uint16_t> MSDManager::CompileString(const std::string &str)
+void MSDManager::OverlayMSD(const void *pData)
 {
-    std::vector<uint16_t> result;
-    for (char c : str)
+    this->Clear();
+    const uint8_t *pDataPtr = reinterpret_cast<const uint8_t *>(pData);
+    const uint32_t count = reinterpret_cast<const MSDHeader *>(pData)->numEntries;
+    this->overlay = true;
+    this->baseOffsets.resize(count);
+    std::memcpy(this->baseOffsets.data(), pDataPtr + sizeof(uint32_t), count * sizeof(uint64_t));
+
+    if (count > 0)
     {
-        auto uc = static_cast<unsigned char>(c);
-        result.push_back(uc < kASCIIToMSDTable.size() ? kASCIIToMSDTable[uc] : UnsupportedChar);
+        // A string runs to its terminator, so the one starting last also ends last
+        const auto [first, last] = std::ranges::minmax(this->baseOffsets);
+        const uint16_t *pEnd = reinterpret_cast<const uint16_t *>(pDataPtr + last);
+        while ((*pEnd & 0xFF00) != 0x8000)
+        {
+            pEnd++;
+        }
+        this->base.assign(pDataPtr + first, reinterpret_cast<const uint8_t *>(pEnd + 1));
+        for (auto &offset : this->baseOffsets)
+        {
+            offset -= first;
+        }
     }
-    result.push_back(EndDialog);
+    this->MakeDirty();
+}
+
+void MSDManager::Clear()
+{
+    this->overlay = false;
+    this->base.clear();
+    this->baseOffsets.clear();
+    this->overrides.clear();
+    this->strings.clear();
+    this->compiledMSD.clear();
+    this->tableCapacity = 0;
+    this->usedBytes = 0;
+}
+
+std::vector<uint16_t> MSDManager::CompileString(const std::string &str)
+{
+    std::vector<uint16_t> result(CompiledLength(str));
+    result.resize(CompileStringInto(str, result));
     return result;
 }
 
+size_t MSDManager::CompileStringInto(std::string_view str, std::span<uint16_t> out)
+{
+    if (out.size() < CompiledLength(str))
+        return 0;
+
+    uint16_t *dst = out.data();
+    size_t i = 0;
+    while (i < str.size())
+    {
+        const size_t runEnd = writeASCIIRun(str, i, dst);
+        dst += runEnd - i;
+        i = runEnd;
+        if (i < str.size())
+            dst += writeCodePoint(decodeUTF8(str, i), dst);
+    }
+    *dst++ = EndDialog;
+    return static_cast<size_t>(dst - out.data());
+}
+
 uint32_t MSDManager::AddString(const std::string &str)
 {
+    const auto index = static_cast<uint32_t>(this->Size());
     this->strings.emplace_back(CompileString(str));
-    this->MakeDirty();
-    return static_cast<uint32_t>(this->strings.size() - 1);
+    if (!this->PatchInPlace(index, this->strings.back()))
+        this->MakeDirty();
+    return index;
 }
 
 void MSDManager::OverrideString(uint32_t index, const std::string &str)
 {
-    if (index >= this->strings.size())
+    if (index >= this->Size())
         return;
 
-    this->strings[index] = CompileString(str);
-    this->MakeDirty();
+    std::vector<uint16_t> &slot = this->OwnedSlot(index);
+    slot = CompileString(str);
+    if (!this->PatchInPlace(index, slot))
+        this->MakeDirty();
 }
 
 size_t MSDManager::Size() const
 {
-    return this->strings.size();
+    return this->baseOffsets.size() + this->strings.size();
 }
 
-void MSDManager::Rebuild()
+const uint16_t *MSDManager::GetString(uint32_t index) const
 {
-    uint32_t newSize = static_cast<uint32_t>(this->Size());
+    if (index >= this->Size())
+        return nullptr;
+    if (const auto *owned = this->OwnedString(index))
+        return owned->data();
+    return reinterpret_cast<const uint16_t *>(this->base.data() + this->baseOffsets[index]);
+}
 
-    this->compiledMSD.clear();
-    this->compiledMSD.reserve(sizeof(uint32_t) + newSize * sizeof(uint64_t) + newSize * sizeof(uint16_t));
+const std::vector<uint16_t> *MSDManager::OwnedString(uint32_t index) const
+{
+    if (index >= this->baseOffsets.size())
+        return &this->strings[index - this->baseOffsets.size()];
+    auto it = this->overrides.find(index);
+    return it != this->overrides.end() ? &it->second : nullptr;
+}
 
-    // Rebuild MSD header
-    this->compiledMSD.append(newSize);
+std::vector<uint16_t> &MSDManager::OwnedSlot(uint32_t index)
+{
+    if (index >= this->baseOffsets.size())
+        return this->strings[index - this->baseOffsets.size()];
+    return this->overrides[index];
+}
 
-    // Offsets
-    uint64_t offset = sizeof(uint32_t) + this->strings.size() * sizeof(uint64_t);
-    for (auto &str : this->strings)
-    {
-        this->compiledMSD.append(offset);
-        offset += str.size() * sizeof(uint16_t);
-    }
+void MSDManager::Rebuild()
+{
+    const size_t count = this->Size();
+    this->tableCapacity = count + (this->overlay ? kOverlaySpareEntries : 0);
 
-    // Strings
-    for (auto &str : this->strings)
-    {
-        this->compiledMSD.append_range(str);
-    }
+    this->compiledMSD.build(
+        [this, count](auto &out)
+        {
+            // MSD header
+            out.write(static_cast<uint32_t>(count));
+
+            // Offsets; the original's strings keep their layout, right after the table
+            const uint64_t baseStart = sizeof(uint32_t) + this->tableCapacity * sizeof(uint64_t);
+            uint64_t offset = baseStart + this->base.size();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (const auto *str = this->OwnedString(i))
+                {
+                    out.write(offset);
+                    offset += str->size() * sizeof(uint16_t);
+                }
+                else
+                {
+                    out.write(baseStart + this->baseOffsets[i]);
+                }
+            }
+            out.fill((this->tableCapacity - count) * sizeof(uint64_t));
+
+            // Strings
+            out.writeRange(this->base);
+            for (const auto &[index, str] : this->overrides)
+            {
+                out.writeRange(str);
+            }
+            for (const auto &str : this->strings)
+            {
+                out.writeRange(str);
+            }
+            out.fill(kSpareStringBytes);
+        });
+    this->usedBytes = this->compiledMSD.size() - kSpareStringBytes;
     this->dirty = false;
 }
 
+bool MSDManager::PatchInPlace(uint32_t index, const std::vector<uint16_t> &str)
+{
+    const size_t bytes = str.size() * sizeof(uint16_t);
+    if (this->dirty || this->compiledMSD.size() == 0 || index >= this->tableCapacity || bytes > this->compiledMSD.size() - this->usedBytes)
+        return false;
+
+    // String first, then its offset, then the count, so a reader never sees
+    // an offset to unwritten data
+    uint8_t *data = this->compiledMSD.bytes().data();
+    std::memcpy(data + this->usedBytes, str.data(), bytes);
+    const uint64_t offset = this->usedBytes;
+    std::memcpy(data + sizeof(uint32_t) + index * sizeof(uint64_t), &offset, sizeof(offset));
+    this->usedBytes += bytes;
+
+    const auto count = static_cast<uint32_t>(this->Size());
+    std::memcpy(data, &count, sizeof(count));
+    return true;
+}
+
 const uint8_t *MSDManager::GetData()
 {
     if (this->dirty)
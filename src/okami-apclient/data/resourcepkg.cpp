@@ -1,67 +1,195 @@
 #include "okami/resourcepkg.hpp"
 
 #include <algorithm>
-#include <fstream>
-#include <mutex>
+#include <cstring>
 #include <ranges>
+#include <system_error>
+#include <fstream>
 #include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "okami/blowfish.hpp"
+#include "okami/contenthash.hpp"
+#include "okami/serializer.hpp"
 
 namespace okami
 {
 
-// ---------------------------------------------------------------------------
-// Internal FileBuffer helper (not exposed in any public header)
-// ---------------------------------------------------------------------------
 namespace
 {
 
-class FileBuffer
+/// Shared by ResourcePackage and ResourcePackageWriter: entries are anything
+/// with a ResourceType `type` and a contiguous byte range `data`.
+template <typename Sink, typename Entries> void serializePackage(Sink &out, const Entries &entries)
+{
+    // numElems includes the ROF sentinel (+1)
+    const auto numElems = static_cast<uint32_t>(entries.size() + 1);
+    out.write(numElems);
+
+    // Calculate starting offset: after header counts + all offsets + all type tags
+    // Header layout: uint32_t numElems  +  numElems*uint32_t offsets  +  numElems*ResourceType tags
+    const uint32_t headerBytes = static_cast<uint32_t>((1 + numElems + numElems) * sizeof(uint32_t));
+
+    uint32_t offset = headerBytes;
+    for (const auto &entry : entries)
+    {
+        out.write(offset);
+        offset += static_cast<uint32_t>(entry.data.size());
+    }
+    // ROF sentinel offset
+    out.write(offset);
+
+    // Type tags for all entries
+    for (const auto &entry : entries)
+        out.write(entry.type);
+    // ROF sentinel type tag
+    out.write(ResourceType{'R', 'O', 'F', '\0'});
+
+    // Raw data blobs
+    for (const auto &entry : entries)
+        out.writeRange(entry.data);
+
+    // ROF section: 8-byte magic + 64-bit offsets (same values as the header)
+    constexpr std::string_view rofHead = "RUNOFS64";
+    out.writeRange(rofHead);
+    uint64_t offset64 = headerBytes;
+    for (const auto &entry : entries)
+    {
+        out.write(offset64);
+        offset64 += entry.data.size();
+    }
+    out.write(offset64);
+
+    // Pad to 32-byte boundary
+    out.padTo(32);
+}
+
+/// Index of an entry with this type and data, or entries.size(). Entries added
+/// since the last call are hashed into byHash first, so plain addEntry() calls
+/// cost nothing until a unique entry is asked for.
+template <typename Entries>
+std::size_t findDuplicate(const Entries &entries, std::unordered_multimap<uint64_t, std::size_t> &byHash, std::size_t &hashed, ResourceType type,
+                          std::span<const uint8_t> data, uint64_t hash)
+{
+    for (; hashed < entries.size(); ++hashed)
+        byHash.emplace(contentHash(entries[hashed].data), hashed);
+
+    const auto [first, last] = byHash.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        const auto &entry = entries[it->second];
+        if (entry.type == type && std::ranges::equal(entry.data, data))
+            return it->second;
+    }
+    return entries.size();
+}
+
+/// Serializer sink that encrypts and writes whole chunks as they fill up.
+/// Chunks are block-aligned, so the ciphertext matches encrypting the whole
+/// image at once.
+class EncryptingFileSink
 {
   public:
-    void append(const auto &value)
+    EncryptingFileSink(std::ofstream &file, std::size_t chunkBytes) : m_file(file), m_chunk(chunkBytes)
     {
-        const auto *p = reinterpret_cast<const uint8_t *>(&value);
-        m_buf.insert(m_buf.end(), p, p + sizeof(value));
     }
 
-    void append_range(const std::ranges::range auto &container)
+    template <ByteCopyable T> void write(const T &value)
     {
-        std::ranges::for_each(container, [this](const auto &v) { append(v); });
+        writeBytes(&value, sizeof(T));
     }
 
-    void append_bytes(std::size_t count, uint8_t value = 0)
+    template <std::ranges::contiguous_range R> void writeRange(const R &range)
     {
-        m_buf.insert(m_buf.end(), count, value);
+        writeBytes(std::ranges::data(range), std::ranges::size(range) * sizeof(std::ranges::range_value_t<R>));
     }
 
-    [[nodiscard]] std::size_t size() const noexcept
+    void fill(std::size_t count, uint8_t value = 0)
     {
-        return m_buf.size();
+        while (count > 0)
+        {
+            const std::size_t n = std::min(count, m_chunk.size() - m_used);
+            std::memset(m_chunk.data() + m_used, value, n);
+            advance(n);
+            count -= n;
+        }
     }
 
-    [[nodiscard]] const uint8_t *data() const noexcept
+    void padTo(std::size_t alignment, uint8_t value = 0)
     {
-        return m_buf.data();
+        if (const std::size_t rem = m_written % alignment; rem != 0)
+            fill(alignment - rem, value);
     }
 
-    [[nodiscard]] std::vector<uint8_t> &get_buffer() noexcept
+    /// Encrypt and write whatever is buffered. Returns false on any write failure.
+    bool finish()
     {
-        return m_buf;
+        flush();
+        return m_file.good();
     }
 
   private:
-    std::vector<uint8_t> m_buf;
+    void writeBytes(const void *src, std::size_t count)
+    {
+        const auto *bytes = static_cast<const uint8_t *>(src);
+        while (count > 0)
+        {
+            const std::size_t n = std::min(count, m_chunk.size() - m_used);
+            std::memcpy(m_chunk.data() + m_used, bytes, n);
+            advance(n);
+            bytes += n;
+            count -= n;
+        }
+    }
+
+    void advance(std::size_t n)
+    {
+        m_used += n;
+        m_written += n;
+        if (m_used == m_chunk.size())
+            flush();
+    }
+
+    void flush()
+    {
+        if (m_used == 0)
+            return;
+        const std::span<uint8_t> chunk{m_chunk.data(), m_used};
+        Nippon::okamiCipher().encrypt(chunk);
+        m_file.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        m_used = 0;
+    }
+
+    std::ofstream &m_file;
+    std::vector<uint8_t> m_chunk;
+    std::size_t m_used = 0;    // bytes buffered in m_chunk
+    std::size_t m_written = 0; // bytes serialized so far, for padTo
 };
 
-// Ensure BlowFish::Create is called exactly once with the Okami cipher key.
-void ensureBlowfishReady()
+/// Create parent directories and open filename for binary output.
+bool openForWrite(const std::filesystem::path &filename, std::ofstream &out)
 {
-    static std::once_flag s_flag;
-    std::call_once(s_flag, []() { Nippon::BlowFish::Create(std::string(Nippon::kCipherKey)); });
+    std::error_code ec;
+    std::filesystem::create_directories(filename.parent_path(), ec);
+    if (ec)
+        return false;
+    out.open(filename, std::ios::binary);
+    return out.is_open();
 }
 
 } // anonymous namespace
@@ -75,15 +203,39 @@ void ResourcePackage::addEntry(ResourceType type, std::span<const uint8_t> data)
     m_entries.push_back({type, std::vector<uint8_t>(data.begin(), data.end())});
 }
 
+std::size_t ResourcePackage::addUniqueEntry(ResourceType type, std::span<const uint8_t> data)
+{
+    const uint64_t hash = contentHash(data);
+    if (const std::size_t index = findDuplicate(m_entries, m_byHash, m_hashed, type, data, hash); index < m_entries.size())
+        return index;
+
+    addEntry(type, data);
+    m_byHash.emplace(hash, m_hashed++);
+    return m_entries.size() - 1;
+}
+
 void ResourcePackage::addBlank()
 {
     m_entries.push_back({ResourceType{}, {}});
 }
 
-bool ResourcePackage::write(const std::filesystem::path &filename) const
+template <typename Sink> void ResourcePackage::serialize(Sink &out) const
+{
+    serializePackage(out, m_entries);
+}
+
+std::size_t ResourcePackage::serializedSize() const
+{
+    return okami::serializedSize([this](auto &out) { serialize(out); });
+}
+
+std::size_t ResourcePackage::serializeInto(std::span<uint8_t> out) const
 {
-    ensureBlowfishReady();
+    return okami::serializeInto(out, [this](auto &sink) { serialize(sink); });
+}
 
+bool ResourcePackage::write(const std::filesystem::path &filename) const
+{
     try
     {
         std::filesystem::create_directories(filename.parent_path());
@@ -93,63 +245,74 @@ bool ResourcePackage::write(const std::filesystem::path &filename) const
         return false;
     }
 
-    FileBuffer result;
-
-    // numElems includes the ROF sentinel (+1)
-    const auto numElems = static_cast<uint32_t>(m_entries.size() + 1);
-    result.append(numElems);
-
-    // Calculate starting offset: after header counts + all offsets + all type tags
-    // Header layout: uint32_t numElems  +  numElems*uint32_t offsets  +  numElems*ResourceType tags
-    const uint32_t headerBytes = static_cast<uint32_t>((1 + numElems + numElems) * sizeof(uint32_t));
+    ByteBuffer result;
+    result.build([this](auto &out) { serialize(out); });
 
-    std::vector<uint32_t> entryOffsets;
-    entryOffsets.reserve(numElems);
+    // Encrypt in-place
+    Nippon::okamiCipher().encrypt(result.bytes());
 
-    uint32_t offset = headerBytes;
-    for (const auto &entry : m_entries)
+    // Write to disk
+    try
     {
-        entryOffsets.push_back(offset);
-        result.append(offset);
-        offset += static_cast<uint32_t>(entry.data.size());
+        std::ofstream out{filename, std::ios::binary};
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char *>(result.data()), static_cast<std::streamsize>(result.size()));
+        return out.good();
     }
-    // ROF sentinel offset
-    entryOffsets.push_back(offset);
-    result.append(offset);
+    catch (...)
+    {
+        return false;
+    }
+}
 
-    // Type tags for all entries
-    std::ranges::for_each(m_entries, [&result](const Entry &e) { result.append(e.type); });
-    // ROF sentinel type tag
-    result.append(ResourceType{'R', 'O', 'F', '\0'});
+// ---------------------------------------------------------------------------
+// ResourcePackageWriter implementation
+// ---------------------------------------------------------------------------
 
-    // Raw data blobs
-    std::ranges::for_each(m_entries, [&result](const Entry &e) { result.append_range(e.data); });
-
-    // ROF section: 8-byte magic + 64-bit offsets
-    const std::string rofHead = "RUNOFS64";
-    result.append_range(rofHead);
-    std::ranges::for_each(entryOffsets,
-                          [&result](uint32_t o)
-                          {
-                              const uint64_t o64 = o;
-                              result.append(o64);
-                          });
+void ResourcePackageWriter::addEntry(ResourceType type, std::span<const uint8_t> data)
+{
+    m_entries.push_back({type, data});
+}
 
-    // Pad to 32-byte boundary
-    if (const std::size_t rem = result.size() % 32; rem != 0)
-        result.append_bytes(32 - rem);
+void ResourcePackageWriter::addEntry(ResourceType type, std::vector<uint8_t> &&data)
+{
+    m_owned.push_back(std::move(data));
+    m_entries.push_back({type, m_owned.back()});
+}
 
-    // Encrypt in-place
-    Nippon::BlowFish::Encrypt(result.get_buffer());
+std::size_t ResourcePackageWriter::addUniqueEntry(ResourceType type, std::span<const uint8_t> data)
+{
+    const uint64_t hash = contentHash(data);
+    if (const std::size_t index = findDuplicate(m_entries, m_byHash, m_hashed, type, data, hash); index < m_entries.size())
+        return index;
 
-    // Write to disk
+    addEntry(type, data);
+    m_byHash.emplace(hash, m_hashed++);
+    return m_entries.size() - 1;
+}
+
+void ResourcePackageWriter::addBlank()
+{
+    m_entries.push_back({ResourceType{}, {}});
+}
+
+std::size_t ResourcePackageWriter::serializedSize() const
+{
+    return okami::serializedSize([this](auto &out) { serializePackage(out, m_entries); });
+}
+
+bool ResourcePackageWriter::write(const std::filesystem::path &filename) const
+{
     try
     {
-        std::ofstream out{filename, std::ios::binary};
-        if (!out)
+        std::ofstream out;
+        if (!openForWrite(filename, out))
             return false;
-        out.write(reinterpret_cast<const char *>(result.data()), static_cast<std::streamsize>(result.size()));
-        return out.good();
+
+        EncryptingFileSink sink{out, kChunkBytes};
+        serializePackage(sink, m_entries);
+        return sink.finish();
     }
     catch (...)
     {
@@ -157,4 +320,190 @@ bool ResourcePackage::write(const std::filesystem::path &filename) const
     }
 }
 
+// ---------------------------------------------------------------------------
+// ResourcePackageReader implementation
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+/// Map a whole file copy-on-write: writes land in private pages, never the file.
+std::span<uint8_t> mapPrivate(const std::filesystem::path &filename)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return {};
+
+    LARGE_INTEGER size{};
+    void *view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        // The view keeps the mapping alive; neither handle is needed afterwards
+        if (HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+        {
+            view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    if (!view)
+        return {};
+    return {static_cast<uint8_t *>(view), static_cast<std::size_t>(size.QuadPart)};
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return {};
+
+    struct stat st{};
+    void *view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return {};
+    return {static_cast<uint8_t *>(view), static_cast<std::size_t>(st.st_size)};
+#endif
+}
+
+void unmap(std::span<uint8_t> view) noexcept
+{
+#ifdef _WIN32
+    UnmapViewOfFile(view.data());
+#else
+    munmap(view.data(), view.size());
+#endif
+}
+
+} // anonymous namespace
+
+ResourcePackageReader::~ResourcePackageReader()
+{
+    close();
+}
+
+ResourcePackageReader::ResourcePackageReader(ResourcePackageReader &&other) noexcept
+    : m_view(std::exchange(other.m_view, {})), m_count(std::exchange(other.m_count, 0)), m_decrypted(std::move(other.m_decrypted)),
+      m_decryptedBlocks(std::exchange(other.m_decryptedBlocks, 0))
+{
+    other.m_decrypted.clear();
+}
+
+ResourcePackageReader &ResourcePackageReader::operator=(ResourcePackageReader &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_view = std::exchange(other.m_view, {});
+        m_count = std::exchange(other.m_count, 0);
+        m_decrypted = std::move(other.m_decrypted);
+        m_decryptedBlocks = std::exchange(other.m_decryptedBlocks, 0);
+        other.m_decrypted.clear();
+    }
+    return *this;
+}
+
+bool ResourcePackageReader::open(const std::filesystem::path &filename)
+{
+    close();
+
+    m_view = mapPrivate(filename);
+    if (m_view.size() < sizeof(uint32_t))
+    {
+        close();
+        return false;
+    }
+    m_decrypted.assign((m_view.size() / 8 + 63) / 64, 0);
+
+    // The entry count tells us how far the header reaches
+    decryptRange(0, sizeof(uint32_t));
+    uint32_t numElems = 0;
+    std::memcpy(&numElems, m_view.data(), sizeof(numElems));
+
+    const std::size_t hdrSize = sizeof(uint32_t)                                             // numElems
+                                + static_cast<std::size_t>(numElems) * sizeof(uint32_t)      // offsets[]
+                                + static_cast<std::size_t>(numElems) * sizeof(ResourceType); // type tags[]
+    if (numElems < 1 || hdrSize > m_view.size())
+    {
+        close();
+        return false;
+    }
+    decryptRange(0, hdrSize);
+    m_count = numElems - 1; // ROF sentinel is the last element
+
+    // Reject offsets outside the file up front so entry() can't be steered out of the mapping
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+        if (offset(i) > offset(i + 1) || offset(i + 1) > m_view.size())
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ResourcePackageReader::close() noexcept
+{
+    if (!m_view.empty())
+        unmap(m_view);
+    m_view = {};
+    m_count = 0;
+    m_decrypted.clear();
+    m_decryptedBlocks = 0;
+}
+
+uint32_t ResourcePackageReader::offset(std::size_t index) const noexcept
+{
+    uint32_t value = 0;
+    std::memcpy(&value, m_view.data() + sizeof(uint32_t) + index * sizeof(uint32_t), sizeof(value));
+    return value;
+}
+
+ResourceType ResourcePackageReader::type(std::size_t index) const noexcept
+{
+    ResourceType tag{};
+    if (index < m_count)
+        std::memcpy(&tag, m_view.data() + sizeof(uint32_t) + (m_count + 1) * sizeof(uint32_t) + index * sizeof(ResourceType), sizeof(tag));
+    return tag;
+}
+
+std::span<uint8_t> ResourcePackageReader::entry(std::size_t index)
+{
+    if (index >= m_count)
+        return {};
+    const std::size_t begin = offset(index);
+    const std::size_t end = offset(index + 1);
+    decryptRange(begin, end);
+    return m_view.subspan(begin, end - begin);
+}
+
+void ResourcePackageReader::decryptRange(std::size_t begin, std::size_t end)
+{
+    // Blocks straddling the range edges may be shared with neighbouring entries,
+    // so each block's bit makes sure it is decrypted exactly once. Bytes past the
+    // last whole block were never encrypted.
+    const std::size_t lastBlock = std::min((end + 7) / 8, m_view.size() / 8);
+    std::size_t block = begin / 8;
+    while (block < lastBlock)
+    {
+        if (m_decrypted[block / 64] & (1ull << (block % 64)))
+        {
+            ++block;
+            continue;
+        }
+
+        // Decrypt the whole run of still-encrypted blocks in one call
+        std::size_t runEnd = block;
+        while (runEnd < lastBlock && !(m_decrypted[runEnd / 64] & (1ull << (runEnd % 64))))
+        {
+            m_decrypted[runEnd / 64] |= 1ull << (runEnd % 64);
+            ++runEnd;
+        }
+        Nippon::okamiCipher().decrypt(m_view.subspan(block * 8, (runEnd - block) * 8));
+        m_decryptedBlocks += runEnd - block;
+        block = runEnd;
+    }
+}
+
 } // namespace okami
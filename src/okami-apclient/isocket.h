@@ -24,6 +24,8 @@ struct ScoutedItem
 class ISocket
 {
   public:
+    using ScoutReplyCallback = std::function<void(std::vector<ScoutedItem> items)>;
+
     virtual ~ISocket() = default;
 
     // Connection management
@@ -48,9 +50,26 @@ class ISocket
     // Location scouting
     virtual bool scoutLocations(const std::list<int64_t> &locations, int createAsHint) = 0;
 
+    /**
+     * @brief Scout locations without waiting for the reply
+     *
+     * Sends LocationScouts and returns. onReply is called exactly once, on
+     * the game thread from processMainThreadTasks() after the poll() that
+     * received the reply. It gets an empty vector if nothing valid was
+     * scouted, the request could not be sent, or the connection dropped.
+     *
+     * @param locations List of location IDs to scout
+     * @param createAsHint Hint creation mode (0=none, 1=create, 2=create_no_send)
+     * @param onReply Receives the scouted items
+     */
+    virtual void scoutLocationsAsync(const std::list<int64_t> &locations, int createAsHint, ScoutReplyCallback onReply) = 0;
+
     /**
      * @brief Scout locations synchronously (blocking)
      *
+     * Pumps poll() until the reply arrives, so call it only from the game
+     * thread, and only where the caller cannot continue without the result.
+     *
      * @param locations List of location IDs to scout
      * @param createAsHint Hint creation mode (0=none, 1=create, 2=create_no_send)
      * @param timeout Maximum time to wait for response
@@ -6,7 +6,6 @@
 #include <cstring>
 #include <filesystem>
 #include <string>
-#include <unordered_map>
 
 #include <okami/msd.h>
 
@@ -18,6 +17,7 @@
 #include "checks/check_types.hpp"
 #include "gamestate_accessors.hpp"
 #include "okami/itemtype.hpp"
+#include "scouted_names.hpp"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -51,17 +51,17 @@ static LoadItemModelFn s_origLoadItemModel = nullptr;
 
 static void **s_ppCore20MSD = nullptr;
 static okami::MSDManager s_msdManager;
+static const void *s_patchedCore20MSD = nullptr; // our output, as handed to the game
 
-// 0-based index of the first custom entry in the combined icon package.
-// -1 means the combined package was not built (icons will fall through to vanilla).
-static int s_customIconBase = -1;
+// Where each kIconEntries row's icon sits in the combined icon package.
+// Not ready means the package was not built (icons fall through to vanilla).
+static okami::customiconpkg::CombinedPackage s_iconPackage;
+static bool s_iconPackageReady = false;
 
 constexpr int16_t kCustomStringBase = 0x1000;
-// Key: virtual index. Value: encoded UTF-16 string.
-// std::unordered_map guarantees reference stability on insert — data() pointers remain valid.
-static std::unordered_map<int16_t, std::vector<uint16_t>> s_customStrings;
-static std::unordered_map<int64_t, int16_t> s_locationIndex;
-static int16_t s_nextCustomIndex = kCustomStringBase;
+// Scouted names; ordinal i is served as virtual string index kCustomStringBase + i.
+static ScoutedNamePool s_scoutedNames(static_cast<size_t>(INT16_MAX - kCustomStringBase));
+static std::string s_scoutedNameSession;
 static int s_currentShopId = -1;
 static int64_t s_currentContainerLocation = -1;
 static void *s_pCurrentShop = nullptr;
@@ -81,6 +81,14 @@ static std::filesystem::path getModDir()
 #endif
 }
 
+/// Compiled string for a virtual index, or nullptr if none is registered.
+static const uint16_t *findCustomString(int16_t idx)
+{
+    if (idx < kCustomStringBase)
+        return nullptr;
+    return s_scoutedNames.at(static_cast<size_t>(idx - kCustomStringBase));
+}
+
 static int64_t __fastcall hookGetNumEntries(void *pMgr, int32_t texGroup)
 {
     if (texGroup == 4)
@@ -93,7 +101,7 @@ static void *__fastcall hookLoadRscPkgAsync(void *pFs, const char *pszFilename,
 {
     // Redirect the vanilla icon package to our combined package (single async load —
     // adding a second pending load hangs the game indefinitely).
-    if (pszFilename && std::strcmp(pszFilename, "id/ItemShopBuyIcon.dat") == 0 && s_customIconBase >= 0)
+    if (pszFilename && std::strcmp(pszFilename, "id/ItemShopBuyIcon.dat") == 0 && s_iconPackageReady)
     {
         wolf::logDebug("[itempatch] Icon package redirected: id/ItemShopBuyIcon.dat -> %s", okami::customiconpkg::kPackageResourceName.data());
         return s_origLoadRscPkgAsync(pFs, okami::customiconpkg::kPackageResourceName.data(), pOutputRscData, pHeap, a5, a6, a7, a8);
@@ -104,18 +112,17 @@ static void *__fastcall hookLoadRscPkgAsync(void *pFs, const char *pszFilename,
 static hx::Texture *__fastcall hookGetItemIcon(okami::cItemShop *pShop, int item)
 {
     // When the combined package is loaded, pShop->pIconsRsc IS the combined package.
-    // Custom entries occupy indices s_customIconBase..s_customIconBase+kIconEntries.size()-1.
-    if (s_customIconBase >= 0 && pShop->pIconsRsc)
+    // Custom items map to their icon's entry through s_iconPackage.iconIndex.
+    if (s_iconPackageReady && pShop->pIconsRsc)
     {
-        for (int i = 0; i < static_cast<int>(okami::customiconpkg::kIconEntries.size()); ++i)
+        if (const int entry = okami::customiconpkg::iconEntryIndex(item); entry >= 0)
         {
-            if (okami::customiconpkg::kIconEntries[static_cast<size_t>(i)].itemType == item)
-            {
-                auto *tex = static_cast<hx::Texture *>(s_loadRscIdx(pShop->pIconsRsc, static_cast<uint32_t>(s_customIconBase + i)));
-                if (tex)
-                    return tex;
-                break; // entry found but texture not ready; fall through to vanilla
-            }
+            // +1: s_loadRscIdx is 1-based
+            const auto index = static_cast<uint32_t>(s_iconPackage.iconIndex[static_cast<size_t>(entry)]) + 1;
+            auto *tex = static_cast<hx::Texture *>(s_loadRscIdx(pShop->pIconsRsc, index));
+            if (tex)
+                return tex;
+            // entry found but texture not ready; fall through to vanilla
         }
     }
 
@@ -124,26 +131,6 @@ static hx::Texture *__fastcall hookGetItemIcon(okami::cItemShop *pShop, int item
     return s_origGetItemIcon(pShop, item);
 }
 
-/// Returns true if the given MSD string index corresponds to an AP dummy item
-/// for both the shop list (itemType + 294) and info panel (itemType + 0x2000)
-/// paths. Both resolve to the selected slot's scouted name, so items sharing
-/// a dummy type will all show the selected item's name in the list. The info
-/// panel always shows the correct name since it displays the selected item.
-static constexpr bool isApDummyStrId(uint16_t index)
-{
-    constexpr uint16_t kListBase = 294;
-    constexpr uint16_t kInfoPanelBase = 0x2000;
-    constexpr auto kDummyTypes = std::to_array<uint16_t>({
-        okami::ItemTypes::ForeignStandardItem,
-        okami::ItemTypes::ForeignProgressionItem,
-        okami::ItemTypes::ForeignTrapItem,
-        okami::ItemTypes::OkamiStandardItem,
-        okami::ItemTypes::OkamiProgressionItem,
-        okami::ItemTypes::OkamiTrapItem,
-    });
-    return std::ranges::any_of(kDummyTypes, [&](uint16_t t) { return index == t + kListBase || index == t + kInfoPanelBase; });
-}
-
 static void __fastcall hookLoadCore20MSD(void *pMsgStruct)
 {
     s_origLoadCore20MSD(pMsgStruct);
@@ -153,9 +140,14 @@ static void __fastcall hookLoadCore20MSD(void *pMsgStruct)
         wolf::logWarning("[itempatch] hookLoadCore20MSD: ppCore20MSD is null, skipping patch");
         return;
     }
+    if (*s_ppCore20MSD == s_patchedCore20MSD)
+        return; // still our patched file; resetting the manager would free it under the game
 
+    // Copy the game's strings as one block instead of string by string. The
+    // patched file owns everything it points at, so the game may free or
+    // reuse its own buffer afterwards.
     s_msdManager = okami::MSDManager{};
-    s_msdManager.ReadMSD(*s_ppCore20MSD);
+    s_msdManager.OverlayMSD(*s_ppCore20MSD);
 
     // Override strings for items missing from vanilla MSD
     constexpr uint32_t ItemStrBaseID = 294; // magic
@@ -179,6 +171,7 @@ static void __fastcall hookLoadCore20MSD(void *pMsgStruct)
 
     // Redirect MSD data pointer to our patched version
     *s_ppCore20MSD = const_cast<uint8_t *>(s_msdManager.GetData());
+    s_patchedCore20MSD = *s_ppCore20MSD;
 
     wolf::logInfo("[itempatch] Core20MSD patched: %zu strings", s_msdManager.Size());
 }
@@ -189,13 +182,8 @@ const uint16_t *resolveApItemName(uint16_t strId)
     // s_currentContainerLocation is set to the location being shown.
     if (s_currentContainerLocation >= 0 && isApDummyStrId(strId))
     {
-        auto locIt = s_locationIndex.find(s_currentContainerLocation);
-        if (locIt != s_locationIndex.end())
-        {
-            auto strIt = s_customStrings.find(locIt->second);
-            if (strIt != s_customStrings.end())
-                return strIt->second.data();
-        }
+        if (const uint16_t *name = s_scoutedNames.find(s_currentContainerLocation))
+            return name;
     }
 
     // Resolve per-slot custom AP item names from the current shop context.
@@ -207,14 +195,7 @@ const uint16_t *resolveApItemName(uint16_t strId)
         // Offsets validated against decompiled FUN_18043ca30 (cItemShop::PurchaseItem)
         auto *shopBase = reinterpret_cast<uint8_t *>(s_pCurrentShop);
         int selectedSlot = shopBase[0x8A] + shopBase[0x8B];
-        int64_t locationId = checks::getShopCheckId(s_currentShopId, selectedSlot);
-        auto locIt = s_locationIndex.find(locationId);
-        if (locIt != s_locationIndex.end())
-        {
-            auto strIt = s_customStrings.find(locIt->second);
-            if (strIt != s_customStrings.end())
-                return strIt->second.data();
-        }
+        return s_scoutedNames.find(checks::getShopCheckId(s_currentShopId, selectedSlot));
     }
     return nullptr;
 }
@@ -238,11 +219,10 @@ static const uint16_t *__fastcall hookGetMSDString(void *pBase, uint16_t index)
     }
 
     // Virtual string table (for other possible uses)
-    if (index >= static_cast<uint16_t>(kCustomStringBase))
+    if (index >= static_cast<uint16_t>(kCustomStringBase) && index <= static_cast<uint16_t>(INT16_MAX))
     {
-        auto it = s_customStrings.find(static_cast<int16_t>(index));
-        if (it != s_customStrings.end())
-            return it->second.data();
+        if (const uint16_t *custom = findCustomString(static_cast<int16_t>(index)))
+            return custom;
     }
     return s_origGetMSDString(pBase, index);
 }
@@ -251,23 +231,10 @@ static void __fastcall hookBuildItemResourceName(void *param_1, int item_type, u
 {
     // If item_id matches an AP dummy type, redirect to chestnut (0x83) to avoid
     // a crash from loading a non-existent resource file.
-    constexpr uint8_t kDummyIds[] = {
-        static_cast<uint8_t>(okami::ItemTypes::ForeignStandardItem),    // 0x78
-        static_cast<uint8_t>(okami::ItemTypes::ForeignProgressionItem), // 0x82
-        static_cast<uint8_t>(okami::ItemTypes::ForeignTrapItem),        // 0xAF
-        static_cast<uint8_t>(okami::ItemTypes::OkamiStandardItem),      // 0xA2
-        static_cast<uint8_t>(okami::ItemTypes::OkamiProgressionItem),   // 0xA8
-        static_cast<uint8_t>(okami::ItemTypes::OkamiTrapItem),          // 0xAC
-    };
-
-    for (uint8_t dummyId : kDummyIds)
+    if (okami::ItemTypes::kIsApDummyItem[static_cast<uint8_t>(item_id)])
     {
-        if (static_cast<uint8_t>(item_id) == dummyId)
-        {
-            // Redirect to chestnut model (0x83) to avoid missing resource crash
-            s_origBuildItemResourceName(param_1, item_type, 0x83, output);
-            return;
-        }
+        s_origBuildItemResourceName(param_1, item_type, 0x83, output);
+        return;
     }
 
     s_origBuildItemResourceName(param_1, item_type, item_id, output);
@@ -327,28 +294,47 @@ void clearContainerContext()
 
 void resetState()
 {
-    s_customStrings.clear();
-    s_locationIndex.clear();
-    s_nextCustomIndex = kCustomStringBase;
+    resetScoutedNames();
     clearShopContext();
     clearContainerContext();
 }
 
+void resetScoutedNames()
+{
+    s_scoutedNames.reset();
+    s_scoutedNameSession.clear();
+}
+
+void beginScoutedNameSession(const std::string &sessionKey)
+{
+    if (sessionKey == s_scoutedNameSession)
+        return;
+    if (s_scoutedNames.size() > 0)
+        wolf::logInfo("[itempatch] New scouting session; dropping %zu scouted names", s_scoutedNames.size());
+    s_scoutedNames.reset();
+    s_scoutedNameSession = sessionKey;
+}
+
 void registerScoutedItemName(int64_t locationId, const std::string &name)
 {
-    if (s_nextCustomIndex >= INT16_MAX)
+    if (s_scoutedNames.size() >= s_scoutedNames.maxNames())
     {
         wolf::logError("[itempatch] Custom string index overflow — too many scouted items registered");
         return;
     }
 
-    if (s_locationIndex.contains(locationId))
-        return; // idempotent
+    if (s_scoutedNames.add(locationId, name))
+        wolf::logDebug("[itempatch] Registered '%s' for loc %lld -> virtual idx 0x%04X", name.c_str(), locationId,
+                       static_cast<uint16_t>(kCustomStringBase + s_scoutedNames.size() - 1));
+}
 
-    int16_t idx = s_nextCustomIndex++;
-    s_customStrings[idx] = okami::MSDManager::CompileString(name);
-    s_locationIndex[locationId] = idx;
-    wolf::logDebug("[itempatch] Registered '%s' for loc %lld -> virtual idx 0x%04X", name.c_str(), locationId, static_cast<uint16_t>(idx));
+void registerScoutedItemNames(std::span<const std::pair<int64_t, std::string>> names)
+{
+    const size_t added = s_scoutedNames.addBatch(names);
+    if (added < names.size() && s_scoutedNames.size() >= s_scoutedNames.maxNames())
+        wolf::logError("[itempatch] Custom string index overflow — too many scouted items registered");
+    if (added > 0)
+        wolf::logDebug("[itempatch] Registered %zu scouted names (%zu total)", added, s_scoutedNames.size());
 }
 
 void initializeEarly()
@@ -369,12 +355,11 @@ void initializeEarly()
     if (!std::filesystem::exists(vanillaPath))
         vanillaPath = std::filesystem::current_path() / "data_pc" / "id" / "ItemShopBuyIcon.dat";
 
-    int vanillaCount = 0;
-    if (okami::customiconpkg::buildCombinedFromFiles(cwdPkgPath, vanillaPath, standardPath, progressionPath, trapPath, vanillaCount))
+    if (okami::customiconpkg::buildCombinedFromFiles(cwdPkgPath, vanillaPath, standardPath, progressionPath, trapPath, s_iconPackage))
     {
-        s_customIconBase = vanillaCount + 1; // +1: s_loadRscIdx is 1-based
-        wolf::logInfo("[itempatch] Combined icon package built: %s (vanilla: %d, custom: %zu)", cwdPkgPath.string().c_str(), vanillaCount,
-                      okami::customiconpkg::kIconEntries.size());
+        s_iconPackageReady = true;
+        wolf::logInfo("[itempatch] Combined icon package ready: %s (vanilla: %d, custom: %d for %zu items)", cwdPkgPath.string().c_str(),
+                      s_iconPackage.vanillaCount, s_iconPackage.iconCount, okami::customiconpkg::kIconEntries.size());
     }
     else
     {
@@ -411,13 +396,7 @@ void initialize()
     {
         constexpr uintptr_t kItemFlagsTableOffset = 0x7ab224;
         constexpr uint32_t kCollectableFlags = 0x41; // bit 0 + bit 6
-        constexpr uint8_t kDummyItemIds[] = {
-            static_cast<uint8_t>(okami::ItemTypes::ForeignStandardItem),  static_cast<uint8_t>(okami::ItemTypes::ForeignProgressionItem),
-            static_cast<uint8_t>(okami::ItemTypes::ForeignTrapItem),      static_cast<uint8_t>(okami::ItemTypes::OkamiStandardItem),
-            static_cast<uint8_t>(okami::ItemTypes::OkamiProgressionItem), static_cast<uint8_t>(okami::ItemTypes::OkamiTrapItem),
-        };
-
-        for (uint8_t id : kDummyItemIds)
+        for (uint8_t id : okami::ItemTypes::kApDummyItems)
         {
             // Each table entry = 3 × uint32_t (12 bytes); flags is the first uint32.
             uintptr_t flagsAddr = mainBase + kItemFlagsTableOffset + static_cast<uintptr_t>(id) * 12;
@@ -467,15 +446,9 @@ void patchItemParams()
     }
 
     // AP dummy item types: distinct categories for icon colors, max 1 per shop slot
-    constexpr auto kDummyItems = std::to_array({
-        okami::ItemTypes::ForeignStandardItem,
-        okami::ItemTypes::ForeignProgressionItem,
-        okami::ItemTypes::ForeignTrapItem,
-        okami::ItemTypes::OkamiStandardItem,
-        okami::ItemTypes::OkamiProgressionItem,
-        okami::ItemTypes::OkamiTrapItem,
-    });
+    constexpr auto &kDummyItems = okami::ItemTypes::kApDummyItems;
     constexpr uint8_t kDummyCategories[] = {1, 3, 4, 1, 3, 4};
+    static_assert(std::size(kDummyCategories) == kDummyItems.size());
     for (size_t i = 0; i < kDummyItems.size(); ++i)
     {
         params.at(kDummyItems[i]).category = kDummyCategories[i];
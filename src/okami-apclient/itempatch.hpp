@@ -1,7 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
+#include <utility>
+
+#include <okami/itemtype.hpp>
 
 namespace itempatch
 {
@@ -29,6 +33,34 @@ void setCurrentShopId(int shopId);
 /// Safe to call at any time — no dependency on MSD load state.
 void registerScoutedItemName(int64_t locationId, const std::string &name);
 
+/// Register a batch of scouted item names in one pass (one index merge).
+/// Same rules as registerScoutedItemName; within a batch the first name for a
+/// location wins.
+void registerScoutedItemNames(std::span<const std::pair<int64_t, std::string>> names);
+
+/// Forget every scouted name in one step. Arena and index capacity are kept
+/// for the next session.
+void resetScoutedNames();
+
+/// Start a scouting session (seed and slot). Switching to a different session
+/// resets the scouted names; reconnecting to the same one keeps them, so items
+/// already on screen keep their names.
+void beginScoutedNameSession(const std::string &sessionKey);
+
+/// Returns true if the given MSD string index corresponds to an AP dummy item
+/// for both the shop list (itemType + 294) and info panel (itemType + 0x2000)
+/// paths. Both resolve to the selected slot's scouted name, so items sharing
+/// a dummy type will all show the selected item's name in the list. The info
+/// panel always shows the correct name since it displays the selected item.
+/// The two ranges don't overlap, so this is one table load.
+constexpr bool isApDummyStrId(uint16_t index)
+{
+    constexpr uint16_t kListBase = 294;
+    constexpr uint16_t kInfoPanelBase = 0x2000;
+    const unsigned itemId = index >= kInfoPanelBase ? index - kInfoPanelBase : static_cast<unsigned>(index - kListBase);
+    return okami::ItemTypes::IsApDummyItem(itemId);
+}
+
 /// Resolve an AP dummy item's per-slot custom name from the current shop context.
 /// Returns the compiled MSD string for the selected slot's scouted item, or
 /// nullptr if the strId is not an AP dummy item or no custom name is registered.
@@ -0,0 +1,63 @@
+#include "lifecycle.h"
+
+#include <algorithm>
+
+#include <wolf_framework.hpp>
+
+namespace lifecycle
+{
+
+namespace
+{
+
+// Intentionally leaked: subscriptions held by other statics may be released
+// during static destruction, after a plain global here would be gone.
+detail::Channels &g_channels = *new detail::Channels();
+detail::SubscriptionId g_nextId = 1;
+uint16_t g_lastMapId = MapChanged::kNoMap;
+
+} // namespace
+
+namespace detail
+{
+
+Channels &channels()
+{
+    return g_channels;
+}
+
+SubscriptionId nextSubscriptionId()
+{
+    return g_nextId++;
+}
+
+void unsubscribe(SubscriptionId id)
+{
+    std::apply([id](auto &...lists) { (std::erase_if(lists, [id](const auto &entry) { return entry.first == id; }), ...); }, g_channels);
+}
+
+void resetForTests()
+{
+    std::apply([](auto &...lists) { (lists.clear(), ...); }, g_channels);
+    g_lastMapId = MapChanged::kNoMap;
+}
+
+} // namespace detail
+
+void bindWolfCallbacks()
+{
+    wolf::onPlayStart([]() { publish(PlayStart{}); });
+    wolf::onReturnToMenu([]() { publish(ReturnToMenu{}); });
+}
+
+void updateMapId(uint16_t mapId)
+{
+    if (mapId == g_lastMapId)
+        return;
+
+    const uint16_t previous = g_lastMapId;
+    g_lastMapId = mapId;
+    publish(MapChanged{.previousMapId = previous, .mapId = mapId});
+}
+
+} // namespace lifecycle
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Typed lifecycle event bus
+ *
+ * Connection and gameplay state transitions are published here once, and the
+ * managers subscribe to the ones they care about instead of re-deriving the
+ * same state every game tick.
+ *
+ * Publishing and delivery are main-thread only. ArchipelagoSocket defers its
+ * events through processMainThreadTasks(), so subscribers never run under the
+ * client mutex and may freely call back into the socket.
+ */
+namespace lifecycle
+{
+
+/// Slot connection accepted by the server.
+struct Connected
+{
+};
+
+/// slot_data parsed; ISocket::getSlotConfig() is valid from here on.
+struct SlotConfigReady
+{
+};
+
+/// A live slot connection was lost or closed.
+struct Disconnected
+{
+};
+
+/// Player entered gameplay from the title screen (wolf::onPlayStart).
+struct PlayStart
+{
+};
+
+/// Player returned to the title screen (wolf::onReturnToMenu).
+struct ReturnToMenu
+{
+};
+
+/// Exterior map ID changed. previousMapId is kNoMap before the first change.
+struct MapChanged
+{
+    static constexpr uint16_t kNoMap = 0xFFFF;
+
+    uint16_t previousMapId;
+    uint16_t mapId;
+};
+
+namespace detail
+{
+
+using SubscriptionId = uint64_t;
+
+template <typename Event> using HandlerList = std::vector<std::pair<SubscriptionId, std::function<void(const Event &)>>>;
+
+// One handler list per event type. Subscribing to a type that isn't listed
+// here fails to compile.
+using Channels =
+    std::tuple<HandlerList<Connected>, HandlerList<SlotConfigReady>, HandlerList<Disconnected>, HandlerList<PlayStart>, HandlerList<ReturnToMenu>, HandlerList<MapChanged>>;
+
+Channels &channels();
+SubscriptionId nextSubscriptionId();
+void unsubscribe(SubscriptionId id);
+
+} // namespace detail
+
+/**
+ * @brief RAII subscription handle
+ *
+ * Unsubscribes on destruction, so handlers capturing `this` can't outlive
+ * their owner. Move-only.
+ */
+class Subscription
+{
+  public:
+    Subscription() = default;
+    explicit Subscription(detail::SubscriptionId id) : id_(id)
+    {
+    }
+
+    ~Subscription()
+    {
+        reset();
+    }
+
+    Subscription(const Subscription &) = delete;
+    Subscription &operator=(const Subscription &) = delete;
+
+    Subscription(Subscription &&other) noexcept : id_(std::exchange(other.id_, 0))
+    {
+    }
+
+    Subscription &operator=(Subscription &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            id_ = std::exchange(other.id_, 0);
+        }
+        return *this;
+    }
+
+    void reset()
+    {
+        if (id_ != 0)
+            detail::unsubscribe(std::exchange(id_, 0));
+    }
+
+  private:
+    detail::SubscriptionId id_ = 0;
+};
+
+/**
+ * @brief Register a handler for one event type
+ * @return Handle that keeps the handler registered while alive
+ */
+template <typename Event> [[nodiscard]] Subscription subscribe(std::function<void(const Event &)> handler)
+{
+    const auto id = detail::nextSubscriptionId();
+    std::get<detail::HandlerList<Event>>(detail::channels()).emplace_back(id, std::move(handler));
+    return Subscription(id);
+}
+
+/**
+ * @brief Deliver an event to every current subscriber, in subscription order
+ *
+ * Handlers may subscribe or unsubscribe while being dispatched; changes take
+ * effect from the next publish.
+ */
+template <typename Event> void publish(const Event &event)
+{
+    const auto handlers = std::get<detail::HandlerList<Event>>(detail::channels());
+    for (const auto &[id, handler] : handlers)
+        handler(event);
+}
+
+/**
+ * @brief Forward wolf::onPlayStart / wolf::onReturnToMenu onto the bus
+ *
+ * Call once during mod initialization.
+ */
+void bindWolfCallbacks();
+
+/**
+ * @brief Feed the current exterior map ID; publishes MapChanged on change
+ *
+ * Called from the game tick. One compare per frame; subscribers only run on
+ * an actual transition.
+ */
+void updateMapId(uint16_t mapId);
+
+namespace detail
+{
+
+// Test-only: drop every handler and forget the last seen map ID.
+void resetForTests();
+
+} // namespace detail
+
+} // namespace lifecycle
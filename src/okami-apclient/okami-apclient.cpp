@@ -1,6 +1,5 @@
 #include <memory>
 
-#include <okami/maps.hpp>
 #include <okami/offsets.hpp>
 #include <wolf_framework.hpp>
 
@@ -8,6 +7,7 @@
 #include "checkman.h"
 #include "gamestate_accessors.hpp"
 #include "itempatch.hpp"
+#include "lifecycle.h"
 #include "rewardman.h"
 #include "saveman.h"
 #include "ui/loginwindow.h"
@@ -129,24 +129,10 @@ class APClientMod
                     g_saveMan->queueAutoSave();
             });
 
-        // AP mode lifecycle: activate on play start (if connected). The Steam
-        // redirect and the FUN_18014f580 / FUN_18014e100 hooks handle data
-        // injection; we just track "we're in an AP gameplay session".
-        wolf::onPlayStart(
-            []()
-            {
-                if (g_saveMan && ArchipelagoSocket::instance().isConnected())
-                    g_saveMan->setApModeActive(true);
-            });
-        wolf::onReturnToMenu(
-            []()
-            {
-                if (g_saveMan)
-                {
-                    g_saveMan->deactivateRedirect();
-                    g_saveMan->setApModeActive(false);
-                }
-            });
+        // Lifecycle bus: wolf play/menu callbacks and exterior map changes are
+        // published once; managers and UI subscribe instead of polling state.
+        lifecycle::bindWolfCallbacks();
+        static const uintptr_t mainBase = wolf::getModuleBase("main.dll");
 
         // Game tick handler
         wolf::onGameTick(
@@ -154,34 +140,10 @@ class APClientMod
             {
                 ArchipelagoSocket::instance().processMainThreadTasks();
                 ArchipelagoSocket::instance().poll();
+                if (mainBase != 0)
+                    lifecycle::updateMapId(*reinterpret_cast<const uint16_t *>(mainBase + okami::main::exteriorMapID));
                 g_rewardMan->processQueuedRewards();
                 g_checkMan->poll();
-                // Activate Steam redirect when connected and path is available.
-                // If the user connects after the title menu was already populated with
-                // vanilla save state, warn: the currently-displayed menu won't reflect
-                // the AP save until the game re-reads save status (return-to-menu).
-                if (g_saveMan && g_saveMan->isConnected() && !g_saveMan->isRedirectActive())
-                {
-                    std::string path = g_saveMan->getSavePath();
-                    if (!path.empty())
-                    {
-                        g_saveMan->activateRedirect(path);
-
-                        uintptr_t base = wolf::getModuleBase("main.dll");
-                        if (base != 0)
-                        {
-                            auto mapId = *reinterpret_cast<const uint16_t *>(base + okami::main::exteriorMapID);
-                            if (mapId == static_cast<uint16_t>(MapID::TitleScreen) || mapId == static_cast<uint16_t>(MapID::TitleScreenDemoCutscene))
-                            {
-                                wolf::logWarning("[APClient] Steam redirect activated while on title screen "
-                                                 "(mapId=0x%X). The title menu was already populated with "
-                                                 "vanilla save state and will not reflect the AP save until "
-                                                 "the game re-reads save status. Return to menu to re-read.",
-                                                 mapId);
-                            }
-                        }
-                    }
-                }
                 if (g_saveMan)
                     g_saveMan->processAutoSave();
             });
@@ -11,8 +11,8 @@
 RewardMan::RewardMan(CheckSendingCallback onCheckSendingChange) : onCheckSendingChange_(std::move(onCheckSendingChange))
 {
     // Register gameplay state callbacks
-    wolf::onPlayStart([this]() { setGrantingEnabled(true); });
-    wolf::onReturnToMenu([this]() { setGrantingEnabled(false); });
+    playStartSub_ = lifecycle::subscribe<lifecycle::PlayStart>([this](const auto &) { setGrantingEnabled(true); });
+    returnToMenuSub_ = lifecycle::subscribe<lifecycle::ReturnToMenu>([this](const auto &) { setGrantingEnabled(false); });
 }
 
 void RewardMan::reset()
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "lifecycle.h"
 #include "rewards/reward_types.hpp"
 
 /**
@@ -130,4 +131,8 @@ class RewardMan
 
     // Callback to enable/disable check sending during granting
     CheckSendingCallback onCheckSendingChange_;
+
+    // PlayStart / ReturnToMenu toggle granting
+    lifecycle::Subscription playStartSub_;
+    lifecycle::Subscription returnToMenuSub_;
 };
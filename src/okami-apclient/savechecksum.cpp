@@ -0,0 +1,236 @@
+#include "savechecksum.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define SAVECHECKSUM_X64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SAVECHECKSUM_AVX2_TARGET
+#else
+#define SAVECHECKSUM_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace savechecksum
+{
+
+namespace
+{
+
+// Each body kernel folds whole blocks starting at a 32-byte aligned dst and
+// returns how many bytes it consumed; foldWith() does the rest with qwords
+// and a partial qword at either end. The byte count stays in a local: the
+// copies go through uint8_t pointers, which may alias a size_t in memory.
+
+template <bool Copy> size_t portableBody(uint8_t *dst, const uint8_t *src, size_t size, uint64_t &fold) noexcept
+{
+    // Four independent accumulators keep the XORs off one dependency chain
+    uint64_t acc[4] = {};
+    size_t done = 0;
+    for (; size - done >= 32; done += 32)
+    {
+        uint64_t q[4];
+        std::memcpy(q, src + done, sizeof(q));
+        if constexpr (Copy)
+            std::memcpy(dst + done, q, sizeof(q));
+        for (int i = 0; i < 4; ++i)
+            acc[i] ^= q[i];
+    }
+    fold = acc[0] ^ acc[1] ^ acc[2] ^ acc[3];
+    return done;
+}
+
+#ifdef SAVECHECKSUM_X64
+template <bool Copy> size_t sse2Body(uint8_t *dst, const uint8_t *src, size_t size, uint64_t &fold) noexcept
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    size_t done = 0;
+    for (; size - done >= 32; done += 32)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done + 16));
+        if constexpr (Copy)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i *>(dst + done), a);
+            _mm_store_si128(reinterpret_cast<__m128i *>(dst + done + 16), b);
+        }
+        acc0 = _mm_xor_si128(acc0, a);
+        acc1 = _mm_xor_si128(acc1, b);
+    }
+    const __m128i acc = _mm_xor_si128(acc0, acc1);
+    fold = static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) ^ static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    return done;
+}
+
+template <bool Copy> SAVECHECKSUM_AVX2_TARGET size_t avx2Body(uint8_t *dst, const uint8_t *src, size_t size, uint64_t &fold) noexcept
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t done = 0;
+    for (; size - done >= 64; done += 64)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done + 32));
+        if constexpr (Copy)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(dst + done), a);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(dst + done + 32), b);
+        }
+        acc0 = _mm256_xor_si256(acc0, a);
+        acc1 = _mm256_xor_si256(acc1, b);
+    }
+    const __m256i acc256 = _mm256_xor_si256(acc0, acc1);
+    const __m128i acc = _mm_xor_si128(_mm256_castsi256_si128(acc256), _mm256_extracti128_si256(acc256, 1));
+    fold = static_cast<uint64_t>(_mm_cvtsi128_si64(acc)) ^ static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    return done;
+}
+
+bool cpuHasAVX2() noexcept
+{
+#if defined(__AVX2__)
+    return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    constexpr int kOSXSAVE = 1 << 27;
+    if ((info[2] & kOSXSAVE) == 0 || (_xgetbv(0) & 0x6) != 0x6) // OS saves XMM and YMM state
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+template <bool Copy> uint64_t foldWith(Kernel kernel, uint8_t *dst, const uint8_t *src, size_t size) noexcept
+{
+    uint64_t acc = 0;
+
+    // Bytes before dst's first qword boundary go in the lanes they land in
+    if (const size_t lane = reinterpret_cast<uintptr_t>(dst) & 7; lane != 0 && size != 0)
+    {
+        const size_t head = std::min(8 - lane, size);
+        uint64_t q = 0;
+        std::memcpy(reinterpret_cast<uint8_t *>(&q) + lane, src, head);
+        if constexpr (Copy)
+            std::memcpy(dst, src, head);
+        acc ^= q;
+        dst += head;
+        src += head;
+        size -= head;
+    }
+
+    // Whole qwords up to a 32-byte boundary, so the vector stores are aligned
+    for (; size >= 8 && (reinterpret_cast<uintptr_t>(dst) & 31) != 0; size -= 8, src += 8, dst += 8)
+    {
+        uint64_t q;
+        std::memcpy(&q, src, 8);
+        if constexpr (Copy)
+            std::memcpy(dst, &q, 8);
+        acc ^= q;
+    }
+
+    uint64_t body = 0;
+    size_t done;
+    switch (kernel)
+    {
+#ifdef SAVECHECKSUM_X64
+    case Kernel::AVX2:
+        done = avx2Body<Copy>(dst, src, size, body);
+        break;
+    case Kernel::SSE2:
+        done = sse2Body<Copy>(dst, src, size, body);
+        break;
+#endif
+    default:
+        done = portableBody<Copy>(dst, src, size, body);
+        break;
+    }
+    acc ^= body;
+    dst += done;
+    src += done;
+    size -= done;
+
+    for (; size >= 8; size -= 8, src += 8, dst += 8)
+    {
+        uint64_t q;
+        std::memcpy(&q, src, 8);
+        if constexpr (Copy)
+            std::memcpy(dst, &q, 8);
+        acc ^= q;
+    }
+
+    if (size != 0)
+    {
+        uint64_t q = 0;
+        std::memcpy(&q, src, size);
+        if constexpr (Copy)
+            std::memcpy(dst, src, size);
+        acc ^= q;
+    }
+    return acc;
+}
+
+} // namespace
+
+bool supported(Kernel kernel) noexcept
+{
+    switch (kernel)
+    {
+    case Kernel::Portable:
+        return true;
+#ifdef SAVECHECKSUM_X64
+    case Kernel::SSE2:
+        return true;
+    case Kernel::AVX2:
+    {
+        static const bool hasAVX2 = cpuHasAVX2();
+        return hasAVX2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+Kernel best() noexcept
+{
+    static const Kernel kernel = supported(Kernel::AVX2) ? Kernel::AVX2 : supported(Kernel::SSE2) ? Kernel::SSE2 : Kernel::Portable;
+    return kernel;
+}
+
+uint64_t copyFold(void *dst, const void *src, size_t size) noexcept
+{
+    return copyFold(best(), dst, src, size);
+}
+
+uint64_t copyFold(Kernel kernel, void *dst, const void *src, size_t size) noexcept
+{
+    if (!supported(kernel))
+        kernel = Kernel::Portable;
+    return foldWith<true>(kernel, static_cast<uint8_t *>(dst), static_cast<const uint8_t *>(src), size);
+}
+
+uint64_t fold(const void *data, size_t size) noexcept
+{
+    return fold(best(), data, size);
+}
+
+uint64_t fold(Kernel kernel, const void *data, size_t size) noexcept
+{
+    if (!supported(kernel))
+        kernel = Kernel::Portable;
+    // Without Copy the destination is only used for its lane positions
+    auto *bytes = const_cast<uint8_t *>(static_cast<const uint8_t *>(data));
+    return foldWith<false>(kernel, bytes, bytes, size);
+}
+
+} // namespace savechecksum
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief XOR folding for the save slot checksum
+ *
+ * The game's checksum is the XOR of the slot's qwords, so it can be built up
+ * region by region while the regions are copied in, instead of in a second
+ * pass over the finished 0x172A0-byte slot. A fold XORs each byte into the
+ * lane of the qword its destination address falls in (dst & 7), so regions
+ * that start or end mid-qword fold exactly as they sit in the slot, and the
+ * folds of the regions tiling a slot XOR together to the whole-slot fold.
+ *
+ * The AVX2 kernel is picked at runtime when the CPU supports it. SSE2 is the
+ * x64 baseline, and a portable qword loop covers everything else.
+ */
+namespace savechecksum
+{
+
+enum class Kernel
+{
+    Portable,
+    SSE2,
+    AVX2,
+};
+
+/// Whether this build and CPU can run kernel.
+[[nodiscard]] bool supported(Kernel kernel) noexcept;
+
+/// Fastest supported kernel, used by the overloads without a Kernel argument.
+[[nodiscard]] Kernel best() noexcept;
+
+/// Copy size bytes from src to dst and return their fold, positioned by dst.
+uint64_t copyFold(void *dst, const void *src, size_t size) noexcept;
+uint64_t copyFold(Kernel kernel, void *dst, const void *src, size_t size) noexcept;
+
+/// Fold size bytes in place, positioned by their address.
+[[nodiscard]] uint64_t fold(const void *data, size_t size) noexcept;
+[[nodiscard]] uint64_t fold(Kernel kernel, const void *data, size_t size) noexcept;
+
+} // namespace savechecksum
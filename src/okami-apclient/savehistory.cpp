@@ -0,0 +1,415 @@
+#include "savehistory.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <system_error>
+
+#include <zlib.h>
+
+#include <okami/contenthash.hpp>
+#include <wolf_framework.hpp>
+
+namespace
+{
+
+constexpr uint32_t kManifestMagic = 0x48534B4F; // "OKSH"
+constexpr uint32_t kManifestVersion = 1;
+constexpr size_t kPrefixSize = offsetof(okami::SaveSlot, character);
+
+struct ManifestHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sequence;
+    uint64_t timeRTC;
+    uint32_t chunkCount;
+    uint16_t mapId;
+    uint16_t reserved;
+    uint64_t bodyHash; // contentHash of the prefix and chunk keys that follow
+};
+static_assert(sizeof(ManifestHeader) == 40);
+
+struct Region
+{
+    size_t offset;
+    size_t size;
+};
+
+// The six regions SaveMan copies; unk1 rides along with DialogBits
+constexpr Region kRegions[] = {
+    {offsetof(okami::SaveSlot, character), sizeof(okami::CharacterStats)},
+    {offsetof(okami::SaveSlot, tracked), sizeof(okami::TrackerData)},
+    {offsetof(okami::SaveSlot, collection), sizeof(okami::CollectionData)},
+    {offsetof(okami::SaveSlot, MapData), sizeof(okami::SaveSlot::MapData)},
+    {offsetof(okami::SaveSlot, DialogBits), offsetof(okami::SaveSlot, customTextures) - offsetof(okami::SaveSlot, DialogBits)},
+    {offsetof(okami::SaveSlot, customTextures), sizeof(okami::CustomTextures)},
+};
+static_assert(kRegions[0].offset == kPrefixSize);
+static_assert(kRegions[std::size(kRegions) - 1].offset + kRegions[std::size(kRegions) - 1].size == sizeof(okami::SaveSlot));
+
+/// Every region cut into chunks of at most kChunkSize, in slot order.
+constexpr auto kChunks = []
+{
+    constexpr size_t count = []
+    {
+        size_t n = 0;
+        for (const auto &region : kRegions)
+            n += (region.size + SaveHistory::kChunkSize - 1) / SaveHistory::kChunkSize;
+        return n;
+    }();
+
+    std::array<Region, count> chunks{};
+    size_t i = 0;
+    for (const auto &region : kRegions)
+    {
+        for (size_t at = 0; at < region.size; at += SaveHistory::kChunkSize)
+            chunks[i++] = {region.offset + at, std::min(SaveHistory::kChunkSize, region.size - at)};
+    }
+    return chunks;
+}();
+
+uint64_t hashBytes(const void *data, size_t size)
+{
+    return okami::contentHash({static_cast<const uint8_t *>(data), size});
+}
+
+/// Write through a .tmp file and rename, so a torn file never has the final name.
+bool writeFileReplacing(const std::string &path, std::span<const uint8_t> first, std::span<const uint8_t> second = {})
+{
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(first.data()), static_cast<std::streamsize>(first.size()));
+        file.write(reinterpret_cast<const char *>(second.data()), static_cast<std::streamsize>(second.size()));
+        if (!file.good())
+        {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool readFile(const std::filesystem::path &path, std::vector<uint8_t> &bytes)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())));
+}
+
+} // namespace
+
+SaveHistory::SaveHistory(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)), last_(std::make_unique<okami::SaveSlot>())
+{
+}
+
+SaveHistory::~SaveHistory() = default;
+
+std::string SaveHistory::directoryFor(const std::string &savePath)
+{
+    return savePath + ".history";
+}
+
+bool SaveHistory::add(const std::string &savePath, const okami::SaveSlot &slot)
+{
+    std::scoped_lock lock(mutex_);
+    open(savePath);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+
+    Snapshot snapshot{};
+    snapshot.entry = {snapshots_.empty() ? 1 : snapshots_.back().entry.sequence + 1, slot.timeRTC, slot.collection.currentMapId};
+    std::memcpy(snapshot.prefix, &slot, kPrefixSize);
+    snapshot.chunks.reserve(kChunks.size());
+
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&slot);
+    for (size_t i = 0; i < kChunks.size(); ++i)
+    {
+        uint64_t key = 0;
+        if (!storeChunk(bytes + kChunks[i].offset, kChunks[i].size, i, key))
+        {
+            wolf::logError("[SaveHistory] Failed to store a chunk in %s", dir_.c_str());
+            release(snapshot);
+            return false;
+        }
+        snapshot.chunks.push_back(key);
+    }
+
+    if (!writeManifest(snapshot))
+    {
+        wolf::logError("[SaveHistory] Failed to write snapshot %" PRIu64 " to %s", snapshot.entry.sequence, dir_.c_str());
+        release(snapshot);
+        return false;
+    }
+
+    snapshots_.push_back(std::move(snapshot));
+    std::memcpy(last_.get(), &slot, sizeof(slot));
+    lastValid_ = true;
+
+    while (snapshots_.size() > capacity_)
+    {
+        std::filesystem::remove(manifestPath(snapshots_.front().entry.sequence), ec);
+        release(snapshots_.front());
+        snapshots_.pop_front();
+    }
+    return true;
+}
+
+std::vector<SaveHistory::Entry> SaveHistory::list(const std::string &savePath)
+{
+    std::scoped_lock lock(mutex_);
+    open(savePath);
+
+    std::vector<Entry> entries;
+    entries.reserve(snapshots_.size());
+    for (auto it = snapshots_.rbegin(); it != snapshots_.rend(); ++it)
+        entries.push_back(it->entry);
+    return entries;
+}
+
+bool SaveHistory::load(const std::string &savePath, uint64_t sequence, okami::SaveSlot &slot)
+{
+    std::scoped_lock lock(mutex_);
+    open(savePath);
+
+    const auto it = std::ranges::find(snapshots_, sequence, [](const Snapshot &s) { return s.entry.sequence; });
+    if (it == snapshots_.end())
+        return false;
+
+    auto *bytes = reinterpret_cast<uint8_t *>(&slot);
+    std::memcpy(bytes, it->prefix, kPrefixSize);
+    for (size_t i = 0; i < kChunks.size(); ++i)
+    {
+        if (!readChunk(it->chunks[i], kChunks[i].size, bytes + kChunks[i].offset))
+        {
+            wolf::logError("[SaveHistory] Snapshot %" PRIu64 " in %s is damaged", sequence, dir_.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+SaveHistory::Stats SaveHistory::stats()
+{
+    std::scoped_lock lock(mutex_);
+
+    Stats stats;
+    stats.snapshots = snapshots_.size();
+    stats.chunks = chunks_.size();
+    stats.chunksWritten = chunksWritten_;
+    for (const auto &[key, chunk] : chunks_)
+        stats.storedBytes += chunk.storedBytes;
+    for (const auto &snapshot : snapshots_)
+        stats.storedBytes += snapshot.manifestBytes;
+    return stats;
+}
+
+void SaveHistory::open(const std::string &savePath)
+{
+    const std::string dir = directoryFor(savePath);
+    if (dir == dir_)
+        return;
+
+    dir_ = dir;
+    snapshots_.clear();
+    chunks_.clear();
+    lastValid_ = false;
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir_, ec))
+        return;
+
+    std::vector<std::filesystem::path> chunkFiles;
+    std::vector<uint8_t> bytes;
+    for (const auto &file : std::filesystem::directory_iterator(dir_, ec))
+    {
+        const auto &path = file.path();
+        if (path.extension() == ".chunk")
+        {
+            chunkFiles.push_back(path);
+            continue;
+        }
+        if (path.extension() != ".snap")
+        {
+            std::filesystem::remove(path, ec); // .tmp left by a crash
+            continue;
+        }
+
+        Snapshot snapshot{};
+        if (!readFile(path, bytes) || !parseManifest(bytes, snapshot))
+        {
+            wolf::logWarning("[SaveHistory] Dropping unreadable snapshot %s", path.string().c_str());
+            std::filesystem::remove(path, ec);
+            continue;
+        }
+        snapshots_.push_back(std::move(snapshot));
+    }
+
+    std::ranges::sort(snapshots_, {}, [](const Snapshot &s) { return s.entry.sequence; });
+    while (snapshots_.size() > capacity_)
+    {
+        std::filesystem::remove(manifestPath(snapshots_.front().entry.sequence), ec);
+        snapshots_.pop_front();
+    }
+
+    for (const auto &snapshot : snapshots_)
+    {
+        for (uint64_t key : snapshot.chunks)
+            ++chunks_[key].refs;
+    }
+
+    // Chunks no snapshot uses were orphaned by a crash before their manifest
+    for (const auto &path : chunkFiles)
+    {
+        uint64_t key = 0;
+        const std::string stem = path.stem().string();
+        const auto it = std::sscanf(stem.c_str(), "%016" SCNx64, &key) == 1 ? chunks_.find(key) : chunks_.end();
+        if (it == chunks_.end())
+            std::filesystem::remove(path, ec);
+        else
+            it->second.storedBytes = std::filesystem::file_size(path, ec);
+    }
+
+    if (!snapshots_.empty())
+        wolf::logInfo("[SaveHistory] %zu snapshots in %s", snapshots_.size(), dir_.c_str());
+}
+
+std::string SaveHistory::chunkPath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".chunk", key);
+    return (std::filesystem::path(dir_) / name).string();
+}
+
+std::string SaveHistory::manifestPath(uint64_t sequence) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".snap", sequence);
+    return (std::filesystem::path(dir_) / name).string();
+}
+
+bool SaveHistory::readChunk(uint64_t key, size_t size, uint8_t *out) const
+{
+    // File: contentHash of the chunk, then its zlib stream
+    std::vector<uint8_t> bytes;
+    uint64_t hash = 0;
+    if (!readFile(chunkPath(key), bytes) || bytes.size() < sizeof(hash))
+        return false;
+    std::memcpy(&hash, bytes.data(), sizeof(hash));
+
+    uLongf inflated = static_cast<uLongf>(size);
+    return uncompress(out, &inflated, bytes.data() + sizeof(hash), static_cast<uLong>(bytes.size() - sizeof(hash))) == Z_OK && inflated == size &&
+           hashBytes(out, size) == hash;
+}
+
+bool SaveHistory::storeChunk(const uint8_t *data, size_t size, size_t index, uint64_t &key)
+{
+    // Keys start at the content hash; a different chunk already holding one
+    // (a hash collision) pushes this one to the next key
+    const uint64_t hash = hashBytes(data, size);
+    std::array<uint8_t, kChunkSize> stored;
+    for (key = hash;; ++key)
+    {
+        const auto it = chunks_.find(key);
+        if (it == chunks_.end())
+            break;
+
+        // Usually the same chunk as in the newest snapshot, which is still in memory
+        const bool same = lastValid_ && snapshots_.back().chunks[index] == key
+                              ? std::memcmp(reinterpret_cast<const uint8_t *>(last_.get()) + kChunks[index].offset, data, size) == 0
+                              : readChunk(key, size, stored.data()) && std::memcmp(stored.data(), data, size) == 0;
+        if (same)
+        {
+            ++it->second.refs;
+            return true;
+        }
+    }
+
+    std::vector<uint8_t> compressed(sizeof(hash) + compressBound(static_cast<uLong>(size)));
+    std::memcpy(compressed.data(), &hash, sizeof(hash));
+    uLongf compressedSize = static_cast<uLongf>(compressed.size() - sizeof(hash));
+    if (compress2(compressed.data() + sizeof(hash), &compressedSize, data, static_cast<uLong>(size), Z_BEST_SPEED) != Z_OK)
+        return false;
+    compressed.resize(sizeof(hash) + compressedSize);
+
+    if (!writeFileReplacing(chunkPath(key), compressed))
+        return false;
+    chunks_[key] = {1, compressed.size()};
+    ++chunksWritten_;
+    return true;
+}
+
+bool SaveHistory::parseManifest(std::span<const uint8_t> bytes, Snapshot &snapshot)
+{
+    ManifestHeader header{};
+    if (bytes.size() != sizeof(header) + kPrefixSize + kChunks.size() * sizeof(uint64_t))
+        return false;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    const auto body = bytes.subspan(sizeof(header));
+    if (header.magic != kManifestMagic || header.version != kManifestVersion || header.chunkCount != kChunks.size() ||
+        header.bodyHash != okami::contentHash(body))
+        return false;
+
+    snapshot.entry = {header.sequence, header.timeRTC, header.mapId};
+    snapshot.manifestBytes = bytes.size();
+    std::memcpy(snapshot.prefix, body.data(), kPrefixSize);
+    snapshot.chunks.resize(kChunks.size());
+    std::memcpy(snapshot.chunks.data(), body.data() + kPrefixSize, kChunks.size() * sizeof(uint64_t));
+    return true;
+}
+
+bool SaveHistory::writeManifest(Snapshot &snapshot)
+{
+    std::vector<uint8_t> body(kPrefixSize + snapshot.chunks.size() * sizeof(uint64_t));
+    std::memcpy(body.data(), snapshot.prefix, kPrefixSize);
+    std::memcpy(body.data() + kPrefixSize, snapshot.chunks.data(), snapshot.chunks.size() * sizeof(uint64_t));
+
+    const ManifestHeader header{kManifestMagic,
+                                kManifestVersion,
+                                snapshot.entry.sequence,
+                                snapshot.entry.timeRTC,
+                                static_cast<uint32_t>(snapshot.chunks.size()),
+                                snapshot.entry.mapId,
+                                0,
+                                hashBytes(body.data(), body.size())};
+    const std::span<const uint8_t> headerBytes(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    if (!writeFileReplacing(manifestPath(snapshot.entry.sequence), headerBytes, body))
+        return false;
+
+    snapshot.manifestBytes = sizeof(header) + body.size();
+    return true;
+}
+
+void SaveHistory::release(const Snapshot &snapshot)
+{
+    std::error_code ec;
+    for (uint64_t key : snapshot.chunks)
+    {
+        const auto it = chunks_.find(key);
+        if (it == chunks_.end() || --it->second.refs != 0)
+            continue;
+        std::filesystem::remove(chunkPath(key), ec);
+        chunks_.erase(it);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <okami/savefile.hpp>
+
+/**
+ * @brief Rollback history of an AP save
+ *
+ * Keeps the last kDefaultCapacity committed slots of a .oksav in
+ * <path>.history/ so a bad save can be undone. Each of the six game regions is
+ * cut into chunks of at most kChunkSize bytes. A chunk is stored once, zlib
+ * compressed and named by its content hash, however many snapshots use it.
+ * A snapshot is then a small manifest: the slot's first 0x18 bytes and its
+ * chunks' keys. Between two saves usually only a chunk or two of
+ * CollectionData and MapData changes, so a snapshot costs a few KB at most.
+ *
+ * Dropping the oldest snapshot deletes the chunks nothing else uses. Chunk
+ * and manifest files are written through .tmp + rename but never synced: the
+ * history is a safety net next to the .oksav, not a second copy of it.
+ * Opening a history drops unreadable manifests and unreferenced chunks left
+ * by a crash.
+ *
+ * Thread safe: the save writer adds snapshots while the game thread lists
+ * and loads them.
+ */
+class SaveHistory
+{
+  public:
+    static constexpr size_t kDefaultCapacity = 100;
+    static constexpr size_t kChunkSize = 4096;
+
+    struct Entry
+    {
+        uint64_t sequence; // increases with every snapshot of the save
+        uint64_t timeRTC;  // the slot's save time (Windows FILETIME)
+        uint16_t mapId;    // the slot's CollectionData.currentMapId
+    };
+
+    struct Stats
+    {
+        size_t snapshots = 0;
+        size_t chunks = 0;         // distinct chunks on disk
+        uint64_t storedBytes = 0;  // compressed chunks and manifests on disk
+        uint64_t chunksWritten = 0; // chunks compressed and written since construction
+    };
+
+    explicit SaveHistory(size_t capacity = kDefaultCapacity);
+    ~SaveHistory();
+
+    SaveHistory(const SaveHistory &) = delete;
+    SaveHistory &operator=(const SaveHistory &) = delete;
+
+    /// History directory for an .oksav.
+    [[nodiscard]] static std::string directoryFor(const std::string &savePath);
+
+    /// Record slot as the newest snapshot of the save at savePath, dropping
+    /// the oldest past capacity.
+    bool add(const std::string &savePath, const okami::SaveSlot &slot);
+
+    /// Snapshots of the save at savePath, newest first.
+    [[nodiscard]] std::vector<Entry> list(const std::string &savePath);
+
+    /// Rebuild a snapshot. Fails if it is gone or a chunk is missing or damaged.
+    [[nodiscard]] bool load(const std::string &savePath, uint64_t sequence, okami::SaveSlot &slot);
+
+    /// Counters for the history currently open.
+    [[nodiscard]] Stats stats();
+
+  private:
+    struct Snapshot
+    {
+        Entry entry;
+        std::vector<uint64_t> chunks; // chunk keys, in slot order
+        uint8_t prefix[0x18];         // header, checksum and timestamp
+        uint64_t manifestBytes;
+    };
+
+    struct Chunk
+    {
+        uint32_t refs;
+        uint64_t storedBytes;
+    };
+
+    void open(const std::string &savePath);
+    [[nodiscard]] std::string chunkPath(uint64_t key) const;
+    [[nodiscard]] std::string manifestPath(uint64_t sequence) const;
+    [[nodiscard]] bool readChunk(uint64_t key, size_t size, uint8_t *out) const;
+    [[nodiscard]] bool storeChunk(const uint8_t *data, size_t size, size_t index, uint64_t &key);
+    [[nodiscard]] static bool parseManifest(std::span<const uint8_t> bytes, Snapshot &snapshot);
+    [[nodiscard]] bool writeManifest(Snapshot &snapshot);
+    void release(const Snapshot &snapshot);
+
+    size_t capacity_;
+    std::mutex mutex_;
+    std::string dir_; // empty until a history is opened
+    std::deque<Snapshot> snapshots_; // oldest first
+    std::unordered_map<uint64_t, Chunk> chunks_;
+    std::unique_ptr<okami::SaveSlot> last_; // newest snapshot's slot, to confirm dedup hits without I/O
+    bool lastValid_ = false;
+    uint64_t chunksWritten_ = 0;
+};
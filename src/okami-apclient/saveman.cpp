@@ -1,6 +1,8 @@
 #include "saveman.h"
 
 #include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -17,7 +19,10 @@
 #include <okami/offsets.hpp>
 #include <wolf_framework.hpp>
 
+#include "checks/map_registry.hpp"
 #include "isocket.h"
+#include "savechecksum.h"
+#include "savestore.h"
 #include "ui/notificationwindow.h"
 
 static std::string initSaveDir()
@@ -57,6 +62,9 @@ constexpr uintptr_t kCustomTextures = okami::main::customTextures; // 0xB21820
 
 constexpr uint64_t kChecksumSeed = 0x9be6fa3b72afda1d;
 constexpr uint32_t kHeaderMagic = 0x40400000;
+constexpr uint64_t kFileTimeUnixEpoch = 116444736000000000ULL; // 1970-01-01 in FILETIME units
+
+constexpr const char *kHistoryCommand = "ap_history";
 
 // Hook offsets (relative to main.dll base)
 constexpr uintptr_t kMcSaveCtorOffset = 0x1c3de0;        // FUN_1801c3de0: cMcSave constructor
@@ -68,6 +76,11 @@ constexpr uintptr_t kOkamiWriteKickoffOffset = 0x14e100; // FUN_18014e100: m2::S
 constexpr uintptr_t kOkamiPureReadOffset = 0x14f580;     // FUN_18014f580: Called by
                                                          //   m2::SaveDataManager with (dir, filename,
                                                          //   offset, userBuffer, &size)
+
+bool isTitleScreenMap(uint16_t mapId)
+{
+    return mapId == static_cast<uint16_t>(MapID::TitleScreen) || mapId == static_cast<uint16_t>(MapID::TitleScreenDemoCutscene);
+}
 } // namespace
 
 static_assert(sizeof(okami::SaveSlot) == 0x172A0, "SaveSlot size mismatch — expected 0x172A0 bytes");
@@ -119,34 +132,6 @@ static bool isOkamiFile(const char *pchFile)
     return len >= 6 && std::strcmp(pchFile + len - 6, "/OKAMI") == 0;
 }
 
-// Atomic write helper: returns true on success. Caller should already have validated
-// that writing to `path` is the intended action (i.e. redirect active).
-static bool writeOkamiPayloadAtomic(const std::string &path, const void *pvData, size_t cubData)
-{
-    const std::string tmpPath = path + ".tmp";
-    {
-        std::ofstream file(tmpPath, std::ios::binary);
-        if (!file.is_open())
-            return false;
-        file.write(reinterpret_cast<const char *>(pvData), static_cast<std::streamsize>(cubData));
-        file.close();
-        if (!file.good())
-        {
-            std::error_code ec;
-            std::filesystem::remove(tmpPath, ec);
-            return false;
-        }
-    }
-    std::error_code ec;
-    std::filesystem::rename(tmpPath, path, ec);
-    if (ec)
-    {
-        std::filesystem::remove(tmpPath, ec);
-        return false;
-    }
-    return true;
-}
-
 static bool __fastcall hookSteamFileExists(void *pThis, const char *pchFile)
 {
     {
@@ -223,13 +208,13 @@ static void *__fastcall hookOkamiWriteKickoff(void *pTracking, const char *pchFi
                               "(%u bytes, Steam still bypassed)",
                               cubData);
             }
-            else if (writeOkamiPayloadAtomic(target, pvData, static_cast<size_t>(cubData)))
+            else if (SaveStore(target).replaceFile(pvData, static_cast<size_t>(cubData)))
             {
                 wolf::logInfo("[SaveMan] OKAMI write kickoff -> %s (%u bytes), Steam bypassed", target.c_str(), cubData);
             }
             else
             {
-                wolf::logError("[SaveMan] OKAMI write kickoff: writeOkamiPayloadAtomic failed (%s, %u bytes)", target.c_str(), cubData);
+                wolf::logError("[SaveMan] OKAMI write kickoff: replaceFile failed (%s, %u bytes)", target.c_str(), cubData);
             }
 
             // Zero the ~0x70-byte tracking struct
@@ -400,10 +385,17 @@ static void __fastcall hookMcSaveCtor(void *pContext)
 
 SaveMan::SaveMan(ISocket &socket) : socket_(socket)
 {
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::Connected>([this](const auto &) { onConnected(); }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::PlayStart>([this](const auto &) { onPlayStart(); }));
+    subscriptions_.push_back(lifecycle::subscribe<lifecycle::ReturnToMenu>([this](const auto &) { onReturnToMenu(); }));
+    subscriptions_.push_back(
+        lifecycle::subscribe<lifecycle::MapChanged>([this](const lifecycle::MapChanged &e) { onTitleScreen_ = isTitleScreenMap(e.mapId); }));
 }
 
 SaveMan::~SaveMan()
 {
+    if (initialized_)
+        wolf::removeCommand(kHistoryCommand);
     if (g_saveMan == this)
         g_saveMan = nullptr;
 }
@@ -430,6 +422,9 @@ void SaveMan::initialize()
     dialogBitsAddr_ = moduleBase_ + kDialogBits;
     customTexturesAddr_ = moduleBase_ + kCustomTextures;
     initialized_ = true;
+
+    wolf::addCommand(kHistoryCommand, [this](const std::vector<std::string> &args) { handleHistoryCommand(args); },
+                     "List the AP save's rollback history or restore a snapshot into it. Usage: ap_history [restore <#>]");
     wolf::logInfo("[SaveMan] Initialized (base=0x%llX)", moduleBase_);
 }
 
@@ -446,16 +441,8 @@ bool SaveMan::saveGameState()
         return false;
     }
 
-    okami::SaveSlot slot;
-    std::memset(&slot, 0, sizeof(slot));
-
-    snapshotToSlot(slot);
-    slot.checksum = computeChecksum(slot);
-
-    wolf::logDebug("[SaveMan] Slot header: magic=0x%08X, +04=0x%08X, checksum=0x%llX, time=0x%llX", slot.header, slot.areaNameStrId, slot.checksum,
-                   slot.timeRTC);
-
-    if (!writeSlotToFile(slot))
+    // Same path as auto-saves, so the two can never write the file at once
+    if (!submitSave() || !waitForSaves())
     {
         wolf::logError("[SaveMan] saveGameState: failed to write save file");
         logState("saveGameState");
@@ -470,11 +457,15 @@ bool SaveMan::saveGameState()
         autoSavePending_ = false;
         deferralWarned_ = false;
     }
-
-    wolf::logInfo("[SaveMan] Game state saved to %s", getSavePath().c_str());
     return true;
 }
 
+bool SaveMan::waitForSaves()
+{
+    writer_.waitIdle();
+    return handleSaveResults();
+}
+
 bool SaveMan::loadGameState()
 {
     if (!initialized_)
@@ -536,8 +527,9 @@ bool SaveMan::deleteSave()
     if (path.empty())
         return false;
 
-    std::error_code ec;
-    if (std::filesystem::remove(path, ec))
+    writer_.waitIdle();
+    SaveStore store(path);
+    if (store.remove())
     {
         wolf::logInfo("[SaveMan] Deleted save file: %s", path.c_str());
         return true;
@@ -545,6 +537,119 @@ bool SaveMan::deleteSave()
     return false;
 }
 
+// =============================================================================
+// Save history
+// =============================================================================
+
+std::vector<SaveHistory::Entry> SaveMan::listHistory()
+{
+    std::string path = getSavePath();
+    if (path.empty())
+        return {};
+    return history_.list(path);
+}
+
+bool SaveMan::restoreFromHistory(uint64_t sequence)
+{
+    std::string path = getSavePath();
+    if (path.empty())
+    {
+        wolf::logError("[SaveMan] Restore: no save path");
+        return false;
+    }
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    if (!history_.load(path, sequence, *slot))
+    {
+        wolf::logError("[SaveMan] Restore: no usable snapshot #%llu", static_cast<unsigned long long>(sequence));
+        return false;
+    }
+
+    // Game memory belongs to the game thread; the tick applies the snapshot
+    // once it is safe to, replacing any restore still waiting
+    {
+        std::scoped_lock lock(restoreMutex_);
+        pendingRestore_ = std::move(slot);
+        pendingRestorePath_ = path;
+        pendingRestoreSequence_ = sequence;
+    }
+    wolf::logInfo("[SaveMan] Restoring snapshot #%llu at the next safe moment in gameplay", static_cast<unsigned long long>(sequence));
+    return true;
+}
+
+void SaveMan::applyPendingRestore()
+{
+    std::unique_ptr<okami::SaveSlot> slot;
+    std::string path;
+    uint64_t sequence = 0;
+    {
+        std::scoped_lock lock(restoreMutex_);
+        if (!pendingRestore_)
+            return;
+
+        // Rewriting game state mid-load or mid-save would be torn by the engine
+        if (!isSafeToSave())
+            return;
+        slot = std::move(pendingRestore_);
+        path = std::move(pendingRestorePath_);
+        sequence = pendingRestoreSequence_;
+    }
+    if (path != getSavePath())
+    {
+        wolf::logWarning("[SaveMan] Dropping restore of snapshot #%llu: the connection changed", static_cast<unsigned long long>(sequence));
+        return;
+    }
+
+    restoreFromSlot(*slot);
+
+    // The restored state supersedes a pending auto-save of the state it
+    // replaced. Saving it right away also records it as the newest snapshot.
+    {
+        std::scoped_lock lock(autoSaveMutex_);
+        autoSavePending_ = false;
+        deferralWarned_ = false;
+    }
+    if (!submitSave())
+        logState("applyPendingRestore");
+
+    wolf::logInfo("[SaveMan] Restored snapshot #%llu into %s", static_cast<unsigned long long>(sequence), path.c_str());
+    notificationwindow::queue("AP save restored", 5.0f);
+}
+
+void SaveMan::handleHistoryCommand(const std::vector<std::string> &args)
+{
+    // args[0] is the command name
+    if (args.size() < 2)
+    {
+        const auto entries = listHistory();
+        if (entries.empty())
+        {
+            wolf::logInfo("[SaveMan] No save history for the current connection");
+            return;
+        }
+
+        const auto now = static_cast<uint64_t>(
+                             std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count() * 10) +
+                         kFileTimeUnixEpoch;
+        for (const auto &entry : entries)
+        {
+            const uint64_t minutes = now > entry.timeRTC ? (now - entry.timeRTC) / 600000000ULL : 0;
+            wolf::logInfo("[SaveMan] #%-4llu %4llu min ago  %s", static_cast<unsigned long long>(entry.sequence), static_cast<unsigned long long>(minutes),
+                          okami::decodeMapName(entry.mapId).c_str());
+        }
+        return;
+    }
+
+    uint64_t sequence = 0;
+    const std::string_view arg = args.size() == 3 ? std::string_view(args[2]) : std::string_view();
+    if (args[1] != "restore" || std::from_chars(arg.data(), arg.data() + arg.size(), sequence).ec != std::errc{})
+    {
+        wolf::logWarning("[SaveMan] Usage: %s [restore <#>]", kHistoryCommand);
+        return;
+    }
+    (void)restoreFromHistory(sequence);
+}
+
 // =============================================================================
 // AP mode
 // =============================================================================
@@ -582,6 +687,9 @@ void SaveMan::queueAutoSave()
 
 void SaveMan::processAutoSave()
 {
+    handleSaveResults();
+    applyPendingRestore();
+
     if (!autoSavePending_ || !apModeActive_)
         return;
 
@@ -612,7 +720,9 @@ void SaveMan::processAutoSave()
         deferralWarned_ = false;
     }
 
-    (void)saveGameState();
+    // The writer thread does the file I/O; its result is handled on a later tick
+    if (!submitSave())
+        logState("processAutoSave");
 }
 
 bool SaveMan::isSafeToSave() const
@@ -624,7 +734,7 @@ bool SaveMan::isSafeToSave() const
 
     // Title screen — no gameplay state to snapshot.
     uint16_t mapId = *reinterpret_cast<const uint16_t *>(moduleBase_ + okami::main::exteriorMapID);
-    if (mapId == static_cast<uint16_t>(MapID::TitleScreen) || mapId == static_cast<uint16_t>(MapID::TitleScreenDemoCutscene))
+    if (isTitleScreenMap(mapId))
         return false;
 
     // Save operation already in flight — bit 22 of systemFlags is the cMcSys
@@ -677,7 +787,7 @@ void SaveMan::snapshotToSlot(okami::SaveSlot &slot)
     // Look up from the live exterior map ID — 0x79BEB4 is only populated
     // inside the game's own save routine and reads 0xFFFFFFFF otherwise.
     uint16_t mapId = *reinterpret_cast<const uint16_t *>(moduleBase_ + okami::main::exteriorMapID);
-    slot.areaNameStrId = okami::getAreaNameID(mapId);
+    slot.areaNameStrId = checks::mapInfo(mapId).areaNameStrId;
 
     // RTC timestamp (Windows FILETIME format for compatibility)
     auto now = std::chrono::system_clock::now();
@@ -685,9 +795,12 @@ void SaveMan::snapshotToSlot(okami::SaveSlot &slot)
     // Convert to Windows FILETIME (100-ns intervals since 1601-01-01)
     // Unix epoch to FILETIME epoch offset: 116444736000000000
     auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
-    slot.timeRTC = static_cast<uint64_t>(us * 10) + 116444736000000000ULL;
+    slot.timeRTC = static_cast<uint64_t>(us * 10) + kFileTimeUnixEpoch;
 
-    // Copy the 6 game state regions
+    // Copy the 6 game state regions, folding the checksum in as they are copied
+    // so the slot is only walked once. The regions, unk1 and the fields above
+    // tile the slot (see the static_asserts by computeChecksum()).
+    uint64_t checksum = kChecksumSeed;
     std::memcpy(&slot.character, reinterpret_cast<const void *>(characterStatsAddr_), sizeof(okami::CharacterStats));
 
     // CharacterStats.x/y/z (position) and u/v/w (rotation) are flagged "set from
@@ -715,10 +828,11 @@ void SaveMan::snapshotToSlot(okami::SaveSlot &slot)
             slot.character.w = rot[2];
         }
     }
+    checksum ^= savechecksum::fold(&slot.character, sizeof(okami::CharacterStats)); // 0x48 bytes, after the patch-up
 
-    std::memcpy(&slot.tracked, reinterpret_cast<const void *>(trackerDataAddr_), sizeof(okami::TrackerData));
+    checksum ^= savechecksum::copyFold(&slot.tracked, reinterpret_cast<const void *>(trackerDataAddr_), sizeof(okami::TrackerData));
 
-    std::memcpy(&slot.collection, reinterpret_cast<const void *>(collectionDataAddr_), sizeof(okami::CollectionData));
+    checksum ^= savechecksum::copyFold(&slot.collection, reinterpret_cast<const void *>(collectionDataAddr_), sizeof(okami::CollectionData));
 
     // CollectionData carries map-identity fields (currentMapId at +0x02,
     // lastMapId at +0x04) that the comment in structs.hpp flags as
@@ -728,16 +842,24 @@ void SaveMan::snapshotToSlot(okami::SaveSlot &slot)
     // so the in-memory values here are stale — typically the parent/"top"
     // map instead of the sub-map the player is actually in, which is why
     // reload spawns in the wrong room. Patch them from the live sources.
+    // XORing the patched fields' fold out and back in swaps the stale bytes
+    // for the live ones without refolding the region.
     {
+        checksum ^= savechecksum::fold(&slot.collection.currentMapId, sizeof(uint16_t) * 2);
         slot.collection.currentMapId = mapId; // already read from exteriorMapID
         slot.collection.lastMapId = *reinterpret_cast<const uint16_t *>(moduleBase_ + okami::main::exteriorMapIDCopy);
+        checksum ^= savechecksum::fold(&slot.collection.currentMapId, sizeof(uint16_t) * 2);
     }
 
-    std::memcpy(slot.MapData, reinterpret_cast<const void *>(mapDataAddr_), sizeof(slot.MapData));
+    checksum ^= savechecksum::copyFold(slot.MapData, reinterpret_cast<const void *>(mapDataAddr_), sizeof(slot.MapData));
 
-    std::memcpy(slot.DialogBits, reinterpret_cast<const void *>(dialogBitsAddr_), sizeof(slot.DialogBits));
+    checksum ^= savechecksum::copyFold(slot.DialogBits, reinterpret_cast<const void *>(dialogBitsAddr_), sizeof(slot.DialogBits));
 
-    std::memcpy(&slot.customTextures, reinterpret_cast<const void *>(customTexturesAddr_), sizeof(okami::CustomTextures));
+    checksum ^= savechecksum::copyFold(&slot.customTextures, reinterpret_cast<const void *>(customTexturesAddr_), sizeof(okami::CustomTextures));
+
+    // unk1 is never written here but is still covered by the checksum
+    checksum ^= savechecksum::fold(&slot.unk1, sizeof(slot.unk1));
+    slot.checksum = checksum ^ *reinterpret_cast<const uint64_t *>(&slot) ^ slot.timeRTC; // header qword
 }
 
 void SaveMan::restoreFromSlot(const okami::SaveSlot &slot)
@@ -760,95 +882,60 @@ void SaveMan::restoreFromSlot(const okami::SaveSlot &slot)
 // Checksum (ported from OriginEdit — XOR all qwords except the checksum field)
 // =============================================================================
 
+// snapshotToSlot() folds the slot piecewise; these are the pieces
+static_assert(offsetof(okami::SaveSlot, timeRTC) == 0x10);
+static_assert(offsetof(okami::SaveSlot, character) == offsetof(okami::SaveSlot, timeRTC) + sizeof(uint64_t));
+static_assert(offsetof(okami::SaveSlot, tracked) == offsetof(okami::SaveSlot, character) + sizeof(okami::CharacterStats));
+static_assert(offsetof(okami::SaveSlot, collection) == offsetof(okami::SaveSlot, tracked) + sizeof(okami::TrackerData));
+static_assert(offsetof(okami::SaveSlot, MapData) == offsetof(okami::SaveSlot, collection) + sizeof(okami::CollectionData));
+static_assert(offsetof(okami::SaveSlot, DialogBits) == offsetof(okami::SaveSlot, MapData) + sizeof(okami::SaveSlot::MapData));
+static_assert(offsetof(okami::SaveSlot, unk1) == offsetof(okami::SaveSlot, DialogBits) + sizeof(okami::SaveSlot::DialogBits));
+static_assert(offsetof(okami::SaveSlot, customTextures) == offsetof(okami::SaveSlot, unk1) + sizeof(uint32_t));
+static_assert(sizeof(okami::SaveSlot) == offsetof(okami::SaveSlot, customTextures) + sizeof(okami::CustomTextures));
+static_assert(offsetof(okami::CollectionData, lastMapId) == offsetof(okami::CollectionData, currentMapId) + sizeof(uint16_t));
+
 uint64_t SaveMan::computeChecksum(const okami::SaveSlot &slot)
 {
     const auto *data = reinterpret_cast<const uint64_t *>(&slot);
-    constexpr size_t totalQwords = sizeof(okami::SaveSlot) / sizeof(uint64_t);
-
-    // Seed XOR'd with first qword (header + areaNameStrId)
-    uint64_t checksum = kChecksumSeed ^ data[0];
 
-    // Skip data[1] (the checksum field at offset +0x08)
-    // XOR all qwords from offset +0x10 onward
-    for (size_t i = 2; i < totalQwords; ++i)
-    {
-        checksum ^= data[i];
-    }
-
-    return checksum;
+    // Seed XOR'd with first qword (header + areaNameStrId), skipping data[1]
+    // (the checksum field at offset +0x08), then every qword from +0x10 onward
+    return kChecksumSeed ^ data[0] ^ savechecksum::fold(data + 2, sizeof(okami::SaveSlot) - 2 * sizeof(uint64_t));
 }
 
 // =============================================================================
 // File I/O
 // =============================================================================
 
-bool SaveMan::writeSlotToFile(const okami::SaveSlot &slot)
+bool SaveMan::submitSave()
 {
     std::string path = getSavePath();
     if (path.empty())
-        return false;
-
-    try
     {
-        std::filesystem::create_directories(SAVE_DIR);
-
-        // Atomic write: write to .tmp, then rename
-        std::string tmpPath = path + ".tmp";
-
-        std::ofstream file(tmpPath, std::ios::binary);
-        if (!file.is_open())
-        {
-            wolf::logError("[SaveMan] Failed to open %s for writing", tmpPath.c_str());
-            return false;
-        }
-
-        // Read-modify-write: preserve existing slots 1-29 (game-created format),
-        // only replace slot 0 with our AP data.
-        auto saveFile = std::make_unique<okami::SaveFile>();
-        {
-            std::ifstream existing(path, std::ios::binary);
-            if (existing.is_open() && existing.read(reinterpret_cast<char *>(saveFile.get()), sizeof(okami::SaveFile)))
-            {
-                // Existing file read OK — slots 1-29 preserved
-            }
-            else
-            {
-                // No existing file or read failed — initialize to match game's empty-slot format:
-                // all zeros except areaNameStrId = 0xFFFFFFFF per slot.
-                std::memset(saveFile.get(), 0, sizeof(okami::SaveFile));
-                for (int i = 0; i < 30; ++i)
-                    saveFile->slots[i].areaNameStrId = 0xFFFFFFFF;
-            }
-        }
-        std::memcpy(&saveFile->slots[0], &slot, sizeof(okami::SaveSlot));
+        wolf::logError("[SaveMan] Save skipped: no save path");
+        return false;
+    }
 
-        file.write(reinterpret_cast<const char *>(saveFile.get()), sizeof(okami::SaveFile));
-        file.close();
+    writer_.submit(std::move(path), [this](okami::SaveSlot &slot) { snapshotToSlot(slot); });
+    return true;
+}
 
-        if (!file.good())
+bool SaveMan::handleSaveResults()
+{
+    bool allOk = true;
+    for (const auto &result : writer_.takeResults())
+    {
+        if (result.ok)
         {
-            wolf::logError("[SaveMan] Write error to %s", tmpPath.c_str());
-            std::filesystem::remove(tmpPath);
-            return false;
+            wolf::logInfo("[SaveMan] Game state saved to %s", result.path.c_str());
         }
-
-        // Atomic rename
-        std::error_code ec;
-        std::filesystem::rename(tmpPath, path, ec);
-        if (ec)
+        else
         {
-            wolf::logError("[SaveMan] Failed to rename %s -> %s: %s", tmpPath.c_str(), path.c_str(), ec.message().c_str());
-            std::filesystem::remove(tmpPath);
-            return false;
+            wolf::logError("[SaveMan] Failed to write save file %s", result.path.c_str());
+            allOk = false;
         }
-
-        return true;
-    }
-    catch (const std::exception &e)
-    {
-        wolf::logError("[SaveMan] Exception writing save: %s", e.what());
-        return false;
     }
+    return allOk;
 }
 
 bool SaveMan::readSlotFromFile(okami::SaveSlot &slot) const
@@ -859,26 +946,16 @@ bool SaveMan::readSlotFromFile(okami::SaveSlot &slot) const
 
     try
     {
-        auto fileSize = std::filesystem::file_size(path);
-        if (fileSize != sizeof(okami::SaveFile))
-        {
-            wolf::logError("[SaveMan] Invalid save file size: %zu (expected %zu)", static_cast<size_t>(fileSize), sizeof(okami::SaveFile));
-            return false;
-        }
-
-        std::ifstream file(path, std::ios::binary);
-        if (!file.is_open())
-        {
-            wolf::logError("[SaveMan] Failed to open %s for reading", path.c_str());
-            return false;
-        }
-
         // AP data is always in slot 0
-        file.read(reinterpret_cast<char *>(&slot), sizeof(okami::SaveSlot));
-
-        if (!file.good())
+        SaveStore store(path);
+        if (!store.readSlot(slot))
         {
-            wolf::logError("[SaveMan] Read error from %s", path.c_str());
+            std::error_code ec;
+            const auto fileSize = std::filesystem::file_size(path, ec);
+            if (!ec && fileSize != sizeof(okami::SaveFile))
+                wolf::logError("[SaveMan] Invalid save file size: %zu (expected %zu)", static_cast<size_t>(fileSize), sizeof(okami::SaveFile));
+            else
+                wolf::logError("[SaveMan] Read error from %s", path.c_str());
             return false;
         }
 
@@ -1020,8 +1097,64 @@ void SaveMan::installSteamRedirect()
 #endif
 }
 
+// =============================================================================
+// Lifecycle
+// =============================================================================
+
+void SaveMan::onConnected()
+{
+    std::string path = getSavePath();
+    if (path.empty())
+        return;
+
+    // activateRedirect() compacts the save; the writer must not be appending to it
+    waitForSaves();
+    activateRedirect(path);
+
+    // If the user connects after the title menu was already populated with
+    // vanilla save state, the currently-displayed menu won't reflect the AP
+    // save until the game re-reads save status (return-to-menu).
+    if (onTitleScreen_)
+    {
+        wolf::logWarning("[SaveMan] Steam redirect activated while on title screen. The title menu was "
+                         "already populated with vanilla save state and will not reflect the AP save until "
+                         "the game re-reads save status. Return to menu to re-read.");
+    }
+}
+
+void SaveMan::onPlayStart()
+{
+    // The Steam redirect and the FUN_18014f580 / FUN_18014e100 hooks handle
+    // data injection; we just track "we're in an AP gameplay session".
+    if (isConnected())
+        setApModeActive(true);
+}
+
+void SaveMan::onReturnToMenu()
+{
+    setApModeActive(false);
+
+    // activateRedirect() compacts the save; the writer must not be appending to it
+    waitForSaves();
+
+    // Re-point the redirect at the live connection's save so the title menu
+    // reads the right file, or drop it if the slot went away mid-session.
+    std::string path = getSavePath();
+    if (path.empty())
+        deactivateRedirect();
+    else
+        activateRedirect(path);
+}
+
 void SaveMan::activateRedirect(const std::string &path)
 {
+    // The game reads the file directly through the redirect, so finish any
+    // slot write a crash interrupted and fold in the delta log before it
+    // gets the chance
+    SaveStore store(path);
+    if (!store.compact())
+        wolf::logError("[SaveMan] Failed to compact %s; the game will load an older save", path.c_str());
+
     std::scoped_lock lock(g_redirectMutex);
     g_redirectPath = path;
     wolf::logInfo("[SaveMan] Steam redirect activated: %s", path.c_str());
@@ -2,11 +2,17 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <okami/savefile.hpp>
 
+#include "lifecycle.h"
+#include "savehistory.h"
+#include "savewriter.h"
+
 class ISocket;
 
 /**
@@ -15,6 +21,9 @@ class ISocket;
  * Reads/writes game state directly from/to the 6 known memory regions,
  * completely bypassing the game's Steam Cloud save pipeline.
  * AP saves are stored as single-slot .oksav files in %APPDATA%/okami-apsaves/.
+ *
+ * The Steam redirect and AP mode follow lifecycle events: Connected points the
+ * redirect at the slot's save, PlayStart enters AP mode, ReturnToMenu leaves it.
  */
 class SaveMan
 {
@@ -27,7 +36,8 @@ class SaveMan
 
     // === Core save/load ===
 
-    /// Snapshot all 6 memory regions, compute checksum, write to AP file
+    /// Snapshot all 6 memory regions, compute checksum, write to AP file.
+    /// Goes through the background writer like auto-saves, but waits for it.
     [[nodiscard]] bool saveGameState();
 
     /// Read AP file, verify checksum, write all 6 memory regions back.
@@ -44,6 +54,17 @@ class SaveMan
     /// Delete the AP save for the current connection
     [[nodiscard]] bool deleteSave();
 
+    // === Save history ===
+
+    /// Snapshots in the current save's rollback history, newest first.
+    [[nodiscard]] std::vector<SaveHistory::Entry> listHistory();
+
+    /// Load history snapshot sequence of the current save and hand it to the
+    /// game tick, which applies it to the running game as soon as
+    /// isSafeToSave() holds and then saves it. Returns false if the snapshot
+    /// cannot be loaded.
+    [[nodiscard]] bool restoreFromHistory(uint64_t sequence);
+
     // === AP mode management ===
 
     bool isApModeActive() const;
@@ -55,9 +76,14 @@ class SaveMan
     /// Queue an auto-save (called after check send)
     void queueAutoSave();
 
-    /// Process pending auto-save with debounce (called from game tick)
+    /// Process pending auto-save with debounce (called from game tick).
+    /// Only snapshots game state; the file is written on the writer thread.
     void processAutoSave();
 
+    /// Block until every submitted save is on disk and its result handled.
+    /// Returns false if any of them failed.
+    bool waitForSaves();
+
     /// Returns true iff the current game state is safe to snapshot to disk:
     /// AP mode active, not on title screen, no save/load/area-load in flight.
     /// Used by processAutoSave to defer saves that would race with the engine.
@@ -92,20 +118,34 @@ class SaveMan
   private:
     ISocket &socket_;
     std::atomic<bool> apModeActive_{false};
+    std::atomic<bool> onTitleScreen_{false};
     bool initialized_ = false;
     uintptr_t moduleBase_ = 0;
 
     /// Install pass-through hooks on ISteamRemoteStorage vtable methods.
     void installSteamRedirect();
 
+    // === Lifecycle handlers ===
+    void onConnected();
+    void onPlayStart();
+    void onReturnToMenu();
+    std::vector<lifecycle::Subscription> subscriptions_;
+
     // === Memory snapshot helpers ===
+    /// Copy game state into slot and set its checksum, folded in during the copy.
     void snapshotToSlot(okami::SaveSlot &slot);
 
-    /// Test-only. Production loads are serviced by hookOkamiPureRead.
+    /// Write slot's game state regions into game memory. Save loads are
+    /// serviced by hookOkamiPureRead; this applies history restores live.
     void restoreFromSlot(const okami::SaveSlot &slot);
 
     // === File I/O ===
-    [[nodiscard]] bool writeSlotToFile(const okami::SaveSlot &slot);
+    /// Snapshot into a writer buffer and queue it. Returns false if there is no
+    /// save path.
+    [[nodiscard]] bool submitSave();
+
+    /// Log the writer's finished saves. Returns false if any of them failed.
+    bool handleSaveResults();
 
     /// Read AP save from .oksav file into slot.
     /// Test-only. Production loads are serviced by hookOkamiPureRead.
@@ -127,4 +167,18 @@ class SaveMan
     uintptr_t mapDataAddr_ = 0;
     uintptr_t dialogBitsAddr_ = 0;
     uintptr_t customTexturesAddr_ = 0;
+
+    // === Save history ===
+    void handleHistoryCommand(const std::vector<std::string> &args);
+    /// Apply a restore handed over by restoreFromHistory(). Game tick only.
+    void applyPendingRestore();
+    std::unique_ptr<okami::SaveSlot> pendingRestore_; // guarded by restoreMutex_
+    std::string pendingRestorePath_;
+    uint64_t pendingRestoreSequence_ = 0;
+    std::mutex restoreMutex_;
+    SaveHistory history_;
+
+    // Declared last so it is destroyed first, flushing queued saves.
+    // Every committed save is also recorded in history_.
+    SaveWriter writer_{[this](const std::string &path, const okami::SaveSlot &slot) { history_.add(path, slot); }};
 };
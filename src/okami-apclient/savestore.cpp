@@ -0,0 +1,556 @@
+#include "savestore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <okami/contenthash.hpp>
+#include <wolf_framework.hpp>
+
+namespace
+{
+
+constexpr uint32_t kJournalMagic = 0x4A534B4F; // "OKSJ"
+constexpr uint32_t kJournalVersion = 1;
+
+struct JournalHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t slotHash; // contentHash of the slot that follows
+};
+static_assert(sizeof(JournalHeader) == 16);
+
+constexpr size_t kJournalSize = sizeof(JournalHeader) + sizeof(okami::SaveSlot);
+
+constexpr uint32_t kDeltaMagic = 0x44534B4F; // "OKSD"
+constexpr uint32_t kDeltaVersion = 1;
+constexpr uint32_t kRecordMagic = 0x52534B4F; // "OKSR"
+
+struct DeltaHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t baseHash; // contentHash of the slot 0 the log was started on
+};
+static_assert(sizeof(DeltaHeader) == 16);
+
+/// One save: payloadSize bytes of runs follow, each a DeltaRun and its qwords.
+struct RecordHeader
+{
+    uint32_t magic;
+    uint32_t payloadSize;
+    uint64_t payloadHash; // contentHash of the payload
+};
+static_assert(sizeof(RecordHeader) == 16);
+
+struct DeltaRun
+{
+    uint32_t first; // qword index into the slot
+    uint32_t count;
+};
+static_assert(sizeof(DeltaRun) == 8);
+
+constexpr size_t kSlotQwords = sizeof(okami::SaveSlot) / sizeof(uint64_t);
+static_assert(sizeof(okami::SaveSlot) % sizeof(uint64_t) == 0);
+
+/// Changed runs this close together are merged: an unchanged qword costs no
+/// more than the header of a new run.
+constexpr size_t kRunMergeGap = 1;
+
+/// Build a record of the qword runs where slot differs from previous. Empty if nothing changed.
+std::vector<uint8_t> buildDeltaRecord(const okami::SaveSlot &previous, const okami::SaveSlot &slot)
+{
+    const auto *before = reinterpret_cast<const uint64_t *>(&previous);
+    const auto *after = reinterpret_cast<const uint64_t *>(&slot);
+
+    std::vector<uint8_t> record(sizeof(RecordHeader));
+    size_t i = 0;
+    while (i < kSlotQwords)
+    {
+        if (before[i] == after[i])
+        {
+            ++i;
+            continue;
+        }
+
+        // Extend the run over changed qwords and short unchanged gaps
+        size_t end = i + 1;
+        for (size_t gap = 0; end + gap < kSlotQwords && gap <= kRunMergeGap;)
+        {
+            if (before[end + gap] != after[end + gap])
+            {
+                end += gap + 1;
+                gap = 0;
+            }
+            else
+            {
+                ++gap;
+            }
+        }
+
+        const DeltaRun run{static_cast<uint32_t>(i), static_cast<uint32_t>(end - i)};
+        const size_t at = record.size();
+        record.resize(at + sizeof(run) + run.count * sizeof(uint64_t));
+        std::memcpy(record.data() + at, &run, sizeof(run));
+        std::memcpy(record.data() + at + sizeof(run), after + i, run.count * sizeof(uint64_t));
+        i = end;
+    }
+
+    if (record.size() == sizeof(RecordHeader))
+        return {};
+
+    const std::span<const uint8_t> payload(record.begin() + sizeof(RecordHeader), record.end());
+    const RecordHeader header{kRecordMagic, static_cast<uint32_t>(payload.size()), okami::contentHash(payload)};
+    std::memcpy(record.data(), &header, sizeof(header));
+    return record;
+}
+
+/// Apply a record's runs to slot. False, leaving slot untouched, if any run is malformed.
+bool applyDeltaRecord(std::span<const uint8_t> payload, okami::SaveSlot &slot)
+{
+    // Validate every run before touching the slot
+    for (size_t at = 0; at < payload.size();)
+    {
+        DeltaRun run;
+        if (payload.size() - at < sizeof(run))
+            return false;
+        std::memcpy(&run, payload.data() + at, sizeof(run));
+        if (run.count == 0 || run.first >= kSlotQwords || run.count > kSlotQwords - run.first || (payload.size() - at - sizeof(run)) / sizeof(uint64_t) < run.count)
+            return false;
+        at += sizeof(run) + run.count * sizeof(uint64_t);
+    }
+
+    auto *qwords = reinterpret_cast<uint64_t *>(&slot);
+    for (size_t at = 0; at < payload.size();)
+    {
+        DeltaRun run;
+        std::memcpy(&run, payload.data() + at, sizeof(run));
+        std::memcpy(qwords + run.first, payload.data() + at + sizeof(run), run.count * sizeof(uint64_t));
+        at += sizeof(run) + run.count * sizeof(uint64_t);
+    }
+    return true;
+}
+
+std::span<const uint8_t> slotBytes(const okami::SaveSlot &slot)
+{
+    return {reinterpret_cast<const uint8_t *>(&slot), sizeof(slot)};
+}
+
+/// Unbuffered file with positioned I/O and a real sync, which fstream lacks.
+class NativeFile
+{
+  public:
+    enum class Mode
+    {
+        Existing, // open read/write, fail if missing
+        Truncate, // create or truncate for writing
+    };
+
+    NativeFile() = default;
+    NativeFile(const NativeFile &) = delete;
+    NativeFile &operator=(const NativeFile &) = delete;
+
+    ~NativeFile()
+    {
+        close();
+    }
+
+    bool open(const std::string &path, Mode mode)
+    {
+        close();
+#ifdef _WIN32
+        const DWORD disposition = mode == Mode::Existing ? OPEN_EXISTING : CREATE_ALWAYS;
+        handle_ = CreateFileW(std::filesystem::path(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        const int flags = mode == Mode::Existing ? O_RDWR : (O_RDWR | O_CREAT | O_TRUNC);
+        fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+#endif
+    }
+
+    void close() noexcept
+    {
+#ifdef _WIN32
+        if (handle_ != INVALID_HANDLE_VALUE)
+            CloseHandle(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+#endif
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size)
+    {
+        const auto *p = static_cast<const uint8_t *>(data);
+        while (size > 0)
+        {
+#ifdef _WIN32
+            OVERLAPPED at{};
+            at.Offset = static_cast<DWORD>(offset);
+            at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD written = 0;
+            const auto request = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            if (!WriteFile(handle_, p, request, &written, &at) || written == 0)
+                return false;
+#else
+            const ssize_t written = ::pwrite(fd_, p, size, static_cast<off_t>(offset));
+            if (written <= 0)
+                return false;
+#endif
+            p += written;
+            offset += static_cast<uint64_t>(written);
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readAt(uint64_t offset, void *data, size_t size) const
+    {
+        auto *p = static_cast<uint8_t *>(data);
+        while (size > 0)
+        {
+#ifdef _WIN32
+            OVERLAPPED at{};
+            at.Offset = static_cast<DWORD>(offset);
+            at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD read = 0;
+            const auto request = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            if (!ReadFile(handle_, p, request, &read, &at) || read == 0)
+                return false;
+#else
+            const ssize_t read = ::pread(fd_, p, size, static_cast<off_t>(offset));
+            if (read <= 0)
+                return false;
+#endif
+            p += read;
+            offset += static_cast<uint64_t>(read);
+            size -= static_cast<size_t>(read);
+        }
+        return true;
+    }
+
+    /// Flush to the device, not just the OS cache.
+    bool sync()
+    {
+#ifdef _WIN32
+        return FlushFileBuffers(handle_) != 0;
+#else
+        return ::fsync(fd_) == 0;
+#endif
+    }
+
+  private:
+#ifdef _WIN32
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+};
+
+bool isFullSaveFile(const std::string &path)
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return !ec && size == sizeof(okami::SaveFile);
+}
+
+} // namespace
+
+std::string SaveStore::journalPath(const std::string &path)
+{
+    return path + ".journal";
+}
+
+std::string SaveStore::deltaPath(const std::string &path)
+{
+    return path + ".delta";
+}
+
+bool SaveStore::writeSlot(const okami::SaveSlot &slot)
+{
+    const bool ok = isFullSaveFile(path_) ? writeJournal(slot) && writeInPlace(slot) : createFile(slot);
+    if (!ok)
+        return false;
+
+    // The slot is durable in the file; the journal is no longer needed, and a
+    // delta log is superseded (one left by a crash here no longer matches slot 0)
+    std::error_code ec;
+    std::filesystem::remove(journalPath(path_), ec);
+    std::filesystem::remove(deltaPath(path_), ec);
+    ++stats_.writes;
+    return true;
+}
+
+bool SaveStore::replaceFile(const void *data, size_t size)
+{
+    // Neither a journal nor a delta log describes the new file
+    std::error_code ec;
+    std::filesystem::remove(journalPath(path_), ec);
+    if (!writeWholeFile(data, size))
+        return false;
+    std::filesystem::remove(deltaPath(path_), ec);
+    return true;
+}
+
+bool SaveStore::appendDelta(const okami::SaveSlot &previous, const okami::SaveSlot &slot)
+{
+    const std::vector<uint8_t> record = buildDeltaRecord(previous, slot);
+    if (record.empty())
+        return true;
+
+    const std::string delta = deltaPath(path_);
+    NativeFile file;
+    uint64_t offset = deltaSize();
+    if (offset < sizeof(DeltaHeader))
+    {
+        // Only start a log on top of the slot 0 the caller thinks it has
+        auto base = std::make_unique<okami::SaveSlot>();
+        if (!readBase(*base) || std::memcmp(base.get(), &previous, sizeof(previous)) != 0)
+            return false;
+
+        const DeltaHeader header{kDeltaMagic, kDeltaVersion, okami::contentHash(slotBytes(previous))};
+        if (!file.open(delta, NativeFile::Mode::Truncate) || !file.writeAt(0, &header, sizeof(header)))
+        {
+            wolf::logError("[SaveStore] Write error to %s", delta.c_str());
+            return false;
+        }
+        stats_.bytesWritten += sizeof(header);
+        offset = sizeof(header);
+    }
+    else if (!file.open(delta, NativeFile::Mode::Existing))
+    {
+        wolf::logError("[SaveStore] Failed to open %s", delta.c_str());
+        return false;
+    }
+
+    // A record torn by a crash fails its hash and ends the replay there
+    if (!file.writeAt(offset, record.data(), record.size()) || !file.sync())
+    {
+        wolf::logError("[SaveStore] Write error to %s", delta.c_str());
+        return false;
+    }
+    stats_.bytesWritten += record.size();
+    ++stats_.deltaAppends;
+    return true;
+}
+
+uint64_t SaveStore::deltaSize() const
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(deltaPath(path_), ec);
+    return ec ? 0 : size;
+}
+
+bool SaveStore::compact()
+{
+    if (!recover())
+        return false;
+
+    std::error_code ec;
+    if (!std::filesystem::exists(deltaPath(path_), ec))
+        return true;
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    if (!readBase(*slot))
+        return false;
+    if (replayDelta(*slot) == 0)
+    {
+        std::filesystem::remove(deltaPath(path_), ec);
+        return true;
+    }
+    return writeSlot(*slot);
+}
+
+bool SaveStore::readSlot(okami::SaveSlot &slot)
+{
+    recover();
+    if (!readBase(slot))
+        return false;
+    replayDelta(slot);
+    return true;
+}
+
+bool SaveStore::readBase(okami::SaveSlot &slot) const
+{
+    if (!isFullSaveFile(path_))
+        return false;
+
+    NativeFile file;
+    return file.open(path_, NativeFile::Mode::Existing) && file.readAt(0, &slot, sizeof(slot));
+}
+
+size_t SaveStore::replayDelta(okami::SaveSlot &slot) const
+{
+    const std::string delta = deltaPath(path_);
+    const uint64_t size = deltaSize();
+    if (size == 0)
+        return 0;
+
+    std::vector<uint8_t> log(size);
+    NativeFile file;
+    DeltaHeader header{};
+    if (size < sizeof(header) || !file.open(delta, NativeFile::Mode::Existing) || !file.readAt(0, log.data(), log.size()))
+        return 0;
+    std::memcpy(&header, log.data(), sizeof(header));
+    if (header.magic != kDeltaMagic || header.version != kDeltaVersion || header.baseHash != okami::contentHash(slotBytes(slot)))
+    {
+        wolf::logWarning("[SaveStore] Ignoring delta log %s: it was not started on the current slot 0", delta.c_str());
+        return 0;
+    }
+
+    size_t applied = 0;
+    size_t at = sizeof(header);
+    while (log.size() - at >= sizeof(RecordHeader))
+    {
+        RecordHeader record;
+        std::memcpy(&record, log.data() + at, sizeof(record));
+        if (record.magic != kRecordMagic || record.payloadSize > log.size() - at - sizeof(record))
+            break;
+
+        const std::span<const uint8_t> payload(log.data() + at + sizeof(record), record.payloadSize);
+        if (record.payloadHash != okami::contentHash(payload) || !applyDeltaRecord(payload, slot))
+            break;
+        at += sizeof(record) + record.payloadSize;
+        ++applied;
+    }
+
+    if (at != log.size())
+        wolf::logWarning("[SaveStore] Ignoring a torn record at the end of %s", delta.c_str());
+    return applied;
+}
+
+bool SaveStore::recover()
+{
+    const std::string journal = journalPath(path_);
+    std::error_code ec;
+    if (!std::filesystem::exists(journal, ec))
+        return true;
+
+    // Only a journal that was completely written and synced matches its hash
+    auto slot = std::make_unique<okami::SaveSlot>();
+    JournalHeader header{};
+    NativeFile file;
+    const bool complete = std::filesystem::file_size(journal, ec) == kJournalSize && !ec && file.open(journal, NativeFile::Mode::Existing) &&
+                          file.readAt(0, &header, sizeof(header)) && file.readAt(sizeof(header), slot.get(), sizeof(*slot)) &&
+                          header.magic == kJournalMagic && header.version == kJournalVersion && header.slotHash == okami::contentHash(slotBytes(*slot));
+    file.close();
+
+    if (!complete)
+    {
+        wolf::logWarning("[SaveStore] Dropping torn journal %s; slot 0 was not modified", journal.c_str());
+        std::filesystem::remove(journal, ec);
+        return true;
+    }
+
+    wolf::logWarning("[SaveStore] Replaying journal left by an interrupted save: %s", journal.c_str());
+    const bool applied = isFullSaveFile(path_) ? writeInPlace(*slot) : createFile(*slot);
+    if (!applied)
+    {
+        wolf::logError("[SaveStore] Failed to replay journal into %s", path_.c_str());
+        return false;
+    }
+    std::filesystem::remove(journal, ec);
+    return true;
+}
+
+bool SaveStore::remove()
+{
+    std::error_code ec;
+    std::filesystem::remove(journalPath(path_), ec);
+    std::filesystem::remove(deltaPath(path_), ec);
+    return std::filesystem::remove(path_, ec);
+}
+
+bool SaveStore::createFile(const okami::SaveSlot &slot)
+{
+    // Game's empty-slot format: all zeros except areaNameStrId = 0xFFFFFFFF per slot.
+    // Heap-allocated: the file is ~2.8 MB.
+    auto saveFile = std::make_unique<okami::SaveFile>();
+    std::memset(saveFile.get(), 0, sizeof(okami::SaveFile));
+    for (auto &empty : saveFile->slots)
+        empty.areaNameStrId = 0xFFFFFFFF;
+    saveFile->slots[0] = slot;
+
+    // A journal from before the file was (re)created must never be replayed over it
+    std::error_code ec;
+    std::filesystem::remove(journalPath(path_), ec);
+
+    if (!writeWholeFile(saveFile.get(), sizeof(okami::SaveFile)))
+        return false;
+    ++stats_.fullRewrites;
+    return true;
+}
+
+bool SaveStore::writeWholeFile(const void *data, size_t size)
+{
+    std::error_code ec;
+    const std::string tmpPath = path_ + ".tmp";
+    {
+        NativeFile tmp;
+        if (!tmp.open(tmpPath, NativeFile::Mode::Truncate) || !tmp.writeAt(0, data, size) || !tmp.sync())
+        {
+            wolf::logError("[SaveStore] Write error to %s", tmpPath.c_str());
+            tmp.close();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    stats_.bytesWritten += size;
+
+    std::filesystem::rename(tmpPath, path_, ec);
+    if (ec)
+    {
+        wolf::logError("[SaveStore] Failed to rename %s -> %s: %s", tmpPath.c_str(), path_.c_str(), ec.message().c_str());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool SaveStore::writeJournal(const okami::SaveSlot &slot)
+{
+    const std::string journal = journalPath(path_);
+    const JournalHeader header{kJournalMagic, kJournalVersion, okami::contentHash(slotBytes(slot))};
+
+    NativeFile file;
+    if (!file.open(journal, NativeFile::Mode::Truncate) || !file.writeAt(0, &header, sizeof(header)) || !file.writeAt(sizeof(header), &slot, sizeof(slot)) ||
+        !file.sync())
+    {
+        wolf::logError("[SaveStore] Write error to %s", journal.c_str());
+        return false;
+    }
+    stats_.bytesWritten += kJournalSize;
+    return true;
+}
+
+bool SaveStore::writeInPlace(const okami::SaveSlot &slot)
+{
+    NativeFile file;
+    if (!file.open(path_, NativeFile::Mode::Existing) || !file.writeAt(0, &slot, sizeof(slot)) || !file.sync())
+    {
+        // A synced journal is left behind for recover()
+        wolf::logError("[SaveStore] Write error to slot 0 of %s", path_.c_str());
+        return false;
+    }
+    stats_.bytesWritten += sizeof(slot);
+    return true;
+}
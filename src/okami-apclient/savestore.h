@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <okami/savefile.hpp>
+
+/**
+ * @brief Slot-0 storage for an AP .oksav file
+ *
+ * The file keeps the game's 30-slot layout so the game can read it, but AP
+ * only ever uses slot 0. The first write creates the whole file (through
+ * .tmp + rename). Every later write replaces just the 0x172A0-byte slot in
+ * place instead of reading and rewriting all 2.8 MB.
+ *
+ * A slot journal next to the file keeps in-place writes crash safe. The new
+ * slot goes to <path>.journal first, with a content hash, and is synced. Only
+ * then is slot 0 overwritten and synced, and the journal removed. recover()
+ * (also run by readSlot()) replays a complete journal left behind by a crash
+ * mid-write and drops a torn one, in which case slot 0 was never touched.
+ *
+ * Saves that change only a few bytes can go to a delta log instead
+ * (<path>.delta): appendDelta() appends just the qword runs that differ from
+ * the previous save as one hashed, synced record. The log is bound to the
+ * slot 0 it was started on by that slot's hash, and readSlot() replays its
+ * complete records over slot 0. compact() folds the log into slot 0. The game
+ * reads the file itself, so the log must be compacted before it does.
+ *
+ * Stateless apart from the counters, so a store can be made per call.
+ */
+class SaveStore
+{
+  public:
+    /// I/O counters since construction.
+    struct Stats
+    {
+        uint64_t writes = 0;        // successful writeSlot() calls
+        uint64_t fullRewrites = 0;  // writes that had to create the whole file
+        uint64_t deltaAppends = 0;  // successful appendDelta() calls that wrote a record
+        uint64_t bytesWritten = 0;  // file, journal, delta log and .tmp bytes combined
+    };
+
+    explicit SaveStore(std::string path) : path_(std::move(path))
+    {
+    }
+
+    [[nodiscard]] const std::string &path() const noexcept
+    {
+        return path_;
+    }
+
+    /// Slot journal used while slot 0 is rewritten in place.
+    [[nodiscard]] static std::string journalPath(const std::string &path);
+
+    /// Delta log of saves not yet folded into slot 0.
+    [[nodiscard]] static std::string deltaPath(const std::string &path);
+
+    /// Write slot 0. Creates the 30-slot file, with the game's empty-slot
+    /// format for slots 1-29, when it is missing or not a full save file.
+    /// Supersedes and removes any delta log.
+    [[nodiscard]] bool writeSlot(const okami::SaveSlot &slot);
+
+    /// Replace the whole file with a save file written elsewhere (the game's own
+    /// save through the redirect). Supersedes and removes any journal and delta log.
+    [[nodiscard]] bool replaceFile(const void *data, size_t size);
+
+    /// Append the qwords where slot differs from previous to the delta log.
+    /// previous must be what the file and log currently hold; a new log is
+    /// only started after checking it against slot 0 on disk. Returns false,
+    /// leaving the caller to fall back to writeSlot(), if it is not.
+    [[nodiscard]] bool appendDelta(const okami::SaveSlot &previous, const okami::SaveSlot &slot);
+
+    /// Size of the delta log in bytes, 0 if there is none.
+    [[nodiscard]] uint64_t deltaSize() const;
+
+    /// Fold the delta log into slot 0 and remove it.
+    [[nodiscard]] bool compact();
+
+    /// Read slot 0 after recover(), with the delta log replayed over it.
+    /// Fails if the file is missing or not a full save file.
+    [[nodiscard]] bool readSlot(okami::SaveSlot &slot);
+
+    /// Replay a complete leftover journal into the file, or drop a torn one.
+    /// Returns false only if a complete journal could not be applied.
+    bool recover();
+
+    /// Delete the file, any journal and any delta log. Returns true if the file existed.
+    bool remove();
+
+    [[nodiscard]] const Stats &stats() const noexcept
+    {
+        return stats_;
+    }
+
+  private:
+    [[nodiscard]] bool createFile(const okami::SaveSlot &slot);
+    /// Write data to <path>.tmp, sync it and rename it over the file.
+    [[nodiscard]] bool writeWholeFile(const void *data, size_t size);
+    [[nodiscard]] bool writeJournal(const okami::SaveSlot &slot);
+    [[nodiscard]] bool writeInPlace(const okami::SaveSlot &slot);
+    [[nodiscard]] bool readBase(okami::SaveSlot &slot) const;
+    /// Apply the complete records of a delta log started on slot. Returns the number applied.
+    size_t replayDelta(okami::SaveSlot &slot) const;
+
+    std::string path_;
+    Stats stats_;
+};
@@ -0,0 +1,190 @@
+#include "savewriter.h"
+
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <utility>
+
+#include <wolf_framework.hpp>
+
+#include "savestore.h"
+
+SaveWriter::SaveWriter(CommitCallback onCommit) : onCommit_(std::move(onCommit))
+{
+    // Zeroed once: snapshots rewrite the same fields every time, so nothing
+    // stale survives in a reused buffer and the tick never has to clear one
+    for (auto &buffer : buffers_)
+    {
+        buffer.slot = std::make_unique<okami::SaveSlot>();
+        std::memset(buffer.slot.get(), 0, sizeof(okami::SaveSlot));
+    }
+    committed_ = std::make_unique<okami::SaveSlot>();
+    std::memset(committed_.get(), 0, sizeof(okami::SaveSlot));
+    thread_ = std::thread([this] { run(); });
+}
+
+SaveWriter::~SaveWriter()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+SaveWriter::Buffer &SaveWriter::acquire()
+{
+    std::unique_lock lock(mutex_);
+
+    // Refilling a queued buffer drops that save in favour of this newer one.
+    // Only when another thread is filling one buffer while the writer holds
+    // the other is there nothing to take until the writer is done.
+    Buffer *target = nullptr;
+    idle_.wait(lock,
+               [&]
+               {
+                   target = nullptr;
+                   for (auto &buffer : buffers_)
+                   {
+                       if (buffer.state != State::Writing && buffer.state != State::Filling && (!target || buffer.state == State::Queued))
+                           target = &buffer;
+                   }
+                   return target != nullptr;
+               });
+    target->state = State::Filling;
+    return *target;
+}
+
+uint64_t SaveWriter::publish(Buffer &buffer, std::string path)
+{
+    uint64_t id = 0;
+    {
+        std::scoped_lock lock(mutex_);
+        id = nextId_++;
+        buffer.path = std::move(path);
+        buffer.id = id;
+        buffer.state = State::Queued;
+    }
+    wake_.notify_one();
+    idle_.notify_all();
+    return id;
+}
+
+std::vector<SaveWriter::Result> SaveWriter::takeResults()
+{
+    std::scoped_lock lock(mutex_);
+    std::vector<Result> results(std::make_move_iterator(results_.begin()), std::make_move_iterator(results_.end()));
+    results_.clear();
+    return results;
+}
+
+void SaveWriter::waitIdle()
+{
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return !busy(); });
+}
+
+bool SaveWriter::busy() const
+{
+    for (const auto &buffer : buffers_)
+    {
+        if (buffer.state == State::Queued || buffer.state == State::Writing)
+            return true;
+    }
+    return false;
+}
+
+void SaveWriter::run()
+{
+    std::unique_lock lock(mutex_);
+    for (;;)
+    {
+        Buffer *job = nullptr;
+        wake_.wait(lock,
+                   [&]
+                   {
+                       for (auto &buffer : buffers_)
+                       {
+                           if (buffer.state == State::Queued && (!job || buffer.id < job->id))
+                               job = &buffer;
+                       }
+                       return job != nullptr || stopping_;
+                   });
+        if (!job)
+        {
+            // Stopping with nothing queued: leave the file whole for the next session
+            lock.unlock();
+            compactCommitted();
+            return;
+        }
+
+        job->state = State::Writing;
+        lock.unlock();
+
+        const bool ok = write(*job);
+
+        lock.lock();
+        results_.push_back({job->id, job->path, ok});
+        job->state = State::Free;
+        idle_.notify_all();
+    }
+}
+
+bool SaveWriter::write(Buffer &job)
+{
+    try
+    {
+        SaveStore store(job.path);
+        bool ok = false;
+        if (committedPath_ == job.path)
+        {
+            ok = store.appendDelta(*committed_, *job.slot);
+            if (ok && store.deltaSize() >= kCompactBytes && !store.compact())
+                wolf::logWarning("[SaveWriter] Failed to compact %s; the delta log keeps growing", job.path.c_str());
+        }
+        if (!ok)
+        {
+            std::filesystem::create_directories(std::filesystem::path(job.path).parent_path());
+            ok = store.writeSlot(*job.slot);
+        }
+
+        if (!ok)
+        {
+            committedPath_.clear();
+            return false;
+        }
+
+        // The written buffer becomes the committed slot and vice versa; the
+        // game thread never sees a buffer while it is Writing
+        std::swap(job.slot, committed_);
+        committedPath_ = job.path;
+        if (onCommit_)
+            onCommit_(committedPath_, *committed_);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        wolf::logError("[SaveWriter] Exception writing save: %s", e.what());
+        committedPath_.clear();
+        return false;
+    }
+}
+
+void SaveWriter::compactCommitted()
+{
+    if (committedPath_.empty())
+        return;
+
+    try
+    {
+        SaveStore store(committedPath_);
+        if (!store.compact())
+            wolf::logError("[SaveWriter] Failed to compact %s", committedPath_.c_str());
+    }
+    catch (const std::exception &e)
+    {
+        wolf::logError("[SaveWriter] Exception compacting save: %s", e.what());
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <okami/savefile.hpp>
+
+/**
+ * @brief Background writer for AP saves
+ *
+ * The game thread only copies game state into one of two preallocated slot
+ * buffers, checksum included; a writer thread does all file I/O (directory
+ * creation, the SaveStore write and its syncs), so a disk stall
+ * never reaches the frame. One buffer can be queued while the other is being
+ * written. A save submitted while another is still queued replaces it, since
+ * the newer snapshot supersedes the older one. Several threads may submit:
+ * a buffer being filled is never handed out twice, and a submitter that
+ * finds none available waits for one. Queued saves are written oldest first.
+ *
+ * The writer keeps the last slot it committed. A save to the same file only
+ * appends the qwords that changed since then to SaveStore's delta log, which
+ * is folded into the file once it reaches kCompactBytes and again when the
+ * writer shuts down. Any other save, or a failed append, writes the full slot.
+ *
+ * Outcomes come back through takeResults(), polled from the game thread.
+ * The destructor finishes any queued save and compacts before joining the thread.
+ */
+class SaveWriter
+{
+  public:
+    struct Result
+    {
+        uint64_t id;
+        std::string path;
+        bool ok;
+    };
+
+    /// Delta log size at which it is folded into the save file: one slot's worth.
+    static constexpr uint64_t kCompactBytes = sizeof(okami::SaveSlot);
+
+    /// Called on the writer thread after each successful write, with the slot now in the file.
+    using CommitCallback = std::function<void(const std::string &path, const okami::SaveSlot &slot)>;
+
+    explicit SaveWriter(CommitCallback onCommit = {});
+    ~SaveWriter();
+
+    SaveWriter(const SaveWriter &) = delete;
+    SaveWriter &operator=(const SaveWriter &) = delete;
+
+    /// Let fill copy a complete slot, checksum included, into a free buffer on
+    /// the calling thread, then queue the buffer for writing to path. Returns the save's id.
+    template <typename Fill> uint64_t submit(std::string path, Fill &&fill)
+    {
+        Buffer &buffer = acquire();
+        fill(*buffer.slot);
+        return publish(buffer, std::move(path));
+    }
+
+    /// Finished saves since the last call, oldest first.
+    [[nodiscard]] std::vector<Result> takeResults();
+
+    /// Block until nothing is queued or being written.
+    void waitIdle();
+
+  private:
+    enum class State
+    {
+        Free,
+        Filling, // owned by the submitting thread
+        Queued,
+        Writing, // owned by the writer thread
+    };
+
+    struct Buffer
+    {
+        std::unique_ptr<okami::SaveSlot> slot;
+        State state = State::Free;
+        std::string path;
+        uint64_t id = 0;
+    };
+
+    Buffer &acquire();
+    uint64_t publish(Buffer &buffer, std::string path);
+    void run();
+    [[nodiscard]] bool write(Buffer &job);
+    void compactCommitted();
+    [[nodiscard]] bool busy() const;
+
+    std::array<Buffer, 2> buffers_;
+    uint64_t nextId_ = 1;
+    std::deque<Result> results_;
+    bool stopping_ = false;
+
+    CommitCallback onCommit_;
+
+    // Writer thread only: the slot the file and its delta log hold
+    std::unique_ptr<okami::SaveSlot> committed_;
+    std::string committedPath_; // empty = nothing committed
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_; // writer: a buffer was queued, or stop
+    std::condition_variable idle_; // waitIdle, acquire: a buffer was queued or a write finished
+    std::thread thread_;
+};
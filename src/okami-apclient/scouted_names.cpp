@@ -0,0 +1,127 @@
+#include "scouted_names.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include <okami/msd.h>
+
+namespace itempatch
+{
+
+namespace
+{
+constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ull; // 2^64 / golden ratio
+} // namespace
+
+size_t ScoutedNamePool::addBatch(std::span<const Name> names)
+{
+    reserve(std::min(maxNames_, size() + names.size()));
+
+    size_t added = 0;
+    for (const auto &[locationId, name] : names)
+    {
+        if (size() >= maxNames_)
+            break;
+        if (insert(locationId, name))
+            ++added;
+    }
+    return added;
+}
+
+bool ScoutedNamePool::add(int64_t locationId, std::string_view name)
+{
+    if (size() >= maxNames_)
+        return false;
+    reserve(size() + 1);
+    return insert(locationId, name);
+}
+
+const uint16_t *ScoutedNamePool::find(int64_t locationId) const noexcept
+{
+    if (slots_.empty())
+        return nullptr;
+    return slots_[slotFor(locationId)].str;
+}
+
+void ScoutedNamePool::reset() noexcept
+{
+    std::ranges::fill(slots_, Slot{});
+    ordinals_.clear();
+    chunk_ = 0;
+    chunkUsed_ = 0;
+    arenaUnits_ = 0;
+}
+
+size_t ScoutedNamePool::slotFor(int64_t locationId) const noexcept
+{
+    // Multiplicative hash, then linear probing to the location or the first empty slot
+    const size_t mask = slots_.size() - 1;
+    size_t i = static_cast<size_t>((static_cast<uint64_t>(locationId) * kHashMultiplier) >> 32) & mask;
+    while (slots_[i].str && slots_[i].locationId != locationId)
+        i = (i + 1) & mask;
+    return i;
+}
+
+bool ScoutedNamePool::insert(int64_t locationId, std::string_view name)
+{
+    Slot &slot = slots_[slotFor(locationId)];
+    if (slot.str)
+        return false; // first registration wins
+
+    slot = Slot{locationId, compile(name)};
+    ordinals_.push_back(slot.str);
+    return true;
+}
+
+void ScoutedNamePool::reserve(size_t names)
+{
+    // Keep the table at most half full so probes stay short
+    const size_t needed = std::bit_ceil(std::max(names, kInitialReserve) * 2);
+    if (slots_.size() >= needed)
+        return;
+
+    std::vector<Slot> old = std::exchange(slots_, std::vector<Slot>(needed));
+    for (const Slot &slot : old)
+    {
+        if (slot.str)
+            slots_[slotFor(slot.locationId)] = slot;
+    }
+    ordinals_.reserve(std::min(needed / 2, maxNames_));
+}
+
+const uint16_t *ScoutedNamePool::compile(std::string_view name)
+{
+    // Reserve the upper bound, then hand back what the encoding didn't use
+    const size_t units = okami::MSDManager::CompiledLength(name);
+    uint16_t *str = allocate(units);
+    const size_t written = okami::MSDManager::CompileStringInto(name, std::span<uint16_t>(str, units));
+    chunkUsed_ -= units - written;
+    arenaUnits_ += written;
+    return str;
+}
+
+uint16_t *ScoutedNamePool::allocate(size_t units)
+{
+    // Fill chunks in order; after a reset the same chunks are reused from the start
+    while (chunk_ < chunks_.size())
+    {
+        Chunk &chunk = chunks_[chunk_];
+        if (units <= chunk.capacity - chunkUsed_)
+        {
+            uint16_t *str = chunk.data.get() + chunkUsed_;
+            chunkUsed_ += units;
+            return str;
+        }
+        ++chunk_;
+        chunkUsed_ = 0;
+    }
+
+    const size_t capacity = std::max(units, kChunkUnits);
+    chunks_.push_back(Chunk{std::make_unique_for_overwrite<uint16_t[]>(capacity), capacity});
+    chunk_ = chunks_.size() - 1;
+    chunkUsed_ = units;
+    return chunks_.back().data.get();
+}
+
+} // namespace itempatch
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace itempatch
+{
+
+/**
+ * @brief Compiled MSD strings for scouted AP item names
+ *
+ * Strings are encoded straight into a chunked UTF-16 arena, so a name is one
+ * contiguous run that never moves once written and no name owns a heap block.
+ * Locations map to their string through a flat open-addressed table of
+ * {location, string} pairs kept at most half full, so a lookup is one hash
+ * and usually one 16-byte slot read. (A sorted index with binary search was
+ * several times slower than the hash map it replaced once a full connect's
+ * names are registered.) Names also get an ordinal in registration order,
+ * which itempatch exposes as virtual MSD string indices.
+ *
+ * The first name registered for a location wins. reset() forgets every name
+ * at once but keeps the arena chunks and index capacity for the next session.
+ */
+class ScoutedNamePool
+{
+  public:
+    using Name = std::pair<int64_t, std::string>;
+
+    /// Arena chunk size in code units (32 KiB). Longer names get a chunk of their own.
+    static constexpr size_t kChunkUnits = 16 * 1024;
+    /// Names the index holds before its first growth: every shop slot plus a full level of containers.
+    static constexpr size_t kInitialReserve = 1024;
+
+    explicit ScoutedNamePool(size_t maxNames) : maxNames_(maxNames)
+    {
+    }
+
+    /**
+     * @brief Compile and index a batch of names, growing the index at most once
+     * @return Number of names added. Locations already registered, repeats
+     *         within the batch and names past maxNames are skipped.
+     */
+    size_t addBatch(std::span<const Name> names);
+
+    /// Register one name. Returns false if the location already has one or the pool is full.
+    bool add(int64_t locationId, std::string_view name);
+
+    /// Compiled name for a location, or nullptr. Never allocates.
+    [[nodiscard]] const uint16_t *find(int64_t locationId) const noexcept;
+
+    /// Compiled name by registration ordinal, or nullptr. Never allocates.
+    [[nodiscard]] const uint16_t *at(size_t ordinal) const noexcept
+    {
+        return ordinal < ordinals_.size() ? ordinals_[ordinal] : nullptr;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return ordinals_.size();
+    }
+
+    [[nodiscard]] size_t maxNames() const noexcept
+    {
+        return maxNames_;
+    }
+
+    /// Arena code units in use, terminators included.
+    [[nodiscard]] size_t arenaUnits() const noexcept
+    {
+        return arenaUnits_;
+    }
+
+    /// Forget every name in one step. Pointers returned earlier must not be
+    /// used afterwards; later names reuse their storage.
+    void reset() noexcept;
+
+  private:
+    struct Slot
+    {
+        int64_t locationId;
+        const uint16_t *str; // nullptr = empty slot
+    };
+
+    struct Chunk
+    {
+        std::unique_ptr<uint16_t[]> data;
+        size_t capacity;
+    };
+
+    [[nodiscard]] size_t slotFor(int64_t locationId) const noexcept;
+    bool insert(int64_t locationId, std::string_view name);
+    void reserve(size_t names);
+    const uint16_t *compile(std::string_view name);
+    uint16_t *allocate(size_t units);
+
+    size_t maxNames_;
+    std::vector<Slot> slots_; // power-of-two size, linear probing
+    std::vector<const uint16_t *> ordinals_;
+    std::vector<Chunk> chunks_;
+    size_t chunk_ = 0;     // chunk currently being filled
+    size_t chunkUsed_ = 0; // code units used in chunks_[chunk_]
+    size_t arenaUnits_ = 0;
+};
+
+} // namespace itempatch
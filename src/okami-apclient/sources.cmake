@@ -3,6 +3,8 @@ set(okami-apclient_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/archipelagosocket.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/checkman.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/checks/brushes.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/checks/check_sources.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/checks/check_trace.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/checks/containers.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/checks/gamestate_monitors.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/checks/shops.cpp
@@ -14,12 +16,18 @@ set(okami-apclient_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/data/shopdata.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/gamestate_accessors.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/itempatch.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/lifecycle.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/okami-apclient.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/rewardman.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/rewards/brushes.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/rewards/event_flags.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/rewards/game_items.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/savechecksum.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/savehistory.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/saveman.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/savestore.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/savewriter.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/scouted_names.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/slotconfig.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/ui/loginwindow.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/ui/notificationwindow.cpp
@@ -4,11 +4,13 @@
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 #include <wolf_framework.hpp>
 
 #include "../isocket.h"
+#include "../lifecycle.h"
 #include "../saveman.h"
 #include "version.h"
 
@@ -22,6 +24,11 @@ static ISocket *g_socket = nullptr;
 static SaveMan *g_saveMan = nullptr;
 static bool g_visible = true;
 
+// Whether an AP save exists for the current connection. Refreshed on
+// lifecycle events instead of hitting the filesystem every frame.
+static bool g_hasSaveFile = false;
+static std::vector<lifecycle::Subscription> g_subscriptions;
+
 // Connection form data (kept as char arrays for ImGui)
 static char g_server[128] = "archipelago.gg:38281";
 static char g_slot[128] = "";
@@ -45,14 +52,25 @@ static void renderConnectionStatus();
 static void saveConnectionData();
 static void loadConnectionData();
 
+static void refreshSaveFileState()
+{
+    g_hasSaveFile = g_saveMan && g_saveMan->hasSaveFile();
+}
+
 void initialize(ISocket &socket)
 {
     g_socket = &socket;
     loadConnectionData();
+
+    // Saves appear on connect and after gameplay; re-check at those points only.
+    g_subscriptions.push_back(lifecycle::subscribe<lifecycle::Connected>([](const auto &) { refreshSaveFileState(); }));
+    g_subscriptions.push_back(lifecycle::subscribe<lifecycle::ReturnToMenu>([](const auto &) { refreshSaveFileState(); }));
+    g_subscriptions.push_back(lifecycle::subscribe<lifecycle::Disconnected>([](const auto &) { g_hasSaveFile = false; }));
 }
 
 void shutdown()
 {
+    g_subscriptions.clear();
     g_socket = nullptr;
     g_saveMan = nullptr;
 }
@@ -60,6 +78,7 @@ void shutdown()
 void setSaveMan(SaveMan *saveMan)
 {
     g_saveMan = saveMan;
+    refreshSaveFileState();
 }
 
 bool isVisible()
@@ -178,7 +197,7 @@ static void renderConnectionForm()
         if (g_saveMan && !g_saveMan->isApModeActive())
         {
             ImGui::Separator();
-            if (g_saveMan->hasSaveFile())
+            if (g_hasSaveFile)
                 ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.2f, 1.0f), "AP save found - pick Continue on the title screen.");
             else
                 ImGui::Text("No AP save yet - start a new game on the title screen.");
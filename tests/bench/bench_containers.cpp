@@ -0,0 +1,49 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "checks/containers.hpp"
+#include "mock_archipelagosocket.h"
+#include "mock_spawntable.h"
+#include "wolf_framework.hpp"
+
+// Per-tick cost of ContainerMan::poll() with a full spawn table of tracked
+// containers, none of which is being collected.
+TEST_CASE("ContainerMan poll with 128 tracked containers", "[benchmark][containers]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(checks::SPAWN_TABLE_OFFSET + sizeof(okami::SpawnTable) + checks::CURRENT_MAP_ID_OFFSET + sizeof(uint16_t));
+
+    mock::MockArchipelagoSocket socket;
+    socket.setConnected(true);
+    socket.setSlotConfig(SlotConfig{.randomizeContainers = true});
+    socket.setSlotConfigReady(true);
+
+    int sent = 0;
+    checks::ContainerMan containerMan(socket, [&](int64_t) { sent++; });
+    containerMan.initialize();
+
+    mock::SpawnTableBuilder builder;
+    for (int i = 0; i < checks::SPAWN_TABLE_ENTRY_COUNT; i++)
+        builder.addContainer(i, 0x42);
+    okami::SpawnTable &table = builder.build();
+
+    using SpawnTablePopulatorFn = void (*)(void *);
+    wolf::mock::triggerHook<SpawnTablePopulatorFn>(checks::SPAWN_TABLE_POPULATOR_OFFSET, &table);
+    std::memcpy(&wolf::mock::mockMemory[checks::SPAWN_TABLE_OFFSET], &table, sizeof(table));
+
+    BENCHMARK("pickup event mode, idle tick")
+    {
+        containerMan.poll();
+    };
+
+    containerMan.setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
+    BENCHMARK("polling fallback, idle tick")
+    {
+        containerMan.poll();
+    };
+
+    CHECK(sent == 0);
+
+    containerMan.shutdown();
+    wolf::mock::reset();
+}
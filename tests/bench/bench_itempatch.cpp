@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <okami/customiconpkg.hpp>
+#include <okami/itemtype.hpp>
+#include <okami/msd.h>
+
+#include "checks/check_types.hpp"
+#include "itempatch.hpp"
+#include "scouted_names.hpp"
+#include "wolf_framework.hpp"
+
+namespace
+{
+
+// The linear lookups the tables replaced, kept as baselines
+int scanIconEntries(int item)
+{
+    const auto &entries = okami::customiconpkg::kIconEntries;
+    for (int i = 0; i < static_cast<int>(entries.size()); ++i)
+    {
+        if (entries[static_cast<size_t>(i)].itemType == item)
+            return i;
+    }
+    return -1;
+}
+
+bool scanDummyStrId(uint16_t index)
+{
+    return std::ranges::any_of(okami::ItemTypes::kApDummyItems, [&](uint16_t t) { return index == t + 294 || index == t + 0x2000; });
+}
+
+const uint16_t kVanillaString[] = {0};
+
+const uint16_t *__fastcall fakeGetMSDString(void *, uint16_t)
+{
+    return kVanillaString;
+}
+
+bool scanDummyItemId(uint32_t itemId)
+{
+    return std::ranges::any_of(okami::ItemTypes::kApDummyItems, [&](uint8_t t) { return static_cast<uint8_t>(itemId) == t; });
+}
+
+} // namespace
+
+// One pass over every item ID, roughly what the inventory and shop UIs ask for
+// when they redraw: an icon, a list string, an info panel string and a model
+// resource name per item.
+TEST_CASE("itempatch per-item lookups", "[benchmark][itempatch]")
+{
+    std::array<int, 256> items{};
+    for (int i = 0; i < 256; ++i)
+        items[static_cast<size_t>(i)] = i;
+
+    BENCHMARK("icon entry: kIconEntries scan")
+    {
+        int sum = 0;
+        for (int item : items)
+            sum += scanIconEntries(item);
+        return sum;
+    };
+
+    BENCHMARK("icon entry: table")
+    {
+        int sum = 0;
+        for (int item : items)
+            sum += okami::customiconpkg::iconEntryIndex(item);
+        return sum;
+    };
+
+    BENCHMARK("dummy strId (list + info panel): any_of")
+    {
+        int count = 0;
+        for (int item : items)
+            count += scanDummyStrId(static_cast<uint16_t>(item + 294)) + scanDummyStrId(static_cast<uint16_t>(item + 0x2000));
+        return count;
+    };
+
+    BENCHMARK("dummy strId (list + info panel): table")
+    {
+        int count = 0;
+        for (int item : items)
+            count += itempatch::isApDummyStrId(static_cast<uint16_t>(item + 294)) + itempatch::isApDummyStrId(static_cast<uint16_t>(item + 0x2000));
+        return count;
+    };
+
+    BENCHMARK("resource name dummy check: scan")
+    {
+        int count = 0;
+        for (int item : items)
+            count += scanDummyItemId(static_cast<uint32_t>(item));
+        return count;
+    };
+
+    BENCHMARK("resource name dummy check: table")
+    {
+        int count = 0;
+        for (int item : items)
+            count += okami::ItemTypes::kIsApDummyItem[static_cast<uint8_t>(item)];
+        return count;
+    };
+
+    CHECK(okami::customiconpkg::iconEntryIndex(okami::ItemTypes::ForeignStandardItem) == scanIconEntries(okami::ItemTypes::ForeignStandardItem));
+}
+
+// The whole GetMSDString detour while a shop is open: AP dummy list strings
+// resolve to the selected slot's scouted name, everything else is remapped
+// or passed through to the original.
+TEST_CASE("itempatch GetMSDString hook in a shop", "[benchmark][itempatch]")
+{
+    using GetMSDStringFn = const uint16_t *(__fastcall *)(void *, uint16_t);
+    constexpr uintptr_t kGetMSDStringOffset = 0x1C8A80;
+
+    wolf::mock::reset();
+    itempatch::resetState();
+    wolf::mock::hookOriginals[kGetMSDStringOffset] = reinterpret_cast<void *>(&fakeGetMSDString);
+    itempatch::initialize();
+    auto getMSDString = reinterpret_cast<GetMSDStringFn>(wolf::mock::registeredHooks.at(kGetMSDStringOffset));
+
+    constexpr int kShopId = 5;
+    std::array<uint8_t, 0x8C> shopBuffer{};
+    shopBuffer[0x8B] = 1;
+    itempatch::registerScoutedItemName(checks::getShopCheckId(kShopId, 1), "Fire Arrow");
+    itempatch::setCurrentShopId(kShopId);
+    itempatch::setShopPointer(shopBuffer.data());
+
+    BENCHMARK("256 list strings + 256 info panel strings")
+    {
+        uintptr_t sum = 0;
+        for (uint16_t item = 0; item < 256; ++item)
+        {
+            sum += reinterpret_cast<uintptr_t>(getMSDString(nullptr, static_cast<uint16_t>(item + 0x2000)));
+            sum += reinterpret_cast<uintptr_t>(getMSDString(nullptr, static_cast<uint16_t>(item + 294)));
+        }
+        return sum;
+    };
+
+    CHECK(getMSDString(nullptr, okami::ItemTypes::ForeignStandardItem + 0x2000) != kVanillaString);
+
+    itempatch::resetState();
+    wolf::mock::reset();
+}
+
+// Scouted name lookups with a full connect's worth of names registered (every
+// shop slot plus the container manifest): the per-name vectors and location
+// hash map the pool replaced, against the pool's flat index.
+TEST_CASE("itempatch scouted name lookups", "[benchmark][itempatch]")
+{
+    constexpr int kShops = 24;
+    constexpr int kSlots = 16;
+    constexpr int kContainerMaps = 60;
+    constexpr int kContainersPerMap = 12;
+
+    std::vector<std::pair<int64_t, std::string>> names;
+    for (int shop = 0; shop < kShops; ++shop)
+        for (int slot = 0; slot < kSlots; ++slot)
+            names.emplace_back(checks::getShopCheckId(shop, slot), "Player " + std::to_string(slot) + "'s Progressive Sword");
+    for (int map = 0; map < kContainerMaps; ++map)
+        for (int idx = 0; idx < kContainersPerMap; ++idx)
+            names.emplace_back(checks::getContainerCheckId(static_cast<uint16_t>(0x100 + map), idx), "Fire Arrow");
+
+    std::vector<std::vector<uint16_t>> strings;
+    std::unordered_map<int64_t, int16_t> locationIndex;
+    for (const auto &[locationId, name] : names)
+    {
+        locationIndex[locationId] = static_cast<int16_t>(0x1000 + strings.size());
+        strings.push_back(okami::MSDManager::CompileString(name));
+    }
+
+    itempatch::ScoutedNamePool pool(0x7000);
+    pool.addBatch(names);
+
+    // Look up in a scattered order, as the UI does across shops and levels
+    std::vector<int64_t> queries;
+    for (size_t i = 0; i < names.size(); ++i)
+        queries.push_back(names[(i * 7919) % names.size()].first);
+
+    BENCHMARK("unordered_map + per-name vectors")
+    {
+        uintptr_t sum = 0;
+        for (int64_t locationId : queries)
+        {
+            auto it = locationIndex.find(locationId);
+            sum += reinterpret_cast<uintptr_t>(strings[static_cast<size_t>(it->second - 0x1000)].data());
+        }
+        return sum;
+    };
+
+    BENCHMARK("ScoutedNamePool::find")
+    {
+        uintptr_t sum = 0;
+        for (int64_t locationId : queries)
+            sum += reinterpret_cast<uintptr_t>(pool.find(locationId));
+        return sum;
+    };
+
+    BENCHMARK("register: per-name vectors")
+    {
+        std::vector<std::vector<uint16_t>> fresh;
+        std::unordered_map<int64_t, int16_t> index;
+        fresh.reserve(1024);
+        index.reserve(1024);
+        for (const auto &[locationId, name] : names)
+        {
+            if (index.contains(locationId))
+                continue;
+            index[locationId] = static_cast<int16_t>(0x1000 + fresh.size());
+            fresh.push_back(okami::MSDManager::CompileString(name));
+        }
+        return fresh.size();
+    };
+
+    BENCHMARK("register: ScoutedNamePool::addBatch")
+    {
+        pool.reset();
+        return pool.addBatch(names);
+    };
+
+    CHECK(pool.size() == names.size());
+}
@@ -0,0 +1,74 @@
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <okami/maps.hpp>
+#include <okami/maptype.hpp>
+
+#include "checks/map_registry.hpp"
+
+// One map ID -> metadata resolution per shop open / save / map load, over
+// every map ID the game uses. The baselines are the lookups the registry
+// replaced: a kShopMap scan, and the unordered_maps MapTypes and the area
+// name table used to be.
+TEST_CASE("Map metadata lookups", "[benchmark][map_registry]")
+{
+    std::vector<uint16_t> mapIds;
+    for (const auto &[mapId, type] : okami::MapTypes::mapidToIndex)
+        mapIds.push_back(static_cast<uint16_t>(mapId));
+
+    const std::unordered_map<unsigned, unsigned> typeMap(okami::MapTypes::mapidToIndex.begin(), okami::MapTypes::mapidToIndex.end());
+    const std::unordered_map<uint16_t, uint32_t> areaMap(okami::MapToAreaNameID.begin(), okami::MapToAreaNameID.end());
+
+    BENCHMARK("shop ID: kShopMap scan")
+    {
+        int sum = 0;
+        for (uint16_t mapId : mapIds)
+        {
+            for (const auto &entry : checks::kShopMap)
+            {
+                if (entry.mapId == mapId && (entry.shopNum == checks::kAnyShopNum || entry.shopNum == 0))
+                {
+                    sum += entry.shopId;
+                    break;
+                }
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("shop ID: registry")
+    {
+        int sum = 0;
+        for (uint16_t mapId : mapIds)
+            sum += checks::mapInfo(mapId).shopId(0).value_or(0);
+        return sum;
+    };
+
+    BENCHMARK("map type + area name: unordered_map")
+    {
+        unsigned sum = 0;
+        for (uint16_t mapId : mapIds)
+        {
+            auto type = typeMap.find(mapId);
+            auto area = areaMap.find(mapId);
+            sum += (type != typeMap.end() ? type->second : 0) + (area != areaMap.end() ? area->second : 0x35);
+        }
+        return sum;
+    };
+
+    BENCHMARK("map type + area name: registry")
+    {
+        unsigned sum = 0;
+        for (uint16_t mapId : mapIds)
+        {
+            const auto &info = checks::mapInfo(mapId);
+            sum += info.mapType + info.areaNameStrId;
+        }
+        return sum;
+    };
+
+    CHECK(checks::mapInfo(okami::MapID::KamikiVillage).shopId(0) == 5);
+}
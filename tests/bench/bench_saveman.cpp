@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <okami/savefile.hpp>
+
+#include "savechecksum.h"
+#include "savestore.h"
+
+namespace
+{
+
+/// The autosave write before SaveStore: read the whole 30-slot file, replace
+/// slot 0, write all of it to .tmp and rename over the original.
+bool rewriteWholeFile(const std::string &path, const okami::SaveSlot &slot)
+{
+    auto saveFile = std::make_unique<okami::SaveFile>();
+    {
+        std::ifstream existing(path, std::ios::binary);
+        if (!existing.read(reinterpret_cast<char *>(saveFile.get()), sizeof(okami::SaveFile)))
+            return false;
+    }
+    std::memcpy(&saveFile->slots[0], &slot, sizeof(slot));
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(saveFile.get()), sizeof(okami::SaveFile));
+        if (!file.good())
+            return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+constexpr uint64_t kChecksumSeed = 0x9be6fa3b72afda1d;
+
+/// Where snapshotToSlot() copies each game region from and to, with the game
+/// memory stood in for by a flat copy of a slot.
+struct Region
+{
+    size_t offset;
+    size_t size;
+};
+
+constexpr Region kRegions[] = {
+    {offsetof(okami::SaveSlot, character), sizeof(okami::CharacterStats)},
+    {offsetof(okami::SaveSlot, tracked), sizeof(okami::TrackerData)},
+    {offsetof(okami::SaveSlot, collection), sizeof(okami::CollectionData)},
+    {offsetof(okami::SaveSlot, MapData), sizeof(okami::SaveSlot::MapData)},
+    {offsetof(okami::SaveSlot, DialogBits), sizeof(okami::SaveSlot::DialogBits)},
+    {offsetof(okami::SaveSlot, customTextures), sizeof(okami::CustomTextures)},
+};
+
+/// The snapshot before the fused fold: six memcpys, then the checksum as a
+/// second pass over the slot, one qword at a time.
+uint64_t copyThenChecksum(okami::SaveSlot &slot, const uint8_t *game)
+{
+    for (const auto &region : kRegions)
+        std::memcpy(reinterpret_cast<uint8_t *>(&slot) + region.offset, game + region.offset, region.size);
+
+    const auto *data = reinterpret_cast<const uint64_t *>(&slot);
+    uint64_t checksum = kChecksumSeed ^ data[0];
+    for (size_t i = 2; i < sizeof(okami::SaveSlot) / sizeof(uint64_t); ++i)
+        checksum ^= data[i];
+    return slot.checksum = checksum;
+}
+
+uint64_t copyFolded(savechecksum::Kernel kernel, okami::SaveSlot &slot, const uint8_t *game)
+{
+    uint64_t checksum = kChecksumSeed ^ *reinterpret_cast<const uint64_t *>(&slot) ^ slot.timeRTC;
+    for (const auto &region : kRegions)
+        checksum ^= savechecksum::copyFold(kernel, reinterpret_cast<uint8_t *>(&slot) + region.offset, game + region.offset, region.size);
+    checksum ^= savechecksum::fold(kernel, &slot.unk1, sizeof(slot.unk1));
+    return slot.checksum = checksum;
+}
+
+} // namespace
+
+// The game-thread half of an autosave: copying the six regions into the slot
+// and checksumming it, on the vanilla fixture's slot 0.
+TEST_CASE("Snapshot and checksum", "[benchmark][saveman]")
+{
+    std::vector<uint8_t> game(sizeof(okami::SaveSlot));
+    std::ifstream(std::string(TEST_FIXTURES_DIR) + "/vanilla_save.bin", std::ios::binary).read(reinterpret_cast<char *>(game.data()), game.size());
+    const uint64_t expected = reinterpret_cast<const okami::SaveSlot *>(game.data())->checksum;
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    std::memcpy(slot.get(), game.data(), 0x18); // header and timestamp, set directly by the snapshot
+
+    REQUIRE(copyThenChecksum(*slot, game.data()) == expected);
+    BENCHMARK("memcpy regions, then qword checksum pass")
+    {
+        return copyThenChecksum(*slot, game.data());
+    };
+
+    using savechecksum::Kernel;
+    for (auto [kernel, name] : {std::pair{Kernel::Portable, "fused copy + fold (portable)"}, std::pair{Kernel::SSE2, "fused copy + fold (SSE2)"},
+                                std::pair{Kernel::AVX2, "fused copy + fold (AVX2)"}})
+    {
+        if (!savechecksum::supported(kernel))
+            continue;
+        REQUIRE(copyFolded(kernel, *slot, game.data()) == expected);
+        BENCHMARK(name)
+        {
+            return copyFolded(kernel, *slot, game.data());
+        };
+    }
+}
+
+// Autosave file I/O for an existing .oksav: the whole-file rewrite against
+// SaveStore's journalled in-place slot write. The SaveStore path also syncs
+// twice (journal, then slot), which the old path never did.
+TEST_CASE("Autosave write", "[benchmark][saveman]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "okami_bench" / "saves";
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "bench.oksav").string();
+    std::filesystem::copy_file(std::string(TEST_FIXTURES_DIR) + "/vanilla_save.bin", path, std::filesystem::copy_options::overwrite_existing);
+
+    okami::SaveSlot slot;
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char *>(&slot), sizeof(slot));
+
+    BENCHMARK("whole-file rewrite (read 2.8 MB, write 2.8 MB, rename)")
+    {
+        ++slot.timeRTC;
+        return rewriteWholeFile(path, slot);
+    };
+
+    SaveStore store(path);
+    BENCHMARK("SaveStore in-place slot write (journal + slot, synced)")
+    {
+        ++slot.timeRTC;
+        return store.writeSlot(slot);
+    };
+
+    // Bytes written per save: 2,846,400 before, 189,776 now
+    REQUIRE(store.stats().writes > 0);
+    CHECK(store.stats().fullRewrites == 0);
+    CHECK(store.stats().bytesWritten / store.stats().writes == 2 * sizeof(okami::SaveSlot) + 16);
+
+    // Check-heavy play: each save flips a collection bit and moves the clock.
+    // Compacted every kCompactBytes of log, as SaveWriter does.
+    SaveStore deltas(path);
+    REQUIRE(deltas.writeSlot(slot));
+    auto previous = std::make_unique<okami::SaveSlot>(slot);
+    const auto before = deltas.stats();
+    uint64_t saves = 0;
+    BENCHMARK("SaveStore delta append (changed qwords, synced), compacted per slot of log")
+    {
+        ++slot.timeRTC;
+        slot.collection.strayBeadsCollected.Set(static_cast<unsigned>(saves++ % okami::StrayBeads::NUM_STRAY_BEADS));
+        const bool ok = deltas.appendDelta(*previous, slot);
+        *previous = slot;
+        if (deltas.deltaSize() >= sizeof(okami::SaveSlot))
+            return ok && deltas.compact();
+        return ok;
+    };
+
+    // Bytes written per save: ~40 (one record), plus a compaction's 189,776
+    // per slot's worth of log
+    REQUIRE(saves > 0);
+    CHECK((deltas.stats().bytesWritten - before.bytesWritten) / saves < 1024);
+
+    std::filesystem::remove_all(dir);
+}
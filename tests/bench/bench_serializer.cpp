@@ -0,0 +1,283 @@
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <okami/blowfish.hpp>
+#include <okami/customiconpkg.hpp>
+#include <okami/msd.h>
+#include <okami/resourcepkg.hpp>
+
+#include "checks/shops.hpp"
+
+// Rebuild cost of the generated game files: the item name MSD after a
+// string changes, the combined icon package, and a full item shop ISL.
+TEST_CASE("Serializer throughput", "[benchmark][serializer]")
+{
+    okami::MSDManager msd;
+    for (int i = 0; i < 1000; i++)
+        msd.AddString("Archipelago item name " + std::to_string(i));
+
+    int override = 0;
+    BENCHMARK("MSD rebuild, 1000 strings")
+    {
+        msd.OverrideString(0, (override++ & 1) ? "Progressive Sword" : "Fire Arrow");
+        return msd.GetData();
+    };
+
+    // 300 icons of roughly the size of a 64x64 DXT5 DDS
+    okami::ResourcePackage pkg;
+    pkg.addBlank();
+    const std::vector<uint8_t> icon(4096 + 128, 0x5A);
+    for (int i = 0; i < 300; i++)
+        pkg.addEntry({'D', 'D', 'S', '\0'}, icon);
+
+    std::vector<uint8_t> image(pkg.serializedSize());
+    BENCHMARK("package serialize, 300 x 4 KiB entries")
+    {
+        return pkg.serializeInto(image);
+    };
+
+    const auto path = std::filesystem::temp_directory_path() / "okami_bench" / "serializer.dat";
+    BENCHMARK("package write (serialize + encrypt + disk), 300 x 4 KiB entries")
+    {
+        return pkg.write(path);
+    };
+
+    okami::ResourcePackageWriter writer;
+    writer.addBlank();
+    for (int i = 0; i < 300; i++)
+        writer.addEntry({'D', 'D', 'S', '\0'}, icon);
+    BENCHMARK("streaming writer (chunked encrypt + disk), 300 x 4 KiB entries")
+    {
+        return writer.write(path);
+    };
+    std::filesystem::remove_all(path.parent_path());
+
+    checks::ShopDefinition shop;
+    for (size_t i = 0; i < checks::MaxShopStockSize; i++)
+        shop.AddItem(okami::ItemTypes::HolyBoneS, 100);
+
+    BENCHMARK("ISL rebuild, full shop")
+    {
+        shop.SetSellValueOverride(okami::ItemTypes::HolyBoneS, 10);
+        return shop.GetData();
+    };
+
+    CHECK(image.size() % 32 == 0);
+}
+
+// Patching the game's core message file at load: copying every string and
+// rebuilding the whole file, against overlaying the original buffer. Then a
+// live update to one string once the file has been handed to the game.
+TEST_CASE("MSD overlay", "[benchmark][serializer]")
+{
+    // Stand-in for core20 MSD: 3000 strings of 40 characters
+    okami::MSDManager source;
+    for (int i = 0; i < 3000; i++)
+        source.AddString("Vanilla message string number " + std::to_string(1000000 + i));
+    const uint8_t *core20 = source.GetData();
+
+    auto applyOverrides = [](okami::MSDManager &msd)
+    {
+        for (uint32_t i = 0; i < 13; i++)
+            msd.OverrideString(294 + i * 7, "Archipelago Item");
+    };
+
+    BENCHMARK("load: ReadMSD + overrides + rebuild")
+    {
+        okami::MSDManager msd;
+        msd.ReadMSD(core20);
+        applyOverrides(msd);
+        return msd.GetData()[0];
+    };
+
+    BENCHMARK("load: OverlayMSD + overrides + rebuild")
+    {
+        okami::MSDManager msd;
+        msd.OverlayMSD(core20);
+        applyOverrides(msd);
+        return msd.GetData()[0];
+    };
+
+    okami::MSDManager live;
+    live.OverlayMSD(core20);
+    applyOverrides(live);
+    const uint8_t *handedOut = live.GetData();
+
+    int toggle = 0;
+    BENCHMARK("live override after load")
+    {
+        live.OverrideString(294, (toggle++ & 1) ? "Progressive Sword" : "Fire Arrow");
+        return live.GetData();
+    };
+
+    CHECK(live.GetString(0)[0] == source.GetString(0)[0]);
+    CHECK(handedOut != nullptr);
+}
+
+// Compiling a multiworld's worth of scouted names: the old byte-at-a-time
+// table loop (ASCII only) as a baseline, then the transcoder on ASCII names
+// and on names with accented and CJK characters mixed in.
+TEST_CASE("MSD string transcoding", "[benchmark][serializer]")
+{
+    std::array<uint16_t, 128> table{};
+    for (int c = 0; c < 128; c++)
+        table[static_cast<size_t>(c)] = okami::MSDManager::CompileString(std::string(1, static_cast<char>(c)))[0];
+
+    std::vector<std::string> asciiNames;
+    std::vector<std::string> mixedNames;
+    for (int i = 0; i < 5000; i++)
+    {
+        asciiNames.push_back("Player" + std::to_string(i % 50) + "'s Progressive Sword of the Hero");
+        mixedNames.push_back((i % 3 == 0 ? "Pok\xC3\xA9mon Trainer " : i % 3 == 1 ? "\xE3\x82\xBC\xE3\x83\xAB\xE3\x83\x80 " : "Ren ") + asciiNames.back());
+    }
+    std::vector<uint16_t> out(256);
+
+    BENCHMARK("byte loop, 5000 ASCII names")
+    {
+        size_t units = 0;
+        for (const auto &name : asciiNames)
+        {
+            for (size_t i = 0; i < name.size(); i++)
+            {
+                const auto c = static_cast<unsigned char>(name[i]);
+                out[i] = c < 128 ? table[c] : 201;
+            }
+            out[name.size()] = 0x8001;
+            units += name.size() + 1;
+        }
+        return units;
+    };
+
+    BENCHMARK("CompileStringInto, 5000 ASCII names")
+    {
+        size_t units = 0;
+        for (const auto &name : asciiNames)
+            units += okami::MSDManager::CompileStringInto(name, out);
+        return units;
+    };
+
+    BENCHMARK("CompileStringInto, 5000 mixed names")
+    {
+        size_t units = 0;
+        for (const auto &name : mixedNames)
+            units += okami::MSDManager::CompileStringInto(name, out);
+        return units;
+    };
+
+    CHECK(okami::MSDManager::CompileStringInto(asciiNames[7], out) == asciiNames[7].size() + 1);
+}
+
+// Startup cost of the combined shop icon package: a full rebuild against a
+// launch where the manifest still matches the inputs. Then what the game pays
+// to load it, with one icon entry per kIconEntries row against one entry per
+// distinct icon.
+TEST_CASE("Combined icon package at startup", "[benchmark][serializer]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "okami_bench" / "combined";
+    std::filesystem::create_directories(dir);
+    const auto vanillaPath = dir / "ItemShopBuyIcon.dat";
+    const auto outPath = dir / "customicons.dat";
+
+    okami::ResourcePackage vanilla;
+    for (int i = 0; i < 280; i++)
+        vanilla.addEntry({'D', 'D', 'S', '\0'}, std::vector<uint8_t>(4096 + 128, static_cast<uint8_t>(i)));
+    REQUIRE(vanilla.write(vanillaPath));
+
+    // The shipped AP icons are 87536 bytes each
+    std::array<std::vector<uint8_t>, 3> icons;
+    std::array<std::filesystem::path, 3> ddsPaths;
+    for (size_t i = 0; i < icons.size(); i++)
+    {
+        icons[i].assign(87536, static_cast<uint8_t>(0xA0 + i));
+        ddsPaths[i] = dir / ("ap_" + std::to_string(i) + ".dds");
+        std::ofstream dds{ddsPaths[i], std::ios::binary};
+        dds.write(reinterpret_cast<const char *>(icons[i].data()), static_cast<std::streamsize>(icons[i].size()));
+    }
+
+    okami::customiconpkg::CombinedPackage layout;
+    BENCHMARK("rebuild (no manifest)")
+    {
+        std::filesystem::remove(okami::customiconpkg::manifestPath(outPath));
+        return okami::customiconpkg::buildCombinedFromFiles(outPath, vanillaPath, ddsPaths[0], ddsPaths[1], ddsPaths[2], layout);
+    };
+
+    BENCHMARK("cached (manifest matches)")
+    {
+        return okami::customiconpkg::buildCombinedFromFiles(outPath, vanillaPath, ddsPaths[0], ddsPaths[1], ddsPaths[2], layout);
+    };
+
+    // The layout before deduplication, for comparison
+    const auto perRowPath = dir / "per_row.dat";
+    {
+        okami::ResourcePackageReader reader;
+        REQUIRE(reader.open(vanillaPath));
+        okami::ResourcePackageWriter perRow;
+        for (size_t i = 0; i < reader.size(); i++)
+            perRow.addEntry(reader.type(i), reader.entry(i));
+        for (const auto &e : okami::customiconpkg::kIconEntries)
+            perRow.addEntry({'D', 'D', 'S', '\0'}, icons[static_cast<size_t>(e.ddsIndex)]);
+        REQUIRE(perRow.write(perRowPath));
+    }
+
+    auto loadWhole = [](const std::filesystem::path &path)
+    {
+        std::ifstream ifs{path, std::ios::binary | std::ios::ate};
+        std::vector<uint8_t> bytes(static_cast<size_t>(ifs.tellg()));
+        ifs.seekg(0);
+        ifs.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        Nippon::okamiCipher().decrypt(bytes);
+        return bytes.size();
+    };
+
+    const auto kib = [](const std::filesystem::path &path) { return std::to_string(std::filesystem::file_size(path) / 1024) + " KiB"; };
+    BENCHMARK("load: read + decrypt, one entry per row (" + kib(perRowPath) + ")")
+    {
+        return loadWhole(perRowPath);
+    };
+    BENCHMARK("load: read + decrypt, deduplicated (" + kib(outPath) + ")")
+    {
+        return loadWhole(outPath);
+    };
+
+    CHECK(layout.vanillaCount == 280);
+    CHECK(layout.iconCount == 3);
+    std::filesystem::remove_all(dir);
+}
+
+// Looking at one entry of a large package: reading and decrypting the whole
+// file, against mapping it and decrypting the header plus that entry.
+TEST_CASE("Package reading", "[benchmark][serializer]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "okami_bench" / "reader.dat";
+    okami::ResourcePackage pkg;
+    const std::vector<uint8_t> icon(4096 + 128, 0x5A);
+    for (int i = 0; i < 2000; i++)
+        pkg.addEntry({'D', 'D', 'S', '\0'}, icon);
+    REQUIRE(pkg.write(path));
+
+    BENCHMARK("read + decrypt whole file, one entry")
+    {
+        std::ifstream ifs{path, std::ios::binary};
+        std::vector<uint8_t> bytes{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+        Nippon::okamiCipher().decrypt(bytes);
+        return bytes[bytes.size() / 2];
+    };
+
+    BENCHMARK("ResourcePackageReader, one entry")
+    {
+        okami::ResourcePackageReader reader;
+        (void)reader.open(path);
+        return reader.entry(1000)[0];
+    };
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(path));
+    CHECK(reader.entry(1000).size() == icon.size());
+    reader.close();
+    std::filesystem::remove_all(path.parent_path());
+}
@@ -278,6 +278,39 @@ TEST_CASE("MockArchipelagoSocket async scoutLocations", "[mock_socket]")
     CHECK(socket.getScoutRequest(0).createAsHint == 1);
 }
 
+TEST_CASE("MockArchipelagoSocket scoutLocationsAsync replies from the game thread", "[mock_socket]")
+{
+    MockArchipelagoSocket socket;
+    HandshakeConfig config{0, 0};
+    socket.setHandshakeConfig(config);
+    socket.connect("test", "slot", "");
+    socket.poll();
+
+    std::list<int64_t> locations = {600000};
+    socket.setScoutResponse(locations, {{.item = 0x42, .location = 600000, .player = 1, .flags = 0}});
+
+    std::vector<std::vector<ScoutedItem>> replies;
+    auto onReply = [&replies](std::vector<ScoutedItem> items) { replies.push_back(std::move(items)); };
+
+    socket.scoutLocationsAsync(locations, 0, onReply);
+    CHECK(socket.getPendingScoutCount() == 1);
+
+    // Answered by poll(), delivered by processMainThreadTasks()
+    socket.poll();
+    CHECK(replies.empty());
+    socket.processMainThreadTasks();
+    REQUIRE(replies.size() == 1);
+    REQUIRE(replies[0].size() == 1);
+    CHECK(replies[0][0].item == 0x42);
+
+    // A dropped connection still answers, with nothing
+    socket.scoutLocationsAsync(locations, 0, onReply);
+    socket.disconnect();
+    socket.processMainThreadTasks();
+    REQUIRE(replies.size() == 2);
+    CHECK(replies[1].empty());
+}
+
 TEST_CASE("MockArchipelagoSocket scheduled disconnect", "[mock_socket]")
 {
     MockArchipelagoSocket socket;
@@ -0,0 +1,68 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacement global allocator that counts calls and tracks the largest
+// request. Array, sized and nothrow forms all route through these two entry
+// points in the standard library, so counting here sees every allocation.
+
+namespace
+{
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_largest{0};
+
+void record(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t largest = g_largest.load(std::memory_order_relaxed);
+    while (size > largest && !g_largest.compare_exchange_weak(largest, size, std::memory_order_relaxed))
+    {
+    }
+}
+} // namespace
+
+namespace mock
+{
+
+size_t totalAllocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+size_t largestAllocation()
+{
+    return g_largest.load(std::memory_order_relaxed);
+}
+
+void resetLargestAllocation()
+{
+    g_largest.store(0, std::memory_order_relaxed);
+}
+
+} // namespace mock
+
+void *operator new(size_t size)
+{
+    record(size);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mock
+{
+
+/// Total global operator new calls in this process. Only linked into
+/// apclient-tests, whose alloc_counter.cpp replaces the global allocator.
+size_t totalAllocations();
+
+/// Largest single allocation, in bytes, since the last resetLargestAllocation().
+size_t largestAllocation();
+void resetLargestAllocation();
+
+/**
+ * @brief Counts heap allocations made while it is alive
+ *
+ * Usage:
+ *   mock::AllocationCounter allocs;
+ *   hook(...);
+ *   CHECK(allocs.count() == 0);
+ *
+ * largest() restarts the process-wide high-water mark, so only one counter
+ * should be asking for it at a time.
+ */
+class AllocationCounter
+{
+  public:
+    AllocationCounter() : start_(totalAllocations())
+    {
+        resetLargestAllocation();
+    }
+
+    [[nodiscard]] size_t count() const
+    {
+        return totalAllocations() - start_;
+    }
+
+    /// Largest single allocation made while this counter was alive, in bytes.
+    [[nodiscard]] size_t largest() const
+    {
+        return largestAllocation();
+    }
+
+  private:
+    size_t start_;
+};
+
+} // namespace mock
@@ -23,6 +23,7 @@ void MockArchipelagoSocket::disconnect()
 {
     state_ = ConnectionState::Disconnected;
     currentStatus_ = "Disconnected";
+    deliverScoutReplies(false);
 }
 
 bool MockArchipelagoSocket::isConnected() const
@@ -68,6 +69,7 @@ void MockArchipelagoSocket::poll()
         state_ = ConnectionState::Disconnected;
         currentStatus_ = "Connection lost";
         disconnectAfterPolls_ = -1;
+        deliverScoutReplies(false);
         return;
     }
 
@@ -84,8 +86,9 @@ void MockArchipelagoSocket::poll()
         return;
     }
 
-    // Deliver pending items to main thread queue
+    // Deliver pending items and scout replies to main thread queue
     deliverPendingItems();
+    deliverScoutReplies(true);
 }
 
 void MockArchipelagoSocket::processMainThreadTasks()
@@ -156,6 +159,18 @@ bool MockArchipelagoSocket::scoutLocations(const std::list<int64_t> &locations,
     return true;
 }
 
+void MockArchipelagoSocket::scoutLocationsAsync(const std::list<int64_t> &locations, int createAsHint, ScoutReplyCallback onReply)
+{
+    if (state_ != ConnectionState::Connected)
+    {
+        mainThreadTasks_.push([onReply = std::move(onReply)]() { onReply({}); });
+        return;
+    }
+
+    scoutRequests_.push_back({locations, createAsHint});
+    pendingScoutReplies_.emplace_back(locations, std::move(onReply));
+}
+
 std::vector<ScoutedItem> MockArchipelagoSocket::scoutLocationsSync(const std::list<int64_t> &locations, int createAsHint, std::chrono::milliseconds timeout)
 {
     (void)timeout; // Mock doesn't need real timeout
@@ -166,7 +181,11 @@ std::vector<ScoutedItem> MockArchipelagoSocket::scoutLocationsSync(const std::li
     }
 
     scoutRequests_.push_back({locations, createAsHint});
+    return scoutResponseFor(locations);
+}
 
+std::vector<ScoutedItem> MockArchipelagoSocket::scoutResponseFor(const std::list<int64_t> &locations) const
+{
     // Check for configured timeout
     if (scoutTimeouts_.count(locations) > 0)
     {
@@ -184,6 +203,17 @@ std::vector<ScoutedItem> MockArchipelagoSocket::scoutLocationsSync(const std::li
     return defaultScoutResponse_;
 }
 
+void MockArchipelagoSocket::deliverScoutReplies(bool connected)
+{
+    // Answered in request order, like the server; a dropped connection answers nothing
+    for (auto &[locations, onReply] : pendingScoutReplies_)
+    {
+        mainThreadTasks_.push([onReply = std::move(onReply), items = connected ? scoutResponseFor(locations) : std::vector<ScoutedItem>{}]() mutable
+                              { onReply(std::move(items)); });
+    }
+    pendingScoutReplies_.clear();
+}
+
 int MockArchipelagoSocket::getPlayerSlot() const
 {
     if (state_ == ConnectionState::Connected)
@@ -332,6 +362,11 @@ void MockArchipelagoSocket::setScoutTimeout(const std::list<int64_t> &forLocatio
     scoutTimeouts_.insert(forLocations);
 }
 
+size_t MockArchipelagoSocket::getPendingScoutCount() const
+{
+    return pendingScoutReplies_.size();
+}
+
 // === Error Simulation ===
 
 void MockArchipelagoSocket::scheduleDisconnect(int afterPolls)
@@ -431,6 +466,7 @@ void MockArchipelagoSocket::reset()
     scoutResponses_.clear();
     defaultScoutResponse_.clear();
     scoutTimeouts_.clear();
+    pendingScoutReplies_.clear();
 
     disconnectAfterPolls_ = -1;
 
@@ -78,6 +78,7 @@ class MockArchipelagoSocket : public ISocket
     std::string getStatus() const override;
 
     bool scoutLocations(const std::list<int64_t> &locations, int createAsHint) override;
+    void scoutLocationsAsync(const std::list<int64_t> &locations, int createAsHint, ScoutReplyCallback onReply) override;
     std::vector<ScoutedItem> scoutLocationsSync(const std::list<int64_t> &locations, int createAsHint = 0,
                                                 std::chrono::milliseconds timeout = std::chrono::seconds(5)) override;
     int getPlayerSlot() const override;
@@ -126,6 +127,9 @@ class MockArchipelagoSocket : public ISocket
     void setDefaultScoutResponse(const std::vector<ScoutedItem> &response);
     void setScoutTimeout(const std::list<int64_t> &forLocations);
 
+    // Async scouts sent but not yet answered; the next connected poll() answers them
+    size_t getPendingScoutCount() const;
+
     // === Error Simulation ===
 
     void scheduleDisconnect(int afterPolls);
@@ -151,6 +155,8 @@ class MockArchipelagoSocket : public ISocket
   private:
     void advanceHandshake();
     void deliverPendingItems();
+    void deliverScoutReplies(bool connected);
+    std::vector<ScoutedItem> scoutResponseFor(const std::list<int64_t> &locations) const;
 
     // Connection state machine
     ConnectionState state_ = ConnectionState::Disconnected;
@@ -189,6 +195,7 @@ class MockArchipelagoSocket : public ISocket
     std::map<std::list<int64_t>, std::vector<ScoutedItem>> scoutResponses_;
     std::vector<ScoutedItem> defaultScoutResponse_;
     std::set<std::list<int64_t>> scoutTimeouts_;
+    std::vector<std::pair<std::list<int64_t>, ScoutReplyCallback>> pendingScoutReplies_;
 
     // Error simulation
     int disconnectAfterPolls_ = -1;
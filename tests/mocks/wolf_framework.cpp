@@ -12,8 +12,10 @@ std::vector<std::string> logMessages;
 std::vector<std::function<void()>> playStartCallbacks;
 std::vector<std::function<void()>> returnToMenuCallbacks;
 std::unordered_map<uintptr_t, void *> registeredHooks;
+std::unordered_map<uintptr_t, void *> hookOriginals;
 std::vector<std::unique_ptr<MockBitfieldMonitor>> bitfieldMonitors;
 std::vector<std::function<bool(int, int)>> brushEditCallbacks;
+std::unordered_map<std::string, CommandHandler> registeredCommands;
 
 void reset()
 {
@@ -23,8 +25,10 @@ void reset()
     playStartCallbacks.clear();
     returnToMenuCallbacks.clear();
     registeredHooks.clear();
+    hookOriginals.clear();
     bitfieldMonitors.clear();
     brushEditCallbacks.clear();
+    registeredCommands.clear();
 }
 
 void triggerPlayStart()
@@ -42,6 +42,10 @@ extern std::vector<std::function<void()>> returnToMenuCallbacks;
 // Storage for registered hooks by offset (type-erased as void*)
 extern std::unordered_map<uintptr_t, void *> registeredHooks;
 
+// Stand-in "original" functions handed back by hookFunction, by offset.
+// Lets tests drive detours down their pass-through paths. Unset offsets get nullptr.
+extern std::unordered_map<uintptr_t, void *> hookOriginals;
+
 // Reset all mock state
 void reset();
 
@@ -212,6 +216,38 @@ inline bool triggerBrushEdit(int bitIndex, int operation)
 }
 } // namespace mock
 
+// Mock console commands. Handlers are stored by name; tests run them via
+// mock::runCommand with args[0] set to the command name, as in wolf.
+using CommandHandler = std::function<void(const std::vector<std::string> &args)>;
+
+namespace mock
+{
+extern std::unordered_map<std::string, CommandHandler> registeredCommands;
+
+inline bool runCommand(const std::string &name, std::vector<std::string> args = {})
+{
+    auto it = registeredCommands.find(name);
+    if (it == registeredCommands.end())
+        return false;
+    args.insert(args.begin(), name);
+    it->second(args);
+    return true;
+}
+} // namespace mock
+
+inline bool addCommand(const char *name, CommandHandler handler, const char *description = "") noexcept
+{
+    (void)description;
+    mock::registeredCommands[name] = std::move(handler);
+    return true;
+}
+
+inline bool removeCommand(const char *name) noexcept
+{
+    mock::registeredCommands.erase(name);
+    return true;
+}
+
 // ResourceProvider type used by interceptResource
 using ResourceProvider = std::function<const char *(const char *originalPath)>;
 
@@ -226,7 +262,8 @@ template <typename T, typename U> inline bool hookFunction(const char *module, u
 {
     (void)module;
     mock::registeredHooks[offset] = reinterpret_cast<void *>(hookFn);
-    *originalFn = nullptr; // No original to call in tests
+    auto original = mock::hookOriginals.find(offset);
+    *originalFn = original != mock::hookOriginals.end() ? reinterpret_cast<U>(original->second) : nullptr;
     return true;
 }
 
@@ -31,6 +31,7 @@
 #include "checks/brushes.hpp"
 #include "checks/check_types.hpp"
 #include "gamestate_accessors.hpp"
+#include "lifecycle.h"
 #include "rewardman.h"
 #include "wolf_framework.hpp"
 
@@ -59,6 +60,7 @@ class BrushFixture
         wolf::mock::reset();
         wolf::mock::reserveMemory(0xC00000 + 1024);
         apgame::initialize();
+        lifecycle::bindWolfCallbacks();
         rewardMan_ = std::make_unique<RewardMan>(nullptr);
         // Grants are gated on grantingEnabled_ which onPlayStart flips on.
         wolf::mock::triggerPlayStart();
@@ -226,6 +228,7 @@ TEST_CASE("Log 1 race: grant runs before game sets lock; subsequent tick clears
     wolf::mock::reserveMemory(0xC00000 + 1024);
     apgame::initialize();
 
+    lifecycle::bindWolfCallbacks();
     RewardMan rewardMan(nullptr);
     wolf::mock::triggerPlayStart();
 
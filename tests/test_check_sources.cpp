@@ -0,0 +1,198 @@
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "checkman.h"
+#include "checks/brushes.hpp"
+#include "checks/check_sources.hpp"
+#include "checks/check_types.hpp"
+#include "gamestate_accessors.hpp"
+#include "lifecycle.h"
+#include "mock_archipelagosocket.h"
+#include "wolf_framework.hpp"
+
+// ============================================================================
+// Registry (compile-time verified)
+// ============================================================================
+
+static_assert(checks::kCheckSources[6].checkId(5, 3) == checks::getDigSpotCheckId(5, 3));
+static_assert(checks::kCheckSources[7].checkId(5, 3) == checks::getFightClearedCheckId(5, 3));
+static_assert(checks::kCheckSources[0].checkId(0, 7) == checks::kStrayBeadBase + 7);
+
+TEST_CASE("Check source ID ranges map to their categories", "[check_sources][check_types]")
+{
+    CHECK(checks::getCheckCategory(checks::kStrayBeadBase - 1) == checks::CheckCategory::Unknown);
+    CHECK(checks::getCheckCategory(checks::kStrayBeadBase) == checks::CheckCategory::StrayBead);
+    CHECK(checks::getCheckCategory(checks::kTravelGuideBase) == checks::CheckCategory::TravelGuide);
+    CHECK(checks::getCheckCategory(checks::kDojoMoveBase) == checks::CheckCategory::DojoMove);
+    CHECK(checks::getCheckCategory(checks::kFishTomeBase) == checks::CheckCategory::FishTome);
+    CHECK(checks::getCheckCategory(checks::kAnimalTomeBase) == checks::CheckCategory::AnimalTome);
+    CHECK(checks::getCheckCategory(checks::kTreasureTomeBase) == checks::CheckCategory::TreasureTome);
+    CHECK(checks::getCheckCategory(checks::getDigSpotCheckId(82, 95)) == checks::CheckCategory::DigSpot);
+    CHECK(checks::getCheckCategory(checks::getFightClearedCheckId(82, 127)) == checks::CheckCategory::FightCleared);
+    CHECK(checks::getCheckCategory(checks::kFightClearedEnd) == checks::CheckCategory::Unknown);
+}
+
+// ============================================================================
+// Bit decoding
+// ============================================================================
+
+TEST_CASE("Rising bits decode per bit-order convention", "[check_sources]")
+{
+    std::vector<unsigned> bits;
+    auto collect = [&](unsigned bit) { bits.push_back(bit); };
+
+    SECTION("Msb0Word32 matches okami::BitField indexing")
+    {
+        okami::BitField<64> before{};
+        okami::BitField<64> after{};
+        after.Set(0);
+        after.Set(33);
+        before.Set(40);
+        after.Set(40); // already set: not rising
+
+        checks::detail::forEachRisingBit(checks::BitOrder::Msb0Word32, 64, reinterpret_cast<const uint8_t *>(before.values),
+                                         reinterpret_cast<const uint8_t *>(after.values), sizeof(after.values), collect);
+        CHECK(bits == std::vector<unsigned>{0, 33});
+    }
+
+    SECTION("Lsb0Byte matches raw game byte indexing")
+    {
+        const uint8_t before[2] = {0x00, 0x01};
+        const uint8_t after[2] = {0x41, 0x00}; // bits 0 and 6 set, bit 8 cleared
+
+        checks::detail::forEachRisingBit(checks::BitOrder::Lsb0Byte, 16, before, after, sizeof(after), collect);
+        CHECK(bits == std::vector<unsigned>{0, 6});
+    }
+
+    SECTION("Bits past bitCount are ignored")
+    {
+        okami::BitField<64> before{};
+        okami::BitField<64> after{};
+        after.Set(50);
+
+        checks::detail::forEachRisingBit(checks::BitOrder::Msb0Word32, 40, reinterpret_cast<const uint8_t *>(before.values),
+                                         reinterpret_cast<const uint8_t *>(after.values), sizeof(after.values), collect);
+        CHECK(bits.empty());
+    }
+}
+
+// ============================================================================
+// Scanner against mock memory
+// ============================================================================
+
+namespace
+{
+
+okami::CollectionData &mockCollection()
+{
+    return *reinterpret_cast<okami::CollectionData *>(wolf::mock::mockMemory.data() + okami::main::collectionData);
+}
+
+okami::MapState &mockMapState(size_t mapId)
+{
+    return reinterpret_cast<okami::MapState *>(wolf::mock::mockMemory.data() + okami::main::mapData)[mapId];
+}
+
+} // namespace
+
+TEST_CASE("CheckSourceScanner reports 0->1 transitions once", "[check_sources]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(0xC00000 + 1024);
+
+    std::vector<int64_t> sent;
+    checks::CheckSourceScanner scanner([&](int64_t id) { sent.push_back(id); });
+    scanner.initialize();
+    CHECK(scanner.regionCount() == 6 + 2 * static_cast<size_t>(okami::MapTypes::NUM_MAP_TYPES));
+
+    SECTION("Collection tome bit")
+    {
+        mockCollection().strayBeadsCollected.Set(12);
+        scanner.scan();
+        scanner.scan();
+        CHECK(sent == std::vector<int64_t>{checks::kStrayBeadBase + 12});
+    }
+
+    SECTION("Per-map bits carry the map instance")
+    {
+        mockMapState(5).unburiedObjects.Set(3);
+        mockMapState(9).fightsCleared.Set(100);
+        scanner.scan();
+        CHECK(sent == std::vector<int64_t>{checks::getDigSpotCheckId(5, 3), checks::getFightClearedCheckId(9, 100)});
+    }
+
+    SECTION("Viewed-only bits and clears are not checks")
+    {
+        mockCollection().fishTomesViewed.Set(4);
+        scanner.scan();
+        mockCollection().treasureTomesCollected.Set(2);
+        scanner.scan();
+        mockCollection().treasureTomesCollected.Clear(2);
+        scanner.scan();
+        CHECK(sent == std::vector<int64_t>{checks::kTreasureTomeBase + 2});
+    }
+
+    SECTION("Rebaseline swallows pending changes")
+    {
+        mockCollection().animalTomesCollected.Set(1);
+        scanner.rebaseline();
+        scanner.scan();
+        CHECK(sent.empty());
+    }
+
+    wolf::mock::reset();
+}
+
+TEST_CASE("CheckMan routes check sources through lifecycle gating", "[check_sources][checkman]")
+{
+    wolf::mock::reset();
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reserveMemory(0xC00000 + 1024);
+    apgame::initialize();
+
+    mock::MockArchipelagoSocket socket;
+    socket.setConnected(true);
+    CheckMan checkMan(socket);
+    checkMan.initialize();
+
+    SECTION("Bits already set when play starts are not reported")
+    {
+        mockCollection().travelGuidesCollected.Set(1);
+        lifecycle::publish(lifecycle::PlayStart{});
+        checkMan.poll();
+        CHECK(socket.getSentLocationCount() == 0);
+
+        mockCollection().travelGuidesCollected.Set(2);
+        checkMan.poll();
+        CHECK(socket.wasLocationSent(checks::kTravelGuideBase + 2));
+        CHECK(socket.getSentLocationCount() == 1);
+    }
+
+    SECTION("Changes made while sending is paused (reward grants) are swallowed")
+    {
+        lifecycle::publish(lifecycle::PlayStart{});
+
+        mockCollection().dojoMovesCollected.Set(0);
+        checkMan.enableSending(false); // flushes the player's pickup first
+        mockCollection().dojoMovesCollected.Set(1);
+        checkMan.enableSending(true);
+        checkMan.poll();
+
+        CHECK(socket.getSentLocationsInOrder() == std::vector<int64_t>{checks::kDojoMoveBase + 0});
+    }
+
+    SECTION("Nothing is scanned outside gameplay")
+    {
+        checkMan.enableSending(true);
+        mockCollection().strayBeadsCollected.Set(3);
+        checkMan.poll();
+        CHECK(socket.getSentLocationCount() == 0);
+    }
+
+    checkMan.shutdown();
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reset();
+}
@@ -0,0 +1,262 @@
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "checkman.h"
+#include "checks/brushes.hpp"
+#include "checks/check_trace.hpp"
+#include "checks/check_types.hpp"
+#include "gamestate_accessors.hpp"
+#include "lifecycle.h"
+#include "mock_archipelagosocket.h"
+#include "wolf_framework.hpp"
+
+using namespace std::chrono_literals;
+using checks::CheckOrigin;
+using checks::CheckOutcome;
+using checks::CheckTrace;
+using checks::CheckTraceEntry;
+
+namespace
+{
+
+CheckTraceEntry sentEntry(int64_t checkId, CheckTrace::Clock::time_point detected, std::chrono::microseconds latency)
+{
+    return CheckTraceEntry{
+        .checkId = checkId, .origin = CheckOrigin::ContainerPoll, .detected = detected, .queued = detected + latency, .sent = detected + latency};
+}
+
+} // namespace
+
+// ============================================================================
+// Ring mechanics
+// ============================================================================
+
+TEST_CASE("CheckTrace keeps the newest kCapacity entries", "[check_trace]")
+{
+    CheckTrace trace;
+    const auto t0 = CheckTrace::Clock::now();
+
+    for (int64_t i = 0; i < static_cast<int64_t>(CheckTrace::kCapacity) + 10; ++i)
+        trace.record(sentEntry(i, t0, 1us));
+
+    const auto entries = trace.snapshot();
+    REQUIRE(entries.size() == CheckTrace::kCapacity);
+    CHECK(entries.front().checkId == 10);
+    CHECK(entries.back().checkId == static_cast<int64_t>(CheckTrace::kCapacity) + 9);
+    CHECK_FALSE(trace.find(9).has_value());
+    CHECK(trace.find(10).has_value());
+
+    trace.clear();
+    CHECK(trace.size() == 0);
+}
+
+TEST_CASE("CheckTrace find returns the most recent entry for an ID", "[check_trace]")
+{
+    CheckTrace trace;
+    const auto t0 = CheckTrace::Clock::now();
+
+    trace.record(CheckTraceEntry{.checkId = 7, .outcome = CheckOutcome::NotSending, .detected = t0});
+    trace.record(sentEntry(7, t0 + 1ms, 5us));
+
+    auto entry = trace.find(7);
+    REQUIRE(entry.has_value());
+    CHECK(entry->outcome == CheckOutcome::Sent);
+}
+
+TEST_CASE("CheckTrace latency percentiles", "[check_trace]")
+{
+    CheckTrace trace;
+    const auto t0 = CheckTrace::Clock::now();
+
+    // Latencies 1..100us
+    for (int i = 1; i <= 100; ++i)
+        trace.record(sentEntry(i, t0, std::chrono::microseconds(i)));
+    // Skipped checks never reach "sent" and don't count
+    trace.record(CheckTraceEntry{.checkId = 500, .outcome = CheckOutcome::Duplicate, .detected = t0});
+
+    const auto summary = trace.detectToSend();
+    CHECK(summary.samples == 100);
+    CHECK(summary.p50 == 50us);
+    CHECK(summary.p90 == 90us);
+    CHECK(summary.p99 == 99us);
+    CHECK(summary.max == 100us);
+
+    CHECK(trace.sendToConfirm().samples == 0);
+}
+
+TEST_CASE("CheckTrace confirmation only stamps sent, unconfirmed entries", "[check_trace]")
+{
+    CheckTrace trace;
+    const auto t0 = CheckTrace::Clock::now();
+
+    trace.record(sentEntry(1, t0, 10us));
+    trace.record(sentEntry(2, t0, 10us));
+    trace.record(CheckTraceEntry{.checkId = 3, .outcome = CheckOutcome::Duplicate, .detected = t0});
+
+    CHECK(trace.markConfirmed({1, 3}, t0 + 2ms) == 1);
+    CHECK(trace.markConfirmed({1}, t0 + 5ms) == 0); // first confirmation wins
+
+    CHECK(trace.find(1)->confirmed == t0 + 2ms);
+    CHECK(trace.find(2)->confirmed == CheckTrace::Clock::time_point{});
+    CHECK(trace.find(3)->confirmed == CheckTrace::Clock::time_point{});
+
+    const auto rtt = trace.sendToConfirm();
+    CHECK(rtt.samples == 1);
+    CHECK(rtt.max == 1990us);
+}
+
+TEST_CASE("CheckTrace confirmation against a full server list", "[check_trace]")
+{
+    CheckTrace trace;
+    const auto t0 = CheckTrace::Clock::now();
+
+    // The ring wraps; only entries still in it can be confirmed
+    for (int64_t id = 0; id < static_cast<int64_t>(CheckTrace::kCapacity) + 8; ++id)
+        trace.record(sentEntry(id, t0, 10us));
+
+    // A reconnect delivers every checked location of the slot, in server order
+    std::list<int64_t> serverChecked;
+    for (int64_t id = 10000; id-- > 0;)
+        serverChecked.push_back(id);
+
+    CHECK(trace.markConfirmed(serverChecked, t0 + 1ms) == CheckTrace::kCapacity);
+    CHECK_FALSE(trace.find(0).has_value());
+    CHECK(trace.find(8)->confirmed == t0 + 1ms);
+    CHECK(trace.markConfirmed(serverChecked, t0 + 2ms) == 0);
+}
+
+TEST_CASE("CheckTrace timeline formatting", "[check_trace]")
+{
+    const auto t0 = CheckTrace::Clock::now();
+    auto entry = sentEntry(900123, t0, 250us);
+    entry.origin = CheckOrigin::BrushHook;
+
+    const auto line = CheckTrace::formatTimeline(entry);
+    CHECK(line.find("900123") != std::string::npos);
+    CHECK(line.find("brush") != std::string::npos);
+    CHECK(line.find("sent=+250us") != std::string::npos);
+    CHECK(line.find("confirmed=-") != std::string::npos);
+}
+
+// ============================================================================
+// CheckMan integration
+// ============================================================================
+
+TEST_CASE("CheckMan traces provenance and timing of each check", "[check_trace][checkman]")
+{
+    wolf::mock::reset();
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reserveMemory(0xC00000 + 1024);
+    apgame::initialize();
+
+    mock::MockArchipelagoSocket socket;
+    socket.setConnected(true);
+    CheckMan checkMan(socket);
+    checkMan.initialize();
+    checkMan.setTraceDumpPath({});
+    checkMan.enableSending(true);
+
+    const auto &trace = checkMan.getCheckTrace();
+
+    SECTION("Shop purchases, duplicates and server confirmation")
+    {
+        const int64_t shopCheck = checks::getShopCheckId(1, 0);
+        checkMan.onShopPurchase(1, 0, 0);
+        checkMan.onShopPurchase(1, 0, 0);
+
+        auto entry = trace.find(shopCheck);
+        REQUIRE(entry.has_value());
+        CHECK(entry->origin == CheckOrigin::ShopPurchase);
+        CHECK(entry->outcome == CheckOutcome::Duplicate);
+
+        const auto history = trace.snapshot();
+        REQUIRE(history.size() == 2);
+        CHECK(history[0].outcome == CheckOutcome::Sent);
+        CHECK(history[0].detected <= history[0].queued);
+        CHECK(history[0].queued <= history[0].sent);
+
+        checkMan.syncWithServer({shopCheck});
+        CHECK(trace.snapshot()[0].confirmed >= history[0].sent);
+    }
+
+    SECTION("Brush hook detection time is taken in the hook, not on drain")
+    {
+        socket.setSlotConfig(SlotConfig{.randomizeBrushes = true});
+        socket.setSlotConfigReady(true);
+        lifecycle::publish(lifecycle::SlotConfigReady{});
+
+        REQUIRE(wolf::mock::triggerBrushEdit(5, 0));
+        const auto afterHook = CheckTrace::Clock::now();
+        checkMan.poll();
+
+        auto entry = trace.find(checks::getBrushCheckId(5));
+        REQUIRE(entry.has_value());
+        CHECK(entry->origin == CheckOrigin::BrushHook);
+        CHECK(entry->outcome == CheckOutcome::Sent);
+        CHECK(entry->detected <= afterHook);
+        CHECK(entry->queued >= afterHook); // stamped when poll() drains the hook's queue
+        CHECK(entry->sent >= entry->queued);
+    }
+
+    SECTION("Checks while sending is paused are recorded as not sent")
+    {
+        checkMan.enableSending(false);
+        checkMan.onShopPurchase(2, 1, 0); // gated before sendCheck
+        CHECK(trace.size() == 0);
+
+        socket.setConnected(false);
+        checkMan.enableSending(true);
+        checkMan.onShopPurchase(2, 1, 0);
+        auto entry = trace.find(checks::getShopCheckId(2, 1));
+        REQUIRE(entry.has_value());
+        CHECK(entry->outcome == CheckOutcome::NotSending);
+        CHECK(entry->sent == CheckTrace::Clock::time_point{});
+    }
+
+    SECTION("ap_checks console command")
+    {
+        checkMan.onShopPurchase(3, 0, 0);
+        wolf::mock::logMessages.clear();
+
+        REQUIRE(wolf::mock::runCommand("ap_checks"));
+        REQUIRE(wolf::mock::logMessages.size() == 3);
+        CHECK(wolf::mock::logMessages[0].find("detect->send: n=1") != std::string::npos);
+        CHECK(wolf::mock::logMessages[2].find(std::to_string(checks::getShopCheckId(3, 0))) != std::string::npos);
+
+        wolf::mock::logMessages.clear();
+        REQUIRE(wolf::mock::runCommand("ap_checks", {std::to_string(checks::getShopCheckId(3, 0))}));
+        REQUIRE(wolf::mock::logMessages.size() == 1);
+        CHECK(wolf::mock::logMessages[0].find("shop") != std::string::npos);
+    }
+
+    SECTION("Trace is dumped to a file on disconnect")
+    {
+        const auto path = std::filesystem::temp_directory_path() / "okami_apclient_check_trace_test.log";
+        std::filesystem::remove(path);
+        checkMan.setTraceDumpPath(path);
+
+        checkMan.onShopPurchase(4, 2, 0);
+        lifecycle::publish(lifecycle::Disconnected{});
+
+        std::ifstream file(path);
+        REQUIRE(file.is_open());
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CHECK(contents.find("detect->send") != std::string::npos);
+        CHECK(contents.find(std::to_string(checks::getShopCheckId(4, 2))) != std::string::npos);
+
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    checkMan.shutdown();
+    CHECK_FALSE(wolf::mock::runCommand("ap_checks"));
+
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reset();
+}
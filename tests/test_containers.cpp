@@ -2,6 +2,7 @@
 #include <okami/itemtype.hpp>
 
 #include "checks/check_types.hpp"
+#include "checks/container_manifest.hpp"
 #include "checks/containers.hpp"
 #include "mock_archipelagosocket.h"
 #include "mock_spawntable.h"
@@ -243,7 +244,7 @@ TEST_CASE_METHOD(ContainerManFixture, "Hook clears tracking on level change", "[
 }
 
 // ============================================================================
-// Pickup detection tests (poll)
+// Pickup detection tests (polling fallback)
 // ============================================================================
 
 TEST_CASE_METHOD(ContainerManFixture, "poll sends check when item collected", "[containers][hooks][pickup]")
@@ -256,6 +257,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll sends check when item collected", "[
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
 
     // Copy table to mock memory for poll() to read
@@ -283,6 +285,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll ignores chest-opened state", "[conta
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
     copyTableToMockMemory(table);
 
@@ -308,6 +311,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll does not send duplicate checks", "[c
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
     copyTableToMockMemory(table);
 
@@ -337,6 +341,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll skips untracked containers", "[conta
     copyTableToMockMemory(table);
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     containerMan_->poll();
 
     // No callback - container wasn't tracked
@@ -355,6 +360,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll skips when socket disconnected", "[c
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
     copyTableToMockMemory(table);
 
@@ -382,6 +388,7 @@ TEST_CASE_METHOD(ContainerManFixture, "poll handles multiple container pickups",
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
     copyTableToMockMemory(table);
 
@@ -408,6 +415,262 @@ TEST_CASE_METHOD(ContainerManFixture, "poll handles multiple container pickups",
     TearDown();
 }
 
+// ============================================================================
+// Pickup detection tests (item pickup event)
+// ============================================================================
+
+TEST_CASE_METHOD(ContainerManFixture, "Pickup event is the default detection mode", "[containers][pickup]")
+{
+    SetUp();
+    REQUIRE(containerMan_->getDetectionMode() == checks::ContainerMan::DetectionMode::PickupEvent);
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Collected container is ignored until an item pickup is seen", "[containers][hooks][pickup]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    setCurrentMapId(0x0006);
+
+    tableBuilder_.addContainer(5, 0x42).addContainer(9, 0x43);
+    okami::SpawnTable &table = tableBuilder_.build();
+
+    containerMan_->initialize();
+    triggerSpawnTableHook(&table);
+    copyTableToMockMemory(table);
+
+    okami::SpawnTable *mockTable = getTableInMockMemory();
+    mockTable->entries[5].spawn_type_1 = 0;
+
+    // No pickup yet: poll() does not look at the table
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.empty());
+
+    containerMan_->notifyItemPickup();
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_ == std::vector<int64_t>{checks::getContainerCheckId(0x0006, 5)});
+
+    // Resolved: further collections need another pickup
+    mockTable->entries[9].spawn_type_1 = 0;
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.size() == 1);
+
+    containerMan_->notifyItemPickup();
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.size() == 2);
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Pickup resolves when the container clears on a later frame", "[containers][hooks][pickup]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    setCurrentMapId(0x0006);
+
+    tableBuilder_.addContainer(5, 0x42);
+    okami::SpawnTable &table = tableBuilder_.build();
+
+    containerMan_->initialize();
+    triggerSpawnTableHook(&table);
+    copyTableToMockMemory(table);
+
+    okami::SpawnTable *mockTable = getTableInMockMemory();
+    mockTable->entries[5].spawn_type_1 = 3; // opened, item floating
+
+    containerMan_->notifyItemPickup();
+    containerMan_->poll();
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.empty());
+
+    mockTable->entries[5].spawn_type_1 = 0;
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.size() == 1);
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Unmatched pickup stops resolving after the window", "[containers][hooks][pickup]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    setCurrentMapId(0x0006);
+
+    tableBuilder_.addContainer(5, 0x42);
+    okami::SpawnTable &table = tableBuilder_.build();
+
+    containerMan_->initialize();
+    triggerSpawnTableHook(&table);
+    copyTableToMockMemory(table);
+
+    containerMan_->notifyItemPickup(); // ground item, not a container
+    for (int i = 0; i < checks::ContainerMan::kPickupResolveTicks; i++)
+        containerMan_->poll();
+
+    getTableInMockMemory()->entries[5].spawn_type_1 = 0;
+    containerMan_->poll();
+    REQUIRE(receivedCheckIds_.empty());
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Polling fallback can be toggled from the console", "[containers][pickup]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    containerMan_->initialize();
+
+    REQUIRE(wolf::mock::runCommand("ap_container_polling", {"on"}));
+    REQUIRE(containerMan_->getDetectionMode() == checks::ContainerMan::DetectionMode::Polling);
+    REQUIRE(wolf::mock::runCommand("ap_container_polling", {"off"}));
+    REQUIRE(containerMan_->getDetectionMode() == checks::ContainerMan::DetectionMode::PickupEvent);
+
+    containerMan_->shutdown();
+    REQUIRE_FALSE(wolf::mock::runCommand("ap_container_polling"));
+
+    TearDown();
+}
+
+// ============================================================================
+// Container manifest
+// ============================================================================
+
+namespace
+{
+constexpr std::array<uint8_t, 3> kTestSpawnIndices = {5, 12, 3};
+constexpr std::array<checks::ManifestMap, 2> kTestMaps = {checks::ManifestMap{0x0006, 0, 2}, checks::ManifestMap{0x0102, 2, 1}};
+constexpr checks::ContainerManifest kTestManifest{kTestMaps, kTestSpawnIndices};
+} // namespace
+
+static_assert(kTestManifest.isValid());
+static_assert(kTestManifest.hasLevel(0x0102));
+static_assert(!kTestManifest.hasLevel(0x0007));
+static_assert(kTestManifest.spawnIndices(0x0006).size() == 2);
+static_assert(kTestManifest.spawnIndices(0x0007).empty());
+static_assert(checks::kContainerManifest.isValid());
+
+TEST_CASE("Container manifest enumerates check IDs per map", "[containers][manifest]")
+{
+    std::vector<int64_t> ids;
+    kTestManifest.forEachCheckId([&](int64_t id) { ids.push_back(id); });
+    REQUIRE(ids == std::vector<int64_t>{checks::getContainerCheckId(0x0006, 5), checks::getContainerCheckId(0x0006, 12),
+                                        checks::getContainerCheckId(0x0102, 3)});
+
+    constexpr std::array<checks::ManifestMap, 2> unsorted = {checks::ManifestMap{0x0102, 0, 2}, checks::ManifestMap{0x0006, 2, 1}};
+    REQUIRE_FALSE(checks::ContainerManifest{unsorted, kTestSpawnIndices}.isValid());
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Hook only touches manifest-listed spawn indices", "[containers][hooks][manifest]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    setCurrentMapId(0x0006);
+    containerMan_ = std::make_unique<checks::ContainerMan>(socket_, [this](int64_t checkId) { receivedCheckIds_.push_back(checkId); }, kTestManifest);
+
+    tableBuilder_.addContainer(5, 0x42).addContainer(9, 0x43);
+    okami::SpawnTable &table = tableBuilder_.build();
+
+    containerMan_->initialize();
+    triggerSpawnTableHook(&table);
+
+    REQUIRE(table.entries[5].spawn_data->item_id == EXPECTED_DUMMY_ITEM_ID);
+    REQUIRE(table.entries[9].spawn_data->item_id == 0x43); // not listed
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Unlisted maps scan the table and log indices for the manifest", "[containers][hooks][manifest]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    setCurrentMapId(0x0042);
+    containerMan_ = std::make_unique<checks::ContainerMan>(socket_, [this](int64_t checkId) { receivedCheckIds_.push_back(checkId); }, kTestManifest);
+
+    tableBuilder_.addContainer(4, 0x42).addContainer(9, 0x43);
+    okami::SpawnTable &table = tableBuilder_.build();
+
+    containerMan_->initialize();
+    triggerSpawnTableHook(&table);
+
+    REQUIRE(table.entries[4].spawn_data->item_id == EXPECTED_DUMMY_ITEM_ID);
+    REQUIRE(table.entries[9].spawn_data->item_id == EXPECTED_DUMMY_ITEM_ID);
+
+    bool logged = false;
+    for (const auto &msg : wolf::mock::logMessages)
+        logged |= msg.find("Level 0x0042 not in container manifest; containers: [4, 9]") != std::string::npos;
+    REQUIRE(logged);
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "Manifest containers are scouted at connect, not on map load", "[containers][hooks][manifest][scout]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    socket_.setPlayerSlot(1);
+    setCurrentMapId(0x0006);
+    containerMan_ = std::make_unique<checks::ContainerMan>(socket_, [this](int64_t checkId) { receivedCheckIds_.push_back(checkId); }, kTestManifest);
+
+    const int64_t id5 = checks::getContainerCheckId(0x0006, 5);
+    const int64_t id12 = checks::getContainerCheckId(0x0006, 12);
+    const int64_t id3 = checks::getContainerCheckId(0x0102, 3);
+    socket_.setScoutResponse({id5, id12, id3}, {ScoutedItem{.item = 0x05, .location = id5, .player = 1, .flags = 0}});
+
+    containerMan_->initialize();
+    containerMan_->prefetchScouts();
+    REQUIRE(socket_.getScoutRequestCount() == 1);
+    REQUIRE(containerMan_->getPrefetchedScoutCount() == 0); // sent, not waited for
+
+    // The reply lands on a later game tick
+    socket_.poll();
+    socket_.processMainThreadTasks();
+    REQUIRE(containerMan_->getPrefetchedScoutCount() == 1);
+
+    tableBuilder_.addContainer(5, 0x42);
+    okami::SpawnTable &table = tableBuilder_.build();
+    triggerSpawnTableHook(&table);
+
+    // Prefetched scout used directly: no round trip on map load
+    REQUIRE(socket_.getScoutRequestCount() == 1);
+    REQUIRE(table.entries[5].spawn_data->item_id == 0x05);
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(ContainerManFixture, "A stale prefetch reply is dropped", "[containers][manifest][scout]")
+{
+    SetUp();
+    setConnectedWithContainerRando(true);
+    socket_.setPlayerSlot(1);
+    containerMan_ = std::make_unique<checks::ContainerMan>(socket_, [this](int64_t checkId) { receivedCheckIds_.push_back(checkId); }, kTestManifest);
+
+    const int64_t id5 = checks::getContainerCheckId(0x0006, 5);
+    socket_.setDefaultScoutResponse({ScoutedItem{.item = 0x05, .location = id5, .player = 1, .flags = 0}});
+
+    containerMan_->initialize();
+
+    SECTION("Superseded by a newer prefetch")
+    {
+        containerMan_->prefetchScouts();
+        containerMan_->prefetchScouts();
+        socket_.poll();
+        socket_.processMainThreadTasks();
+        CHECK(socket_.getScoutRequestCount() == 2);
+        CHECK(containerMan_->getPrefetchedScoutCount() == 1);
+    }
+
+    SECTION("ContainerMan destroyed before the reply")
+    {
+        containerMan_->prefetchScouts();
+        containerMan_.reset();
+        socket_.poll();
+        socket_.processMainThreadTasks(); // must not touch the destroyed ContainerMan
+        CHECK(socket_.getScoutRequestCount() == 1);
+    }
+
+    TearDown();
+}
+
 // ============================================================================
 // AP dummy type selection tests (scouted item classification)
 // ============================================================================
@@ -611,6 +874,7 @@ TEST_CASE_METHOD(ContainerManFixture, "reset clears tracked containers", "[conta
     okami::SpawnTable &table = tableBuilder_.build();
 
     containerMan_->initialize();
+    containerMan_->setDetectionMode(checks::ContainerMan::DetectionMode::Polling);
     triggerSpawnTableHook(&table);
     copyTableToMockMemory(table);
 
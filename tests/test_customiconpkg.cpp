@@ -11,6 +11,7 @@
 
 #include "okami/customiconpkg.hpp"
 #include "okami/itemtype.hpp"
+#include "okami/resourcepkg.hpp"
 
 // Compile-time invariants for kIconEntries (replace removed runtime tests)
 static_assert(okami::customiconpkg::kIconEntries.size() == 13);
@@ -77,6 +78,18 @@ TEST_CASE("kIconEntries: itemType values have no duplicates", "[customiconpkg][e
     }
 }
 
+TEST_CASE("iconEntryIndex: matches a scan of kIconEntries for every item ID", "[customiconpkg][entries]")
+{
+    const auto &entries = okami::customiconpkg::kIconEntries;
+    for (int item = -1; item <= 300; ++item)
+    {
+        auto it = std::ranges::find(entries, item, &okami::customiconpkg::IconEntry::itemType);
+        const int expected = it == entries.end() ? -1 : static_cast<int>(it - entries.begin());
+        INFO("item " << item);
+        REQUIRE(okami::customiconpkg::iconEntryIndex(item) == expected);
+    }
+}
+
 // ---------------------------------------------------------------------------
 // build() tests
 // ---------------------------------------------------------------------------
@@ -190,3 +203,172 @@ TEST_CASE("buildFromFiles: output matches direct build() call", "[customiconpkg]
     // Both files must have the same size (both produced from identical data)
     REQUIRE(std::filesystem::file_size(outBff) == std::filesystem::file_size(outBuild));
 }
+
+// ---------------------------------------------------------------------------
+// buildCombinedFromFiles manifest cache
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+void writeBytes(const std::filesystem::path &path, const std::vector<uint8_t> &bytes)
+{
+    std::ofstream ofs{path, std::ios::binary};
+    ofs.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<uint8_t> readBytes(const std::filesystem::path &path)
+{
+    std::ifstream ifs{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+/// Stand-in for ItemShopBuyIcon.dat with `count` small entries.
+void writeVanillaPackage(const std::filesystem::path &path, int count)
+{
+    okami::ResourcePackage pkg;
+    for (int i = 0; i < count; ++i)
+        pkg.addEntry(okami::ResourceType{'D', 'D', 'S', '\0'}, std::vector<uint8_t>(64, static_cast<uint8_t>(i)));
+    REQUIRE(pkg.write(path));
+}
+
+struct CombinedFixture
+{
+    std::filesystem::path dir;
+    std::filesystem::path vanilla;
+    std::filesystem::path dds;
+    std::filesystem::path out;
+
+    explicit CombinedFixture(const char *name)
+        : dir(testTempDir() / name), vanilla(dir / "ItemShopBuyIcon.dat"), dds(dir / "ap.dds"), out(dir / "archipelago" / "customicons.dat")
+    {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        writeVanillaPackage(vanilla, 5);
+        writeBytes(dds, fakeDDSData(128));
+    }
+
+    bool build(okami::customiconpkg::CombinedPackage &layout) const
+    {
+        return okami::customiconpkg::buildCombinedFromFiles(out, vanilla, dds, dds, dds, layout);
+    }
+
+    /// Same-size junk, so only a rebuild can restore the real package.
+    void scribbleOutput() const
+    {
+        writeBytes(out, std::vector<uint8_t>(std::filesystem::file_size(out), 0xEE));
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("buildCombinedFromFiles: writes a manifest and skips unchanged rebuilds", "[customiconpkg][manifest]")
+{
+    CombinedFixture fx("combined_cache");
+
+    okami::customiconpkg::CombinedPackage layout;
+    REQUIRE(fx.build(layout));
+    CHECK(layout.vanillaCount == 5);
+    REQUIRE(std::filesystem::exists(okami::customiconpkg::manifestPath(fx.out)));
+    const auto built = readBytes(fx.out);
+
+    fx.scribbleOutput();
+    okami::customiconpkg::CombinedPackage cached;
+    REQUIRE(fx.build(cached));
+    CHECK(cached.vanillaCount == 5);
+    CHECK(cached.iconIndex == layout.iconIndex);
+    CHECK(readBytes(fx.out) == std::vector<uint8_t>(built.size(), 0xEE)); // left alone
+}
+
+TEST_CASE("buildCombinedFromFiles: rebuilds when an input or the output changes", "[customiconpkg][manifest]")
+{
+    CombinedFixture fx("combined_rebuild");
+
+    okami::customiconpkg::CombinedPackage layout;
+    REQUIRE(fx.build(layout));
+    const auto built = readBytes(fx.out);
+
+    SECTION("DDS contents change")
+    {
+        fx.scribbleOutput();
+        writeBytes(fx.dds, fakeDDSData(256));
+        REQUIRE(fx.build(layout));
+        CHECK(readBytes(fx.out).size() > built.size());
+    }
+
+    SECTION("Vanilla package changes")
+    {
+        writeVanillaPackage(fx.vanilla, 7);
+        REQUIRE(fx.build(layout));
+        CHECK(layout.vanillaCount == 7);
+    }
+
+    SECTION("Output is missing")
+    {
+        std::filesystem::remove(fx.out);
+        REQUIRE(fx.build(layout));
+        CHECK(readBytes(fx.out) == built);
+    }
+
+    SECTION("Output was truncated")
+    {
+        writeBytes(fx.out, std::vector<uint8_t>(16, 0));
+        REQUIRE(fx.build(layout));
+        CHECK(readBytes(fx.out) == built);
+    }
+
+    SECTION("Manifest is corrupt")
+    {
+        fx.scribbleOutput();
+        writeBytes(okami::customiconpkg::manifestPath(fx.out), {1, 2, 3});
+        REQUIRE(fx.build(layout));
+        CHECK(readBytes(fx.out) == built);
+    }
+
+    CHECK(layout.vanillaCount > 0);
+}
+
+TEST_CASE("buildCombinedFromFiles: failed builds leave no manifest", "[customiconpkg][manifest]")
+{
+    CombinedFixture fx("combined_fail");
+
+    okami::customiconpkg::CombinedPackage layout;
+    REQUIRE(fx.build(layout));
+
+    writeBytes(fx.vanilla, {});
+    CHECK_FALSE(fx.build(layout));
+    CHECK(layout.vanillaCount == 0);
+
+    // Garbage that still hashes differently reaches the parser, which rejects it
+    writeBytes(fx.vanilla, std::vector<uint8_t>(8, 0xFF));
+    CHECK_FALSE(fx.build(layout));
+    CHECK_FALSE(std::filesystem::exists(okami::customiconpkg::manifestPath(fx.out)));
+}
+
+TEST_CASE("buildCombinedFromFiles: stores each distinct icon once", "[customiconpkg][dedup]")
+{
+    CombinedFixture fx("combined_dedup");
+    const std::array<std::filesystem::path, 3> ddsPaths{fx.dir / "standard.dds", fx.dir / "progression.dds", fx.dir / "trap.dds"};
+    for (size_t i = 0; i < ddsPaths.size(); ++i)
+        writeBytes(ddsPaths[i], fakeDDSData(128 + i * 8));
+
+    okami::customiconpkg::CombinedPackage layout;
+    REQUIRE(okami::customiconpkg::buildCombinedFromFiles(fx.out, fx.vanilla, ddsPaths[0], ddsPaths[1], ddsPaths[2], layout));
+    CHECK(layout.vanillaCount == 5);
+    CHECK(layout.iconCount == 3);
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(fx.out));
+    REQUIRE(reader.size() == 5 + 3);
+
+    // Every row resolves to an entry holding its own DDS file
+    const auto &entries = okami::customiconpkg::kIconEntries;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto index = layout.iconIndex[i];
+        REQUIRE(index >= 5);
+        CHECK(std::ranges::equal(reader.entry(index), readBytes(ddsPaths[static_cast<size_t>(entries[i].ddsIndex)])));
+        for (size_t j = 0; j < i; ++j)
+            CHECK((layout.iconIndex[j] == index) == (entries[j].ddsIndex == entries[i].ddsIndex));
+    }
+}
@@ -0,0 +1,264 @@
+#include <array>
+#include <cstring>
+
+#include <catch2/catch_test_macros.hpp>
+#include <okami/itemtype.hpp>
+#include <okami/maptype.hpp>
+#include <okami/structs.hpp>
+
+#include "alloc_counter.h"
+#include "checks/check_types.hpp"
+#include "checks/containers.hpp"
+#include "checks/shops.hpp"
+#include "gamestate_accessors.hpp"
+#include "itempatch.hpp"
+#include "mock_archipelagosocket.h"
+#include "mock_spawntable.h"
+#include "wolf_framework.hpp"
+
+// Detours that run on the game thread every frame (MSD string lookups, shop
+// slot state, item pickups) must not touch the heap: no allocation, and no
+// formatted logging, which the mock logger turns into allocations too.
+
+namespace
+{
+
+// itempatch hook offsets
+constexpr uintptr_t kGetMSDStringOffset = 0x1C8A80;
+constexpr uintptr_t kGetItemIconOffset = 0x43BDA0;
+constexpr uintptr_t kBuildItemResourceNameOffset = 0x450b90;
+
+// ShopMan hook offsets
+constexpr uintptr_t kLoadRscOffset = 0x1B1770;
+constexpr uintptr_t kItemShopPurchaseOffset = 0x43CA30;
+constexpr uintptr_t kIsGrayedOutOffset = 0x43b6a0;
+constexpr uintptr_t kIsPurchasedOffset = 0x43bae0;
+constexpr uintptr_t kExteriorMapIdOffset = 0xB6B240;
+
+using GetMSDStringFn = const uint16_t *(__fastcall *)(void *, uint16_t);
+using GetItemIconFn = hx::Texture *(__fastcall *)(okami::cItemShop *, int);
+using BuildItemResourceNameFn = void(__fastcall *)(void *, int, uint32_t, char *);
+using LoadRscFn = const void *(__fastcall *)(void *, const char *, uint32_t);
+using ItemShopPurchaseFn = void(__fastcall *)(void *);
+using ShopSlotQueryFn = int(__fastcall *)(void *, int);
+
+// Stand-in originals so the detours can be driven down their pass-through paths
+const uint16_t kVanillaString[] = {0};
+uint32_t g_lastResourceItemId = 0;
+int g_originalIconCalls = 0;
+
+const uint16_t *__fastcall fakeGetMSDString(void *, uint16_t)
+{
+    return kVanillaString;
+}
+
+hx::Texture *__fastcall fakeGetItemIcon(okami::cItemShop *, int)
+{
+    ++g_originalIconCalls;
+    return nullptr;
+}
+
+void __fastcall fakeBuildItemResourceName(void *, int, uint32_t itemId, char *)
+{
+    g_lastResourceItemId = itemId;
+}
+
+// Completes a purchase: sub-state 1 -> 0, outer state -> 3 (confirmed)
+void __fastcall fakeItemShopPurchase(void *pShop)
+{
+    auto *shopBase = static_cast<uint8_t *>(pShop);
+    shopBase[0x96] = 0;
+    shopBase[0x95] = 3;
+}
+
+template <typename Fn> Fn registeredHook(uintptr_t offset)
+{
+    return reinterpret_cast<Fn>(wolf::mock::registeredHooks.at(offset));
+}
+
+} // namespace
+
+TEST_CASE("Allocation counter sees heap use", "[alloc]")
+{
+    wolf::mock::logMessages.clear();
+    wolf::mock::logMessages.shrink_to_fit();
+
+    mock::AllocationCounter allocs;
+    wolf::logDebug("[test] formatted %d", 42);
+    CHECK(allocs.count() > 0);
+
+    wolf::mock::logMessages.clear();
+}
+
+TEST_CASE("itempatch string, icon and resource hooks do not allocate", "[alloc][itempatch]")
+{
+    wolf::mock::reset();
+    itempatch::resetState();
+    wolf::mock::hookOriginals[kGetMSDStringOffset] = reinterpret_cast<void *>(&fakeGetMSDString);
+    wolf::mock::hookOriginals[kGetItemIconOffset] = reinterpret_cast<void *>(&fakeGetItemIcon);
+    wolf::mock::hookOriginals[kBuildItemResourceNameOffset] = reinterpret_cast<void *>(&fakeBuildItemResourceName);
+    itempatch::initialize();
+
+    auto getMSDString = registeredHook<GetMSDStringFn>(kGetMSDStringOffset);
+    auto getItemIcon = registeredHook<GetItemIconFn>(kGetItemIconOffset);
+    auto buildItemResourceName = registeredHook<BuildItemResourceNameFn>(kBuildItemResourceNameOffset);
+
+    constexpr int kShopId = 5;
+    std::array<uint8_t, 0x8C> shopBuffer{};
+    shopBuffer[0x8B] = 1; // slot 1 selected
+    itempatch::registerScoutedItemName(checks::getShopCheckId(kShopId, 1), "Fire Arrow");
+    itempatch::registerScoutedItemName(checks::getContainerCheckId(6, 3), "Progressive Sword");
+    itempatch::setCurrentShopId(kShopId);
+    itempatch::setShopPointer(shopBuffer.data());
+
+    const uint16_t infoPanelId = okami::ItemTypes::ForeignStandardItem + 0x2000;
+    const uint16_t listId = okami::ItemTypes::OkamiProgressionItem + 294;
+    okami::cItemShop iconShop{};
+    char resourceName[64] = {};
+
+    SECTION("Shop context")
+    {
+        mock::AllocationCounter allocs;
+        const uint16_t *apInfo = getMSDString(nullptr, infoPanelId);
+        const uint16_t *apList = getMSDString(nullptr, listId);
+        const uint16_t *remapped = getMSDString(nullptr, okami::ItemTypes::HolyBoneS + 0x2000);
+        const uint16_t *custom = getMSDString(nullptr, 0x1000);
+        const uint16_t *vanilla = getMSDString(nullptr, 10);
+        getItemIcon(&iconShop, okami::ItemTypes::ForeignStandardItem);
+        getItemIcon(&iconShop, okami::ItemTypes::HolyBoneS);
+        buildItemResourceName(nullptr, 0, okami::ItemTypes::ForeignTrapItem, resourceName);
+        const uint32_t redirectedId = g_lastResourceItemId;
+        buildItemResourceName(nullptr, 0, okami::ItemTypes::HolyBoneS, resourceName);
+        CHECK(allocs.count() == 0);
+
+        REQUIRE(apInfo != nullptr);
+        CHECK(apInfo != kVanillaString);
+        CHECK(apList == apInfo);
+        CHECK(remapped == kVanillaString);
+        CHECK(custom == apInfo);
+        CHECK(vanilla == kVanillaString);
+        CHECK(g_originalIconCalls >= 2);
+        CHECK(redirectedId == 0x83);
+        CHECK(g_lastResourceItemId == okami::ItemTypes::HolyBoneS);
+    }
+
+    SECTION("Container context")
+    {
+        itempatch::clearShopContext();
+        itempatch::setContainerContext(checks::getContainerCheckId(6, 3));
+
+        mock::AllocationCounter allocs;
+        const uint16_t *name = getMSDString(nullptr, listId);
+        const uint16_t *missing = getMSDString(nullptr, 0x1FFF);
+        CHECK(allocs.count() == 0);
+
+        CHECK(name != nullptr);
+        CHECK(name != kVanillaString);
+        CHECK(missing == kVanillaString);
+    }
+
+    itempatch::resetState();
+    wolf::mock::reset();
+}
+
+TEST_CASE("ShopMan slot state hooks do not allocate", "[alloc][shops]")
+{
+    wolf::mock::reset();
+    itempatch::resetState();
+    wolf::mock::reserveMemory(0xC00000 + 1024);
+    apgame::initialize();
+    *reinterpret_cast<uint16_t *>(&wolf::mock::mockMemory[kExteriorMapIdOffset]) = okami::MapID::KamikiVillage;
+    wolf::mock::hookOriginals[kItemShopPurchaseOffset] = reinterpret_cast<void *>(&fakeItemShopPurchase);
+
+    mock::MockArchipelagoSocket socket;
+    socket.setConnected(true);
+    socket.setSlotConfig(SlotConfig{.randomizeShops = true});
+
+    std::vector<int64_t> purchases;
+    checks::ShopMan shopMan(socket, [&](int64_t checkId) { purchases.push_back(checkId); });
+    shopMan.initialize();
+
+    // Opening the shop selects its shop ID
+    registeredHook<LoadRscFn>(kLoadRscOffset)(nullptr, "ISL", 0);
+
+    std::array<uint8_t, 0x100> shopBuffer{};
+    std::array<uint8_t, 0x20 * checks::MaxShopStockSize> stock{};
+    uint8_t *stockPtr = stock.data();
+    std::memcpy(&shopBuffer[0x48], &stockPtr, sizeof(stockPtr));
+    for (size_t slot = 0; slot < checks::MaxShopStockSize; ++slot)
+    {
+        const int32_t cost = 100;
+        std::memcpy(&stock[slot * 0x20 + 0x10], &cost, sizeof(cost));
+    }
+    apgame::collectionData->currentMoney = 1000;
+
+    // Buy slot 2
+    shopBuffer[0x8B] = 2;
+    shopBuffer[0x96] = 1;
+    registeredHook<ItemShopPurchaseFn>(kItemShopPurchaseOffset)(shopBuffer.data());
+    REQUIRE(purchases.size() == 1);
+
+    auto isGrayedOut = registeredHook<ShopSlotQueryFn>(kIsGrayedOutOffset);
+    auto isPurchased = registeredHook<ShopSlotQueryFn>(kIsPurchasedOffset);
+
+    mock::AllocationCounter allocs;
+    const int boughtGrayed = isGrayedOut(shopBuffer.data(), 2);
+    const int boughtPurchased = isPurchased(shopBuffer.data(), 2);
+    const int openGrayed = isGrayedOut(shopBuffer.data(), 3);
+    const int openPurchased = isPurchased(shopBuffer.data(), 3);
+    const int outOfRange = isPurchased(shopBuffer.data(), static_cast<int>(checks::MaxShopStockSize));
+    CHECK(allocs.count() == 0);
+
+    CHECK(boughtGrayed == 0);
+    CHECK(boughtPurchased == 1);
+    CHECK(openGrayed == 1);
+    CHECK(openPurchased == 0);
+    CHECK(outOfRange == 0);
+
+    shopMan.reset();
+    CHECK(isPurchased(shopBuffer.data(), 2) == 0);
+
+    shopMan.shutdown();
+    itempatch::resetState();
+    wolf::mock::reset();
+}
+
+TEST_CASE("ContainerMan pickup hook path does not allocate", "[alloc][containers]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(checks::SPAWN_TABLE_OFFSET + sizeof(okami::SpawnTable) + checks::CURRENT_MAP_ID_OFFSET + sizeof(uint16_t));
+    *reinterpret_cast<uint16_t *>(&wolf::mock::mockMemory[checks::CURRENT_MAP_ID_OFFSET]) = 0x0006;
+
+    mock::MockArchipelagoSocket socket;
+    socket.setConnected(true);
+    socket.setSlotConfig(SlotConfig{.randomizeContainers = true});
+    socket.setSlotConfigReady(true);
+
+    checks::ContainerMan containerMan(socket, [](int64_t) {});
+    containerMan.initialize();
+
+    // Two unscouted containers fall back to the same dummy item
+    mock::SpawnTableBuilder builder;
+    builder.addContainer(0, 0x42).addContainer(1, 0x43);
+    okami::SpawnTable &table = builder.build();
+    using SpawnTablePopulatorFn = void (*)(void *);
+    wolf::mock::triggerHook<SpawnTablePopulatorFn>(checks::SPAWN_TABLE_POPULATOR_OFFSET, &table);
+    const int dummyItem = table.entries[0].spawn_data->item_id;
+
+    mock::AllocationCounter allocs;
+    containerMan.notifyItemPickup();
+    const bool first = containerMan.shouldBlockItemPickup(dummyItem);
+    const bool second = containerMan.shouldBlockItemPickup(dummyItem);
+    const bool third = containerMan.shouldBlockItemPickup(dummyItem);
+    const bool unrelated = containerMan.shouldBlockItemPickup(0x42);
+    CHECK(allocs.count() == 0);
+
+    // One block per randomized container holding the item
+    CHECK(first);
+    CHECK(second);
+    CHECK_FALSE(third);
+    CHECK_FALSE(unrelated);
+
+    containerMan.shutdown();
+    wolf::mock::reset();
+}
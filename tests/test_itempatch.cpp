@@ -1,4 +1,8 @@
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <okami/msd.h>
 
@@ -189,6 +193,224 @@ TEST_CASE("MSDManager: OverrideString at invalid index is a no-op", "[msd][blob]
     REQUIRE(mgr.Size() == 1);
 }
 
+TEST_CASE("MSDManager: CompileString ASCII runs match the glyph table", "[msd][utf8]")
+{
+    // Every printable character, at every alignment and run length the
+    // 16-byte fast path can see, including partial blocks and tails
+    std::string printable;
+    for (char c = ' '; c <= '~'; ++c)
+        printable += c;
+
+    for (size_t start = 0; start < 20; ++start)
+    {
+        for (size_t length : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 75u})
+        {
+            const std::string text = (printable + printable).substr(start, length);
+            const auto compiled = okami::MSDManager::CompileString(text);
+            REQUIRE(compiled.size() == text.size() + 1);
+            for (size_t i = 0; i < text.size(); ++i)
+            {
+                INFO("char '" << text[i] << "' at " << i);
+                CHECK(compiled[i] == okami::MSDManager::CompileString(std::string(1, text[i]))[0]);
+            }
+            CHECK(compiled.back() == 0x8001);
+        }
+    }
+}
+
+namespace
+{
+
+std::string utf8(std::u8string_view text)
+{
+    return std::string(text.begin(), text.end());
+}
+
+} // namespace
+
+TEST_CASE("MSDManager: CompileString transcodes UTF-8 to the nearest glyphs", "[msd][utf8]")
+{
+    using okami::MSDManager;
+    constexpr uint16_t kUnsupported = 201;
+
+    SECTION("Accented Latin letters drop their accents")
+    {
+        CHECK(MSDManager::CompileString(utf8(u8"Pokémon Ñandú Łódź")) == MSDManager::CompileString("Pokemon Nandu Lodz"));
+        CHECK(MSDManager::CompileString(utf8(u8"ÀÿĀſ")) == MSDManager::CompileString("AyAs"));
+    }
+
+    SECTION("Ligatures and typographic punctuation are spelled out")
+    {
+        CHECK(MSDManager::CompileString(utf8(u8"Æsir’s “Œuvre” — Straße…")) ==
+              MSDManager::CompileString("AEsir's \"OEuvre\" - Strasse..."));
+    }
+
+    SECTION("Full-width forms are narrowed")
+    {
+        CHECK(MSDManager::CompileString(utf8(u8"Ａｂｃ１！　x")) == MSDManager::CompileString("Abc1! x"));
+    }
+
+    SECTION("Characters without a glyph become one marker per code point")
+    {
+        // Three CJK characters (3 bytes each) and an emoji (4 bytes)
+        const auto compiled = MSDManager::CompileString(utf8(u8"ゼルダ \U0001F43A"));
+        CHECK(compiled == std::vector<uint16_t>{kUnsupported, kUnsupported, kUnsupported, 0, kUnsupported, 0x8001});
+    }
+
+    SECTION("Malformed sequences cost one marker per byte and don't swallow ASCII")
+    {
+        // Lone continuation, overlong '/', truncated 3-byte sequence, encoded surrogate
+        const auto compiled = MSDManager::CompileString("A\x80"
+                                                        "B\xC0\xAF"
+                                                        "C\xE2\x80"
+                                                        "D\xED\xA0\x80");
+        CHECK(compiled == std::vector<uint16_t>{23, kUnsupported, 24, kUnsupported, kUnsupported, 25, kUnsupported, kUnsupported, 26, kUnsupported,
+                                                kUnsupported, kUnsupported, 0x8001});
+    }
+
+    SECTION("Non-ASCII inside and across 16-byte blocks")
+    {
+        CHECK(MSDManager::CompileString(utf8(u8"Progressive Sworð of Cafés and Résumés")) ==
+              MSDManager::CompileString("Progressive Sword of Cafes and Resumes"));
+    }
+
+    SECTION("Output never exceeds CompiledLength")
+    {
+        for (const std::string &text : {utf8(u8"……"), utf8(u8"ßÆŒ"), utf8(u8"Ａ\U0001F43A"), std::string("\xE2\x80")})
+            CHECK(MSDManager::CompileString(text).size() <= MSDManager::CompiledLength(text));
+    }
+}
+
+namespace
+{
+
+// MSD image with one-character strings 'A' (23), 'B' (24), ... laid out back to back
+std::vector<uint8_t> buildLetterMSD(uint32_t count)
+{
+    std::vector<uint8_t> msdData(sizeof(uint32_t) + count * sizeof(uint64_t) + count * 2 * sizeof(uint16_t));
+    std::memcpy(msdData.data(), &count, sizeof(count));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint64_t offset = sizeof(uint32_t) + count * sizeof(uint64_t) + i * 2 * sizeof(uint16_t);
+        const uint16_t str[2] = {static_cast<uint16_t>(23 + i), 0x8001};
+        std::memcpy(msdData.data() + sizeof(uint32_t) + i * sizeof(uint64_t), &offset, sizeof(offset));
+        std::memcpy(msdData.data() + offset, str, sizeof(str));
+    }
+    return msdData;
+}
+
+// String i of an MSD image, resolved the way the game does: base + offset
+const uint16_t *msdString(const uint8_t *msd, uint32_t index)
+{
+    uint64_t offset;
+    std::memcpy(&offset, msd + sizeof(uint32_t) + index * sizeof(uint64_t), sizeof(offset));
+    return reinterpret_cast<const uint16_t *>(msd + offset);
+}
+
+uint32_t msdCount(const uint8_t *msd)
+{
+    uint32_t count;
+    std::memcpy(&count, msd, sizeof(count));
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("MSDManager: OverlayMSD needs the original only while it reads it", "[msd][blob]")
+{
+    auto original = buildLetterMSD(50);
+    okami::MSDManager mgr;
+    mgr.OverlayMSD(original.data());
+    REQUIRE(mgr.Size() == 50);
+
+    // The game may free or reuse its buffer once the overlay is made
+    std::ranges::fill(original, 0xCD);
+
+    mgr.OverrideString(3, "Hi");
+    const uint8_t *out = mgr.GetData();
+    REQUIRE(out != nullptr);
+    REQUIRE(msdCount(out) == 50);
+
+    // Untouched strings are copies inside the output, after the offset table
+    const uint8_t *tableEnd = out + sizeof(uint32_t) + 50 * sizeof(uint64_t);
+    for (uint32_t i : {0u, 49u})
+    {
+        const auto *str = reinterpret_cast<const uint8_t *>(msdString(out, i));
+        CHECK(str >= tableEnd);
+        CHECK(msdString(out, i)[0] == 23 + i);
+        CHECK(msdString(out, i)[1] == 0x8001);
+    }
+    CHECK(mgr.GetString(49)[0] == 23 + 49);
+
+    // The patched one follows the copied strings
+    const uint16_t *patched = msdString(out, 3);
+    CHECK(patched > msdString(out, 49));
+    CHECK(patched[0] == 30); // 'H'
+    CHECK(patched[1] == 57); // 'i'
+    CHECK(patched[2] == 0x8001);
+    CHECK(mgr.GetString(3)[0] == 30);
+    CHECK(mgr.GetString(50) == nullptr);
+}
+
+TEST_CASE("MSDManager: changes after GetData are applied in place", "[msd][blob]")
+{
+    const auto original = buildLetterMSD(10);
+    okami::MSDManager mgr;
+    mgr.OverlayMSD(original.data());
+    mgr.OverrideString(0, "Hi");
+    const uint8_t *out = mgr.GetData();
+
+    SECTION("Overrides and additions keep the buffer")
+    {
+        mgr.OverrideString(5, "Ok");
+        const uint32_t added = mgr.AddString("A");
+        CHECK(added == 10);
+
+        CHECK(mgr.GetData() == out);
+        CHECK(msdCount(out) == 11);
+        CHECK(msdString(out, 5)[0] == 37); // 'O'
+        CHECK(msdString(out, 10)[0] == 23);
+        CHECK(msdString(out, 10)[1] == 0x8001);
+        CHECK(msdString(out, 0)[0] == 30);
+        CHECK(msdString(out, 6)[0] == 23 + 6);
+    }
+
+    SECTION("Running out of spare space falls back to a full rebuild")
+    {
+        const std::string longName(3000, 'x');
+        mgr.OverrideString(1, longName);
+        mgr.OverrideString(2, longName); // no longer fits
+
+        const uint8_t *rebuilt = mgr.GetData();
+        REQUIRE(msdCount(rebuilt) == 10);
+        CHECK(msdString(rebuilt, 1)[0] == 72); // 'x'
+        CHECK(msdString(rebuilt, 2)[2999] == 72);
+        CHECK(msdString(rebuilt, 2)[3000] == 0x8001);
+        CHECK(msdString(rebuilt, 0)[0] == 30);
+        CHECK(msdString(rebuilt, 9)[0] == 23 + 9);
+    }
+}
+
+TEST_CASE("MSDManager: copy mode overrides are applied in place", "[msd][blob]")
+{
+    const auto original = buildLetterMSD(4);
+    okami::MSDManager mgr;
+    mgr.ReadMSD(original.data());
+    const uint8_t *out = mgr.GetData();
+
+    mgr.OverrideString(2, "Hi");
+    CHECK(mgr.GetData() == out);
+    CHECK(msdString(out, 2)[0] == 30);
+    CHECK(msdString(out, 3)[0] == 23 + 3);
+
+    // Copy mode keeps the exact table size, so additions rebuild
+    CHECK(mgr.AddString("Ok") == 4);
+    const uint8_t *rebuilt = mgr.GetData();
+    REQUIRE(msdCount(rebuilt) == 5);
+    CHECK(msdString(rebuilt, 4)[0] == 37);
+    CHECK(msdString(rebuilt, 2)[0] == 30);
+}
+
 // ============================================================================
 // ItemParam patching tests
 // These tests USE mock memory and call apgame::initialize() first.
@@ -384,6 +606,29 @@ TEST_CASE("CompileString: produces valid MSD encoding with EndDialog terminator"
     REQUIRE(compiled.size() == 11); // 10 chars + EndDialog
 }
 
+TEST_CASE("isApDummyStrId: exactly the dummy types on the list and info panel paths", "[itempatch][msd]")
+{
+    std::vector<uint16_t> expected;
+    for (uint16_t item : okami::ItemTypes::kApDummyItems)
+    {
+        expected.push_back(static_cast<uint16_t>(item + 294));
+        expected.push_back(static_cast<uint16_t>(item + 0x2000));
+    }
+
+    size_t matches = 0;
+    for (uint32_t index = 0; index <= UINT16_MAX; ++index)
+    {
+        const bool dummy = itempatch::isApDummyStrId(static_cast<uint16_t>(index));
+        if (dummy)
+        {
+            ++matches;
+            INFO("strId 0x" << std::hex << index);
+            CHECK(std::ranges::find(expected, index) != expected.end());
+        }
+    }
+    CHECK(matches == expected.size());
+}
+
 TEST_CASE("getShopCheckId produces correct location IDs for shop slots", "[itempatch][shops]")
 {
     // Verify the mapping used by hookGetMSDString to resolve selected slots
@@ -0,0 +1,194 @@
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "checkman.h"
+#include "checks/brushes.hpp"
+#include "gamestate_accessors.hpp"
+#include "lifecycle.h"
+#include "mock_archipelagosocket.h"
+#include "rewardman.h"
+#include "wolf_framework.hpp"
+
+// ============================================================================
+// Bus mechanics
+// ============================================================================
+
+TEST_CASE("Lifecycle events are delivered only to their own subscribers", "[lifecycle]")
+{
+    lifecycle::detail::resetForTests();
+
+    int connected = 0;
+    int disconnected = 0;
+    auto connectedSub = lifecycle::subscribe<lifecycle::Connected>([&](const auto &) { connected++; });
+    auto disconnectedSub = lifecycle::subscribe<lifecycle::Disconnected>([&](const auto &) { disconnected++; });
+
+    lifecycle::publish(lifecycle::Connected{});
+    lifecycle::publish(lifecycle::Connected{});
+    lifecycle::publish(lifecycle::Disconnected{});
+
+    CHECK(connected == 2);
+    CHECK(disconnected == 1);
+
+    lifecycle::detail::resetForTests();
+}
+
+TEST_CASE("Lifecycle subscriptions unsubscribe on destruction", "[lifecycle]")
+{
+    lifecycle::detail::resetForTests();
+
+    int calls = 0;
+
+    SECTION("Destroyed handle stops delivery")
+    {
+        {
+            auto sub = lifecycle::subscribe<lifecycle::PlayStart>([&](const auto &) { calls++; });
+            lifecycle::publish(lifecycle::PlayStart{});
+        }
+        lifecycle::publish(lifecycle::PlayStart{});
+        CHECK(calls == 1);
+    }
+
+    SECTION("Moved handle keeps the subscription alive")
+    {
+        lifecycle::Subscription outer;
+        {
+            auto sub = lifecycle::subscribe<lifecycle::PlayStart>([&](const auto &) { calls++; });
+            outer = std::move(sub);
+        }
+        lifecycle::publish(lifecycle::PlayStart{});
+        CHECK(calls == 1);
+
+        outer.reset();
+        lifecycle::publish(lifecycle::PlayStart{});
+        CHECK(calls == 1);
+    }
+
+    lifecycle::detail::resetForTests();
+}
+
+TEST_CASE("Lifecycle handlers may unsubscribe themselves during dispatch", "[lifecycle]")
+{
+    lifecycle::detail::resetForTests();
+
+    int calls = 0;
+    lifecycle::Subscription self;
+    self = lifecycle::subscribe<lifecycle::ReturnToMenu>(
+        [&](const auto &)
+        {
+            calls++;
+            self.reset();
+        });
+
+    lifecycle::publish(lifecycle::ReturnToMenu{});
+    lifecycle::publish(lifecycle::ReturnToMenu{});
+    CHECK(calls == 1);
+
+    lifecycle::detail::resetForTests();
+}
+
+TEST_CASE("MapChanged is published only on transitions", "[lifecycle]")
+{
+    lifecycle::detail::resetForTests();
+
+    std::vector<lifecycle::MapChanged> seen;
+    auto sub = lifecycle::subscribe<lifecycle::MapChanged>([&](const lifecycle::MapChanged &e) { seen.push_back(e); });
+
+    lifecycle::updateMapId(0x100);
+    lifecycle::updateMapId(0x100);
+    lifecycle::updateMapId(0x100);
+    lifecycle::updateMapId(0x102);
+
+    REQUIRE(seen.size() == 2);
+    CHECK(seen[0].previousMapId == lifecycle::MapChanged::kNoMap);
+    CHECK(seen[0].mapId == 0x100);
+    CHECK(seen[1].previousMapId == 0x100);
+    CHECK(seen[1].mapId == 0x102);
+
+    lifecycle::detail::resetForTests();
+}
+
+TEST_CASE("Wolf play/menu callbacks are bridged onto the bus", "[lifecycle]")
+{
+    wolf::mock::reset();
+    lifecycle::detail::resetForTests();
+    lifecycle::bindWolfCallbacks();
+
+    int playStarts = 0;
+    int menuReturns = 0;
+    auto playSub = lifecycle::subscribe<lifecycle::PlayStart>([&](const auto &) { playStarts++; });
+    auto menuSub = lifecycle::subscribe<lifecycle::ReturnToMenu>([&](const auto &) { menuReturns++; });
+
+    wolf::mock::triggerPlayStart();
+    wolf::mock::triggerReturnToMenu();
+    wolf::mock::triggerPlayStart();
+
+    CHECK(playStarts == 2);
+    CHECK(menuReturns == 1);
+
+    lifecycle::detail::resetForTests();
+    wolf::mock::reset();
+}
+
+// ============================================================================
+// Manager reactions
+// ============================================================================
+
+TEST_CASE("RewardMan granting follows PlayStart / ReturnToMenu events", "[lifecycle][rewardman]")
+{
+    lifecycle::detail::resetForTests();
+
+    {
+        RewardMan rewardMan(nullptr);
+        CHECK_FALSE(rewardMan.isGrantingEnabled());
+
+        lifecycle::publish(lifecycle::PlayStart{});
+        CHECK(rewardMan.isGrantingEnabled());
+
+        lifecycle::publish(lifecycle::ReturnToMenu{});
+        CHECK_FALSE(rewardMan.isGrantingEnabled());
+    }
+
+    // A destroyed RewardMan must not be reachable from the bus
+    lifecycle::publish(lifecycle::PlayStart{});
+
+    lifecycle::detail::resetForTests();
+}
+
+TEST_CASE("CheckMan brush blocking follows connection events, not polling", "[lifecycle][checkman]")
+{
+    wolf::mock::reset();
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reserveMemory(0xC00000 + 1024);
+    apgame::initialize();
+
+    mock::MockArchipelagoSocket socket;
+    CheckMan checkMan(socket);
+    checkMan.initialize();
+
+    constexpr int kBrushBit = 5;
+    constexpr int kBrushOpSet = 0;
+
+    // Connected, but slot config not yet parsed: nothing to block
+    socket.setConnected(true);
+    lifecycle::publish(lifecycle::Connected{});
+    CHECK(checkMan.isSendingEnabled());
+    CHECK_FALSE(wolf::mock::triggerBrushEdit(kBrushBit, kBrushOpSet));
+
+    // Slot config arrives — no poll() needed for the hook to go live
+    socket.setSlotConfig(SlotConfig{.randomizeBrushes = true});
+    socket.setSlotConfigReady(true);
+    lifecycle::publish(lifecycle::SlotConfigReady{});
+    CHECK(wolf::mock::triggerBrushEdit(kBrushBit, kBrushOpSet));
+
+    // Dropped connection deactivates blocking
+    socket.setConnected(false);
+    lifecycle::publish(lifecycle::Disconnected{});
+    CHECK_FALSE(wolf::mock::triggerBrushEdit(kBrushBit, kBrushOpSet));
+
+    checkMan.shutdown();
+    lifecycle::detail::resetForTests();
+    checks::detail::resetBrushHookRegistrationForTests();
+    wolf::mock::reset();
+}
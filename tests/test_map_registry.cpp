@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <optional>
+
+#include <catch2/catch_test_macros.hpp>
+#include <okami/maps.hpp>
+#include <okami/maptype.hpp>
+
+#include "checks/map_registry.hpp"
+
+using checks::mapInfo;
+
+namespace
+{
+
+// Reference lookups straight over the source tables
+std::optional<int> scanShopMap(uint16_t mapId, uint32_t shopNum)
+{
+    for (const auto &entry : checks::kShopMap)
+    {
+        if (entry.mapId == mapId && (entry.shopNum == checks::kAnyShopNum || entry.shopNum == shopNum))
+            return entry.shopId;
+    }
+    return std::nullopt;
+}
+
+std::optional<int> scanFangShopMap(uint16_t mapId)
+{
+    for (const auto &entry : checks::kFangShopMap)
+    {
+        if (entry.mapId == mapId)
+            return entry.shopId;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+// The whole registry is a constant expression
+static_assert(mapInfo(okami::MapID::SeianCityCommonersQuarter).shopId(0) == 16);
+static_assert(mapInfo(okami::MapID::SeianCityCommonersQuarter).shopId(1) == 17);
+static_assert(!mapInfo(okami::MapID::SeianCityCommonersQuarter).shopId(2).has_value());
+static_assert(mapInfo(okami::MapID::KamikiVillagePostTei).mapType == okami::MapTypes::KamikiVillage);
+static_assert(mapInfo(okami::MapID::ArkofYamato).fangShop() == checks::FANG_SHOP_ID_BASE + 1);
+static_assert(!mapInfo(0xFFFF).known());
+
+TEST_CASE("Map registry matches the source tables for every map ID", "[map_registry]")
+{
+    size_t known = 0;
+    for (uint32_t id = 0; id <= UINT16_MAX; ++id)
+    {
+        const auto mapId = static_cast<uint16_t>(id);
+        const auto &info = mapInfo(mapId);
+        INFO("mapId 0x" << std::hex << id);
+
+        CHECK(info.mapType == okami::MapTypes::FromMapId(mapId));
+        CHECK(info.areaNameStrId == okami::getAreaNameID(mapId));
+        CHECK(info.fangShop() == scanFangShopMap(mapId));
+        for (uint32_t shopNum : {0u, 1u, 2u, 999u})
+            CHECK(info.shopId(shopNum) == scanShopMap(mapId, shopNum));
+        CHECK(info.containers == checks::kContainerManifest.map(mapId));
+
+        if (info.known())
+        {
+            CHECK(info.mapId == mapId);
+            ++known;
+        }
+    }
+    CHECK(known == checks::knownMapCount());
+}
+
+TEST_CASE("Map registry covers every map in the source tables", "[map_registry]")
+{
+    for (const auto &[mapId, type] : okami::MapTypes::mapidToIndex)
+        CHECK(mapInfo(static_cast<uint16_t>(mapId)).known());
+    for (const auto &[mapId, areaNameId] : okami::MapToAreaNameID)
+        CHECK(mapInfo(mapId).known());
+    for (const auto &entry : checks::kShopMap)
+        CHECK(mapInfo(entry.mapId).known());
+}
+
+TEST_CASE("Map registry unknown maps get the default entry", "[map_registry]")
+{
+    for (uint16_t mapId : {uint16_t{0x0000}, uint16_t{0x0140}, uint16_t{0x1000}, uint16_t{0xFFFF}})
+    {
+        const auto &info = mapInfo(mapId);
+        CHECK_FALSE(info.known());
+        CHECK(info.mapType == okami::MapTypes::None);
+        CHECK(info.areaNameStrId == okami::kDefaultAreaNameID);
+        CHECK_FALSE(info.shopId(0).has_value());
+        CHECK_FALSE(info.fangShop().has_value());
+        CHECK(info.containers == nullptr);
+    }
+}
@@ -4,12 +4,17 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "alloc_counter.h"
 #include "okami/blowfish.hpp"
+#include "okami/custommodelpkg.hpp"
+#include "okami/itemtype.hpp"
 #include "okami/resourcepkg.hpp"
 
 // ---------------------------------------------------------------------------
@@ -337,3 +342,474 @@ TEST_CASE("ResourcePackage: ROF 64-bit offsets match 32-bit header offsets", "[r
         REQUIRE(o64 == static_cast<uint64_t>(offsets32[i]));
     }
 }
+
+TEST_CASE("ResourcePackage: serializeInto matches the decrypted file", "[resourcepkg][write][decrypt]")
+{
+    const auto dir = testTempDir() / "serialize_into";
+    const auto path = dir / "test.dat";
+    std::filesystem::remove_all(dir);
+
+    okami::ResourcePackage pkg;
+    pkg.addBlank();
+    pkg.addEntry({'D', 'D', 'S', '\0'}, makeFakeDDS(200));
+    pkg.addEntry({'D', 'D', 'S', '\0'}, makeFakeDDS(77));
+
+    REQUIRE(pkg.write(path));
+    const auto decrypted = decryptFile(path);
+
+    REQUIRE(pkg.serializedSize() == decrypted.size());
+    REQUIRE(pkg.serializedSize() % 32 == 0);
+
+    std::vector<uint8_t> image(pkg.serializedSize());
+    REQUIRE(pkg.serializeInto(image) == image.size());
+    CHECK(image == decrypted);
+
+    CHECK(pkg.serializeInto(std::span<uint8_t>(image).first(image.size() - 1)) == 0);
+}
+
+TEST_CASE("ResourcePackage: addUniqueEntry folds identical payloads", "[resourcepkg][dedup]")
+{
+    const auto a = makeFakeDDS(200);
+    auto b = makeFakeDDS(200);
+    b[150] = 1;
+
+    okami::ResourcePackage pkg;
+    pkg.addBlank();
+    pkg.addEntry({'D', 'D', 'S', '\0'}, a);
+
+    CHECK(pkg.addUniqueEntry({'D', 'D', 'S', '\0'}, a) == 1); // matches a plain addEntry
+    CHECK(pkg.addUniqueEntry({'D', 'D', 'S', '\0'}, b) == 2);
+    CHECK(pkg.addUniqueEntry({'D', 'D', 'S', '\0'}, b) == 2);
+    CHECK(pkg.addUniqueEntry({'M', 'D', 'L', '\0'}, a) == 3); // same bytes, other type
+    CHECK(pkg.addUniqueEntry({}, {}) == 0);                    // the blank
+    CHECK(pkg.size() == 4);
+
+    okami::ResourcePackageWriter writer;
+    writer.addBlank();
+    writer.addEntry({'D', 'D', 'S', '\0'}, a);
+    CHECK(writer.addUniqueEntry({'D', 'D', 'S', '\0'}, a) == 1);
+    CHECK(writer.addUniqueEntry({'D', 'D', 'S', '\0'}, b) == 2);
+    CHECK(writer.addUniqueEntry({'M', 'D', 'L', '\0'}, a) == 3);
+    CHECK(writer.size() == 4);
+    CHECK(writer.serializedSize() == pkg.serializedSize());
+}
+
+// ---------------------------------------------------------------------------
+// BlowfishContext
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+std::vector<uint8_t> patternBytes(std::size_t n)
+{
+    std::vector<uint8_t> bytes(n);
+    for (std::size_t i = 0; i < n; ++i)
+        bytes[i] = static_cast<uint8_t>(i * 131 + (i >> 8));
+    return bytes;
+}
+
+/// One block at a time through encryptBlock, as the original loop did.
+std::vector<uint8_t> encryptByBlock(const Nippon::BlowfishContext &ctx, std::vector<uint8_t> bytes)
+{
+    for (std::size_t i = 0; i + 8 <= bytes.size(); i += 8)
+    {
+        uint32_t xl, xr;
+        std::memcpy(&xl, bytes.data() + i, 4);
+        std::memcpy(&xr, bytes.data() + i + 4, 4);
+        ctx.encryptBlock(xl, xr);
+        std::memcpy(bytes.data() + i, &xl, 4);
+        std::memcpy(bytes.data() + i + 4, &xr, 4);
+    }
+    return bytes;
+}
+
+} // anonymous namespace
+
+TEST_CASE("BlowfishContext: matches the reference test vector", "[blowfish]")
+{
+    // Schneier's first vector: all-zero key and plaintext
+    const Nippon::BlowfishContext ctx{std::string_view("\0\0\0\0\0\0\0\0", 8)};
+    uint32_t xl = 0, xr = 0;
+    ctx.encryptBlock(xl, xr);
+    CHECK(xl == 0x4EF99745u);
+    CHECK(xr == 0x6198DD78u);
+
+    ctx.decryptBlock(xl, xr);
+    CHECK(xl == 0u);
+    CHECK(xr == 0u);
+}
+
+TEST_CASE("BlowfishContext: interleaved lanes match block-at-a-time", "[blowfish]")
+{
+    const auto &ctx = Nippon::okamiCipher();
+
+    // Whole lane groups, a partial group, and a tail that isn't a whole block
+    for (std::size_t size : {8u, 24u, 32u, 1000u, 4099u})
+    {
+        const auto plain = patternBytes(size);
+        auto bytes = plain;
+        ctx.encrypt(bytes);
+        CHECK(bytes == encryptByBlock(ctx, plain));
+        CHECK(std::equal(bytes.end() - static_cast<std::ptrdiff_t>(size % 8), bytes.end(), plain.end() - static_cast<std::ptrdiff_t>(size % 8)));
+
+        ctx.decrypt(bytes);
+        CHECK(bytes == plain);
+    }
+}
+
+TEST_CASE("BlowfishContext: threaded slices match a single thread", "[blowfish]")
+{
+    const auto &ctx = Nippon::okamiCipher();
+    const auto plain = patternBytes(Nippon::BlowfishContext::kParallelBytes * 4 + 13);
+
+    auto serial = plain;
+    ctx.encrypt(serial, 1);
+
+    for (unsigned threads : {2u, 3u, 8u})
+    {
+        auto threaded = plain;
+        ctx.encrypt(threaded, threads);
+        CHECK(threaded == serial);
+
+        ctx.decrypt(threaded, threads);
+        CHECK(threaded == plain);
+    }
+}
+
+TEST_CASE("BlowfishContext: legacy BlowFish interface uses the created key", "[blowfish]")
+{
+    const auto plain = patternBytes(512);
+    auto legacy = plain;
+    Nippon::BlowFish::Create(std::string(Nippon::kCipherKey));
+    Nippon::BlowFish::Encrypt(legacy);
+
+    auto viaContext = plain;
+    Nippon::okamiCipher().encrypt(viaContext);
+    CHECK(legacy == viaContext);
+
+    Nippon::BlowFish::Create("another key");
+    auto other = plain;
+    Nippon::BlowFish::Encrypt(other);
+    CHECK(other == encryptByBlock(Nippon::BlowfishContext{"another key"}, plain));
+
+    Nippon::BlowFish::Create(std::string(Nippon::kCipherKey));
+}
+
+// ---------------------------------------------------------------------------
+// ResourcePackageReader
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+struct ReaderFixture
+{
+    std::filesystem::path path;
+    std::vector<std::vector<uint8_t>> payloads;
+
+    explicit ReaderFixture(const char *name) : path(testTempDir() / "reader" / name / "test.dat")
+    {
+        std::filesystem::remove_all(path.parent_path());
+
+        // Sizes that aren't block multiples, so neighbouring entries share blocks
+        okami::ResourcePackage pkg;
+        for (std::size_t size : {0u, 77u, 13u, 200u, 4096u, 3u, 5000u})
+        {
+            auto payload = patternBytes(size);
+            for (auto &byte : payload)
+                byte ^= static_cast<uint8_t>(payloads.size());
+            pkg.addEntry({'D', 'D', 'S', static_cast<char>('0' + payloads.size())}, payload);
+            payloads.push_back(std::move(payload));
+        }
+        REQUIRE(pkg.write(path));
+    }
+
+    bool matches(okami::ResourcePackageReader &reader, std::size_t i) const
+    {
+        const auto bytes = reader.entry(i);
+        return std::ranges::equal(bytes, payloads[i]);
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("ResourcePackageReader: reads back what ResourcePackage wrote", "[resourcepkg][reader]")
+{
+    ReaderFixture fx("roundtrip");
+    const auto onDisk = [&]
+    {
+        std::ifstream ifs{fx.path, std::ios::binary};
+        return std::vector<uint8_t>{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+    };
+    const auto encrypted = onDisk();
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(fx.path));
+    REQUIRE(reader.size() == fx.payloads.size());
+
+    for (std::size_t i = 0; i < reader.size(); ++i)
+    {
+        CHECK(reader.type(i) == okami::ResourceType{'D', 'D', 'S', static_cast<char>('0' + i)});
+        CHECK(fx.matches(reader, i));
+    }
+    CHECK(reader.entry(reader.size()).empty());
+    CHECK(reader.type(reader.size()) == okami::ResourceType{});
+
+    // Decrypting the private mapping leaves the file encrypted
+    reader.close();
+    CHECK(onDisk() == encrypted);
+}
+
+TEST_CASE("ResourcePackageReader: decrypts only the entries that are read", "[resourcepkg][reader]")
+{
+    ReaderFixture fx("lazy");
+    const auto fileSize = std::filesystem::file_size(fx.path);
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(fx.path));
+    const auto headerBytes = reader.decryptedBytes();
+    CHECK(headerBytes < 128);
+
+    // Reading the small entry touches at most its blocks plus the two it shares
+    CHECK(fx.matches(reader, 2));
+    CHECK(reader.decryptedBytes() <= headerBytes + 13 + 16);
+
+    // Out of order and repeated reads: blocks shared with entry 2 must not be decrypted twice
+    for (std::size_t i : {6u, 3u, 1u, 2u, 5u, 4u, 0u, 3u})
+        CHECK(fx.matches(reader, i));
+    CHECK(reader.decryptedBytes() <= fileSize);
+}
+
+TEST_CASE("ResourcePackageReader: rejects missing and malformed packages", "[resourcepkg][reader]")
+{
+    const auto dir = testTempDir() / "reader" / "malformed";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    okami::ResourcePackageReader reader;
+    CHECK_FALSE(reader.open(dir / "missing.dat"));
+    CHECK_FALSE(reader.isOpen());
+
+    auto writeRaw = [&](const std::vector<uint8_t> &plain)
+    {
+        auto bytes = plain;
+        Nippon::okamiCipher().encrypt(bytes);
+        std::ofstream ofs{dir / "bad.dat", std::ios::binary};
+        ofs.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    };
+
+    SECTION("Empty file")
+    {
+        writeRaw({});
+    }
+    SECTION("Header larger than the file")
+    {
+        writeRaw({0xFF, 0xFF, 0, 0, 0, 0, 0, 0});
+    }
+    SECTION("Entry offset past the end")
+    {
+        // 2 elements: offsets {24, 0x1000}, types {DDS, ROF}
+        std::vector<uint8_t> plain(32, 0);
+        plain[0] = 2;
+        plain[4] = 24;
+        plain[9] = 0x10;
+        writeRaw(plain);
+    }
+
+    CHECK_FALSE(reader.open(dir / "bad.dat"));
+    CHECK_FALSE(reader.isOpen());
+    CHECK(reader.size() == 0);
+}
+
+TEST_CASE("ResourcePackageReader: moving keeps the mapping and decryption state", "[resourcepkg][reader]")
+{
+    ReaderFixture fx("move");
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(fx.path));
+    const auto first = reader.entry(4);
+
+    okami::ResourcePackageReader moved{std::move(reader)};
+    CHECK_FALSE(reader.isOpen());
+    CHECK(moved.entry(4).data() == first.data());
+    CHECK(fx.matches(moved, 4));
+    CHECK(fx.matches(moved, 3));
+
+    okami::ResourcePackageReader assigned;
+    assigned = std::move(moved);
+    CHECK(fx.matches(assigned, 5));
+    CHECK(assigned.size() == fx.payloads.size());
+}
+
+// ---------------------------------------------------------------------------
+// ResourcePackageWriter
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+std::vector<uint8_t> readRaw(const std::filesystem::path &path)
+{
+    std::ifstream ifs{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+} // anonymous namespace
+
+TEST_CASE("ResourcePackageWriter: output is byte-identical to ResourcePackage::write", "[resourcepkg][writer]")
+{
+    const auto dir = testTempDir() / "writer_identical";
+    std::filesystem::remove_all(dir);
+
+    // Entries straddling chunk boundaries, one larger than a whole chunk
+    constexpr std::size_t kChunk = okami::ResourcePackageWriter::kChunkBytes;
+    const std::vector<std::vector<uint8_t>> payloads{
+        makeFakeDDS(77), patternBytes(kChunk - 5), patternBytes(13), patternBytes(kChunk * 2 + 3), makeFakeDDS(4096),
+    };
+
+    okami::ResourcePackage reference;
+    okami::ResourcePackageWriter writer;
+    reference.addBlank();
+    writer.addBlank();
+    for (std::size_t i = 0; i < payloads.size(); ++i)
+    {
+        const okami::ResourceType type{'D', 'D', 'S', static_cast<char>('0' + i)};
+        reference.addEntry(type, payloads[i]);
+        if (i % 2 == 0)
+            writer.addEntry(type, payloads[i]); // borrowed
+        else
+            writer.addEntry(type, std::vector<uint8_t>(payloads[i])); // moved in
+    }
+
+    REQUIRE(writer.size() == reference.size());
+    CHECK(writer.serializedSize() == reference.serializedSize());
+
+    REQUIRE(reference.write(dir / "reference.dat"));
+    REQUIRE(writer.write(dir / "streamed.dat"));
+    CHECK(readRaw(dir / "streamed.dat") == readRaw(dir / "reference.dat"));
+
+    SECTION("Empty package")
+    {
+        REQUIRE(okami::ResourcePackage{}.write(dir / "empty_reference.dat"));
+        REQUIRE(okami::ResourcePackageWriter{}.write(dir / "empty_streamed.dat"));
+        CHECK(readRaw(dir / "empty_streamed.dat") == readRaw(dir / "empty_reference.dat"));
+    }
+}
+
+TEST_CASE("ResourcePackageWriter: peak allocation stays at one chunk", "[resourcepkg][writer]")
+{
+    const auto path = testTempDir() / "writer_peak" / "big.dat";
+    std::filesystem::remove_all(path.parent_path());
+
+    const auto icon = patternBytes(256 * 1024);
+    okami::ResourcePackageWriter writer;
+    for (int i = 0; i < 32; ++i)
+        writer.addEntry({'D', 'D', 'S', '\0'}, icon);
+    REQUIRE(writer.serializedSize() > 8 * okami::ResourcePackageWriter::kChunkBytes);
+
+    mock::AllocationCounter allocs;
+    REQUIRE(writer.write(path));
+    CHECK(allocs.largest() <= okami::ResourcePackageWriter::kChunkBytes);
+
+    okami::ResourcePackageReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.size() == 32);
+    CHECK(std::ranges::equal(reader.entry(31), icon));
+}
+
+TEST_CASE("ResourcePackageWriter: write returns false for unwritable path", "[resourcepkg][writer]")
+{
+    const auto blocker = testTempDir() / "writer_blocker";
+    std::filesystem::remove_all(blocker);
+    std::filesystem::create_directories(blocker.parent_path());
+    std::ofstream{blocker} << "file, not a directory";
+
+    okami::ResourcePackageWriter writer;
+    writer.addBlank();
+    CHECK_FALSE(writer.write(blocker / "sub" / "test.dat"));
+}
+
+// ---------------------------------------------------------------------------
+// Custom model packages
+// ---------------------------------------------------------------------------
+
+TEST_CASE("custommodelpkg: model packages are built for every AP dummy", "[resourcepkg][custommodelpkg]")
+{
+    okami::custommodelpkg::initialize();
+
+    for (const uint8_t itemId : okami::ItemTypes::kApDummyItems)
+    {
+        const uint32_t entityType = 0x0A00u | itemId;
+        REQUIRE(okami::custommodelpkg::isApDummyEntity(entityType));
+
+        const auto *image = static_cast<const uint8_t *>(okami::custommodelpkg::getPackageForEntity(entityType));
+        REQUIRE(image != nullptr);
+
+        // One MD entry whose data starts 16-byte aligned
+        uint32_t count = 0, offset = 0;
+        std::memcpy(&count, image, sizeof(count));
+        std::memcpy(&offset, image + 4, sizeof(offset));
+        CHECK(count == 1);
+        CHECK(std::memcmp(image + 8, "MD\0\0", 4) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(image + offset) % 16 == 0);
+    }
+    CHECK(okami::custommodelpkg::getPackageForEntity(0x0A00u) == nullptr);
+}
+
+TEST_CASE("BoxModelTemplate: variants differ only in colour weights and texture index", "[resourcepkg][custommodelpkg]")
+{
+    const okami::custommodelpkg::BoxModelTemplate model;
+    const std::vector<okami::custommodelpkg::ModelVariant> variants{{80, 120, 255}, {255, 80, 80, 128, 3}};
+    const auto images = model.build(variants);
+    REQUIRE(images.size() == 2);
+    REQUIRE(images[0].size() == model.size());
+    REQUIRE(images[1].size() == model.size());
+
+    // Walk the package the way the game does: MD entry -> MdbHeader -> submeshes
+    auto readU32 = [](const std::vector<uint8_t> &image, size_t at)
+    {
+        uint32_t value = 0;
+        std::memcpy(&value, image.data() + at, sizeof(value));
+        return value;
+    };
+    const auto &image = images[1];
+    const size_t md = readU32(image, 4);
+    const size_t mdb = md + 32; // ScrHeader + transform offset, aligned
+    REQUIRE(readU32(image, mdb) == 0x0062646D);
+    constexpr size_t kFaceCount = 6;
+
+    std::vector<bool> patched(image.size(), false);
+    for (size_t face = 0; face < kFaceCount; ++face)
+    {
+        const size_t subMesh = mdb + readU32(image, mdb + 32 + face * 4);
+        const size_t colors = subMesh + readU32(image, subMesh + 12);
+        const size_t textureIndex = subMesh + 22;
+
+        uint16_t texture = 0;
+        std::memcpy(&texture, image.data() + textureIndex, sizeof(texture));
+        CHECK(texture == 3);
+        std::fill_n(patched.begin() + static_cast<std::ptrdiff_t>(textureIndex), 2, true);
+
+        for (size_t v = 0; v < 4; ++v)
+        {
+            const uint8_t *color = image.data() + colors + v * 4;
+            CHECK(color[0] == 255);
+            CHECK(color[1] == 80);
+            CHECK(color[2] == 80);
+            CHECK(color[3] == 128);
+            CHECK(images[0][colors + v * 4 + 2] == 255); // first variant's blue
+            std::fill_n(patched.begin() + static_cast<std::ptrdiff_t>(colors + v * 4), 4, true);
+        }
+    }
+
+    // Everything else is the shared geometry
+    for (size_t i = 0; i < image.size(); ++i)
+    {
+        if (!patched[i] && images[0][i] != image[i])
+            FAIL("variants differ outside the patched blocks at byte " << i);
+    }
+
+    std::vector<uint8_t> small(model.size() - 1);
+    CHECK_FALSE(model.buildInto(small, variants[0]));
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "gamestate_accessors.hpp"
+#include "lifecycle.h"
 #include "rewardman.h"
 #include "rewards/brushes.hpp"
 #include "rewards/game_items.hpp"
@@ -282,6 +283,7 @@ TEST_CASE_METHOD(RewardManFixture, "CheckSendingCallback is invoked during grant
 TEST_CASE("Lifecycle callbacks", "[rewardman]")
 {
     wolf::mock::reset();
+    lifecycle::bindWolfCallbacks();
 
     RewardMan rewardMan([](bool) {});
 
@@ -1,18 +1,27 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <okami/maps.hpp>
+#include <okami/contenthash.hpp>
 #include <okami/offsets.hpp>
 #include <okami/savefile.hpp>
 
 #include "mock_archipelagosocket.h"
 #include "saveman.h"
+#include "savechecksum.h"
+#include "savehistory.h"
+#include "savestore.h"
+#include "savewriter.h"
 #include "wolf_framework.hpp"
 
 // Highest memory offset used by SaveMan: systemFlags at 0xB6B2B0 + sizeof(uint32_t).
@@ -43,6 +52,7 @@ static void cleanupSaveFile(SaveMan &sm)
     {
         std::filesystem::remove(path);
         std::filesystem::remove(path + ".tmp");
+        std::filesystem::remove_all(SaveHistory::directoryFor(path));
     }
 }
 
@@ -342,11 +352,13 @@ TEST_CASE("Auto-save: triggers after debounce period", "[saveman][autosave]")
 
     // Immediately: should NOT fire (within debounce window)
     sm->processAutoSave();
+    sm->waitForSaves();
     CHECK_FALSE(sm->hasSaveFile());
 
     // After debounce period: should fire
     std::this_thread::sleep_for(std::chrono::milliseconds(600));
     sm->processAutoSave();
+    REQUIRE(sm->waitForSaves()); // written on the writer thread
     CHECK(sm->hasSaveFile());
 
     cleanupSaveFile(*sm);
@@ -371,11 +383,13 @@ TEST_CASE("Auto-save: rapid queues coalesce to single save", "[saveman][autosave
         sm->queueAutoSave();
         sm->processAutoSave(); // Each call within debounce window — no save
     }
+    sm->waitForSaves();
     CHECK_FALSE(sm->hasSaveFile());
 
     // Wait for debounce then process
     std::this_thread::sleep_for(std::chrono::milliseconds(600));
     sm->processAutoSave();
+    REQUIRE(sm->waitForSaves()); // written on the writer thread
     CHECK(sm->hasSaveFile());
 
     cleanupSaveFile(*sm);
@@ -633,6 +647,75 @@ TEST_CASE("Golden save: checksum matches game-computed value", "[saveman][golden
     CHECK(computed == file->slots[0].checksum);
 }
 
+TEST_CASE("Golden save: every fold kernel matches the qword checksum", "[saveman][golden][checksum]")
+{
+    auto file = readFixtureSaveFile();
+    const okami::SaveSlot &slot = file->slots[0];
+
+    // The checksum as the game computes it: one qword at a time
+    const auto *qwords = reinterpret_cast<const uint64_t *>(&slot);
+    uint64_t reference = 0x9be6fa3b72afda1d ^ qwords[0];
+    for (size_t i = 2; i < sizeof(okami::SaveSlot) / sizeof(uint64_t); ++i)
+        reference ^= qwords[i];
+    REQUIRE(reference == slot.checksum);
+
+    for (auto kernel : {savechecksum::Kernel::Portable, savechecksum::Kernel::SSE2, savechecksum::Kernel::AVX2})
+    {
+        if (!savechecksum::supported(kernel))
+            continue;
+        CAPTURE(static_cast<int>(kernel));
+
+        CHECK((0x9be6fa3b72afda1d ^ qwords[0] ^ savechecksum::fold(kernel, qwords + 2, sizeof(slot) - 16)) == reference);
+
+        // Regions copied in pieces that start and end mid-qword, from a
+        // source at a different alignment, still fold to the whole slot
+        auto copy = std::make_unique<okami::SaveSlot>();
+        std::vector<uint8_t> source(sizeof(slot) + 3);
+        std::memcpy(source.data() + 3, &slot, sizeof(slot));
+        const auto *src = source.data() + 3;
+        auto *dst = reinterpret_cast<uint8_t *>(copy.get());
+
+        uint64_t folded = 0;
+        for (size_t offset = 0x10, piece = 1; offset < sizeof(slot); piece = piece * 3 + 1)
+        {
+            const size_t size = std::min(piece, sizeof(slot) - offset);
+            folded ^= savechecksum::copyFold(kernel, dst + offset, src + offset, size);
+            offset += size;
+        }
+        CHECK((0x9be6fa3b72afda1d ^ qwords[0] ^ folded) == reference);
+        std::memcpy(copy.get(), &slot, 0x10);
+        CHECK(std::memcmp(copy.get(), &slot, sizeof(slot)) == 0);
+    }
+}
+
+TEST_CASE("Golden save: the snapshot checksum matches computeChecksum", "[saveman][golden][checksum]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(kMockMemorySize);
+
+    mock::MockArchipelagoSocket socket;
+    auto sm = makeSaveMan(socket);
+    sm->setApModeActive(true);
+    cleanupSaveFile(*sm);
+
+    // Load the fixture into game memory, then snapshot it back out
+    auto file = readFixtureSaveFile();
+    SaveStore store(sm->getSavePath());
+    std::filesystem::create_directories(std::filesystem::path(store.path()).parent_path());
+    REQUIRE(store.writeSlot(file->slots[0]));
+    REQUIRE(sm->loadGameState());
+    REQUIRE(sm->saveGameState());
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    REQUIRE(store.readSlot(*slot));
+    CHECK(slot->checksum == SaveMan::computeChecksum(*slot));
+    CHECK(std::memcmp(&slot->tracked, &file->slots[0].tracked, sizeof(okami::TrackerData)) == 0);
+    CHECK(std::memcmp(&slot->customTextures, &file->slots[0].customTextures, sizeof(okami::CustomTextures)) == 0);
+
+    cleanupSaveFile(*sm);
+    wolf::mock::reset();
+}
+
 TEST_CASE("Golden save: slot 0 header is valid", "[saveman][golden]")
 {
     auto file = readFixtureSaveFile();
@@ -888,11 +971,13 @@ TEST_CASE("Auto-save: deferred while unsafe, fires once flags clear", "[saveman]
 
     // First tick after debounce: unsafe, save deferred, pending flag preserved.
     sm->processAutoSave();
+    sm->waitForSaves();
     CHECK_FALSE(sm->hasSaveFile());
 
     // Clear the unsafe flag. Next tick should fire.
     *flags.sysFlags &= ~(1u << 22);
     sm->processAutoSave();
+    REQUIRE(sm->waitForSaves()); // written on the writer thread
     CHECK(sm->hasSaveFile());
 
     cleanupSaveFile(*sm);
@@ -927,6 +1012,7 @@ TEST_CASE("Auto-save: direct saveGameState clears pending state", "[saveman][aut
     REQUIRE(sm->deleteSave());
     std::this_thread::sleep_for(std::chrono::milliseconds(600));
     sm->processAutoSave();
+    sm->waitForSaves();
     CHECK_FALSE(sm->hasSaveFile());
 
     wolf::mock::reset();
@@ -968,3 +1054,628 @@ TEST_CASE("Cold-start save produces game-compatible empty slots", "[saveman][gol
     cleanupSaveFile(*sm);
     wolf::mock::reset();
 }
+
+// =============================================================================
+// SaveStore (in-place slot writes + journal)
+// =============================================================================
+
+namespace
+{
+
+std::string storeTestPath(const char *name)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "okami_test" / "savestore";
+    std::filesystem::create_directories(dir);
+    const auto path = (dir / name).string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(SaveStore::journalPath(path));
+    std::filesystem::remove(SaveStore::deltaPath(path));
+    return path;
+}
+
+/// Slot 0 as it sits in the file, without the delta log.
+std::unique_ptr<okami::SaveSlot> readRawSlot(const std::string &path)
+{
+    auto slot = std::make_unique<okami::SaveSlot>();
+    std::ifstream(path, std::ios::binary).read(reinterpret_cast<char *>(slot.get()), sizeof(*slot));
+    return slot;
+}
+
+std::unique_ptr<okami::SaveSlot> makeSlot(uint32_t health)
+{
+    auto slot = std::make_unique<okami::SaveSlot>();
+    std::memset(slot.get(), 0, sizeof(*slot));
+    slot->header = 0x40400000;
+    slot->character.currentHealth = health;
+    slot->checksum = SaveMan::computeChecksum(*slot);
+    return slot;
+}
+
+/// Write a journal the way SaveStore does, as if a crash followed it.
+void writeJournal(const std::string &path, const okami::SaveSlot &slot, size_t truncateTo = SIZE_MAX)
+{
+    struct
+    {
+        uint32_t magic = 0x4A534B4F;
+        uint32_t version = 1;
+        uint64_t slotHash;
+    } header{.slotHash = okami::contentHash({reinterpret_cast<const uint8_t *>(&slot), sizeof(slot)})};
+
+    std::vector<uint8_t> bytes(sizeof(header) + sizeof(slot));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), &slot, sizeof(slot));
+    bytes.resize(std::min(bytes.size(), truncateTo));
+
+    std::ofstream f(SaveStore::journalPath(path), std::ios::binary);
+    f.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+TEST_CASE("SaveStore: only the first write rewrites the whole file", "[saveman][savestore]")
+{
+    const auto path = storeTestPath("inplace.oksav");
+    std::filesystem::copy_file(std::string(TEST_FIXTURES_DIR) + "/vanilla_save.bin", path);
+    auto fixture = readFixtureSaveFile();
+
+    SaveStore store(path);
+    REQUIRE(store.writeSlot(*makeSlot(100)));
+    REQUIRE(store.writeSlot(*makeSlot(200)));
+    CHECK(store.stats().writes == 2);
+    CHECK(store.stats().fullRewrites == 0);
+    CHECK(store.stats().bytesWritten == 2 * (2 * sizeof(okami::SaveSlot) + 16)); // journal + slot per save
+    CHECK_FALSE(std::filesystem::exists(SaveStore::journalPath(path)));
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    REQUIRE(store.readSlot(*slot));
+    CHECK(slot->character.currentHealth == 200);
+
+    auto written = std::make_unique<okami::SaveFile>();
+    {
+        std::ifstream f(path, std::ios::binary);
+        f.read(reinterpret_cast<char *>(written.get()), sizeof(*written));
+        REQUIRE(f.good());
+    }
+    CHECK(std::memcmp(&written->slots[1], &fixture->slots[1], 29 * sizeof(okami::SaveSlot)) == 0);
+
+    // A missing file is created once, in the game's empty-slot format
+    const auto fresh = storeTestPath("fresh.oksav");
+    SaveStore created(fresh);
+    REQUIRE(created.writeSlot(*makeSlot(1)));
+    REQUIRE(created.writeSlot(*makeSlot(2)));
+    CHECK(created.stats().fullRewrites == 1);
+    CHECK(std::filesystem::file_size(fresh) == sizeof(okami::SaveFile));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(fresh);
+}
+
+TEST_CASE("SaveStore: a complete journal is replayed, a torn one dropped", "[saveman][savestore]")
+{
+    const auto path = storeTestPath("journal.oksav");
+    SaveStore store(path);
+    REQUIRE(store.writeSlot(*makeSlot(100)));
+    auto slot = std::make_unique<okami::SaveSlot>();
+
+    SECTION("Crash after the journal was synced")
+    {
+        writeJournal(path, *makeSlot(300));
+        REQUIRE(store.readSlot(*slot));
+        CHECK(slot->character.currentHealth == 300);
+        CHECK(SaveMan::computeChecksum(*slot) == slot->checksum);
+    }
+
+    SECTION("Crash while the journal was being written")
+    {
+        writeJournal(path, *makeSlot(300), sizeof(okami::SaveSlot) / 2);
+        REQUIRE(store.readSlot(*slot));
+        CHECK(slot->character.currentHealth == 100);
+    }
+
+    SECTION("Journal whose bytes don't match its hash")
+    {
+        auto corrupt = makeSlot(300);
+        writeJournal(path, *corrupt);
+        std::fstream f(SaveStore::journalPath(path), std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(100);
+        f.put('\x7F');
+        f.close();
+        REQUIRE(store.readSlot(*slot));
+        CHECK(slot->character.currentHealth == 100);
+    }
+
+    SECTION("Journal without a save file recreates it")
+    {
+        std::filesystem::remove(path);
+        writeJournal(path, *makeSlot(400));
+        CHECK(store.recover());
+        REQUIRE(store.readSlot(*slot));
+        CHECK(slot->character.currentHealth == 400);
+        CHECK(std::filesystem::file_size(path) == sizeof(okami::SaveFile));
+    }
+
+    CHECK_FALSE(std::filesystem::exists(SaveStore::journalPath(path)));
+    CHECK(store.remove());
+}
+
+TEST_CASE("SaveStore: a delta log holds only the changed qwords", "[saveman][savestore][delta]")
+{
+    const auto path = storeTestPath("delta.oksav");
+    SaveStore store(path);
+    auto base = makeSlot(100);
+    REQUIRE(store.writeSlot(*base));
+
+    // A sent check: a few collection bytes, the timestamp and the checksum change
+    auto next = makeSlot(100);
+    next->collection.strayBeadsCollected.Set(7);
+    next->timeRTC = 2;
+    next->checksum = SaveMan::computeChecksum(*next);
+
+    const auto before = store.stats().bytesWritten;
+    REQUIRE(store.appendDelta(*base, *next));
+    CHECK(store.stats().deltaAppends == 1);
+    CHECK(store.stats().bytesWritten - before < 128); // log header, record header, two runs
+    CHECK(store.deltaSize() == store.stats().bytesWritten - before);
+
+    // Nothing changed, nothing written
+    REQUIRE(store.appendDelta(*next, *next));
+    CHECK(store.stats().deltaAppends == 1);
+
+    auto third = makeSlot(90);
+    std::memcpy(&third->collection, &next->collection, sizeof(okami::CollectionData));
+    third->timeRTC = 3;
+    third->checksum = SaveMan::computeChecksum(*third);
+    REQUIRE(store.appendDelta(*next, *third));
+
+    // The file is untouched until the log is compacted; reads see the log
+    auto read = std::make_unique<okami::SaveSlot>();
+    CHECK(std::memcmp(readRawSlot(path).get(), base.get(), sizeof(*base)) == 0);
+    REQUIRE(store.readSlot(*read));
+    CHECK(std::memcmp(read.get(), third.get(), sizeof(*third)) == 0);
+
+    REQUIRE(store.compact());
+    CHECK_FALSE(std::filesystem::exists(SaveStore::deltaPath(path)));
+    CHECK(std::memcmp(readRawSlot(path).get(), third.get(), sizeof(*third)) == 0);
+    CHECK(store.remove());
+}
+
+TEST_CASE("SaveStore: torn and stale delta logs are not replayed", "[saveman][savestore][delta]")
+{
+    const auto path = storeTestPath("delta_torn.oksav");
+    SaveStore store(path);
+    auto base = makeSlot(100);
+    auto first = makeSlot(80);
+    auto second = makeSlot(60);
+    REQUIRE(store.writeSlot(*base));
+
+    SECTION("A log is only started on the slot 0 in the file")
+    {
+        CHECK_FALSE(store.appendDelta(*first, *second));
+        CHECK(store.deltaSize() == 0);
+    }
+
+    SECTION("A record torn by a crash ends the replay")
+    {
+        REQUIRE(store.appendDelta(*base, *first));
+        REQUIRE(store.appendDelta(*first, *second));
+        std::filesystem::resize_file(SaveStore::deltaPath(path), store.deltaSize() - 3);
+
+        auto read = std::make_unique<okami::SaveSlot>();
+        REQUIRE(store.readSlot(*read));
+        CHECK(read->character.currentHealth == 80);
+
+        REQUIRE(store.compact());
+        CHECK(readRawSlot(path)->character.currentHealth == 80);
+    }
+
+    SECTION("A full write supersedes the log")
+    {
+        REQUIRE(store.appendDelta(*base, *first));
+        REQUIRE(store.writeSlot(*second));
+        CHECK_FALSE(std::filesystem::exists(SaveStore::deltaPath(path)));
+    }
+
+    SECTION("The game's own save supersedes the log")
+    {
+        REQUIRE(store.appendDelta(*base, *first));
+        auto gameFile = std::make_unique<okami::SaveFile>();
+        std::memset(gameFile.get(), 0, sizeof(okami::SaveFile));
+        gameFile->slots[0] = *second;
+        REQUIRE(store.replaceFile(gameFile.get(), sizeof(okami::SaveFile)));
+        CHECK_FALSE(std::filesystem::exists(SaveStore::deltaPath(path)));
+
+        // The next append starts a new log on the game's slot 0, not the old one
+        CHECK_FALSE(store.appendDelta(*first, *base));
+        REQUIRE(store.appendDelta(*second, *base));
+        auto read = std::make_unique<okami::SaveSlot>();
+        REQUIRE(store.readSlot(*read));
+        CHECK(read->character.currentHealth == 100);
+    }
+
+    SECTION("A log left over from an older slot 0 is ignored")
+    {
+        REQUIRE(store.appendDelta(*base, *first));
+        const auto log = SaveStore::deltaPath(path);
+        std::filesystem::copy_file(log, log + ".old");
+
+        // slot 0 rewritten, but a crash kept the old log around
+        REQUIRE(store.writeSlot(*second));
+        std::filesystem::rename(log + ".old", log);
+
+        auto read = std::make_unique<okami::SaveSlot>();
+        REQUIRE(store.readSlot(*read));
+        CHECK(read->character.currentHealth == 60);
+    }
+
+    CHECK(store.remove());
+}
+
+// =============================================================================
+// SaveWriter (background save thread)
+// =============================================================================
+
+TEST_CASE("SaveWriter: writes on its own thread", "[saveman][savewriter]")
+{
+    const auto path = storeTestPath("writer.oksav");
+
+    SaveWriter writer;
+    const auto id = writer.submit(path,
+                                  [](okami::SaveSlot &slot)
+                                  {
+                                      slot.header = 0x40400000;
+                                      slot.character.currentHealth = 123;
+                                      slot.checksum = SaveMan::computeChecksum(slot);
+                                  });
+    writer.waitIdle();
+
+    const auto results = writer.takeResults();
+    REQUIRE(results.size() == 1);
+    CHECK(results[0].id == id);
+    CHECK(results[0].path == path);
+    CHECK(results[0].ok);
+    CHECK(writer.takeResults().empty());
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    SaveStore store(path);
+    REQUIRE(store.readSlot(*slot));
+    CHECK(slot->character.currentHealth == 123);
+    CHECK(slot->checksum == SaveMan::computeChecksum(*slot));
+    CHECK(store.remove());
+}
+
+TEST_CASE("SaveWriter: every submitted save is written or superseded, in order", "[saveman][savewriter]")
+{
+    const auto path = storeTestPath("writer_order.oksav");
+
+    {
+        SaveWriter writer;
+        for (uint32_t health = 1; health <= 50; ++health)
+            writer.submit(path, [health](okami::SaveSlot &slot) { slot.character.currentHealth = health; });
+        writer.waitIdle();
+
+        // Queued saves may be replaced by newer ones, but the last one always lands
+        const auto results = writer.takeResults();
+        REQUIRE_FALSE(results.empty());
+        CHECK(results.back().id == 50);
+        for (size_t i = 1; i < results.size(); ++i)
+            CHECK(results[i - 1].id < results[i].id);
+    }
+
+    auto slot = std::make_unique<okami::SaveSlot>();
+    SaveStore store(path);
+    REQUIRE(store.readSlot(*slot));
+    CHECK(slot->character.currentHealth == 50);
+    CHECK(store.remove());
+}
+
+TEST_CASE("SaveWriter: saves from two threads never share a buffer", "[saveman][savewriter]")
+{
+    const auto path = storeTestPath("writer_threads.oksav");
+
+    // Health = 1000 * thread + n, so every save is distinct; ids[t][n] is its save's id
+    std::vector<uint64_t> ids[2];
+    {
+        SaveWriter writer;
+        auto submitter = [&](uint32_t thread)
+        {
+            for (uint32_t n = 0; n < 20; ++n)
+            {
+                const uint32_t health = 1000 * thread + n;
+                ids[thread].push_back(writer.submit(path,
+                                                    [health](okami::SaveSlot &slot)
+                                                    {
+                                                        slot.character.currentHealth = health;
+                                                        std::this_thread::sleep_for(std::chrono::microseconds(200));
+                                                        slot.character.maxHealth = health;
+                                                    }));
+            }
+        };
+        std::thread other(submitter, 1);
+        submitter(0);
+        other.join();
+        writer.waitIdle();
+
+        const auto results = writer.takeResults();
+        REQUIRE_FALSE(results.empty());
+        for (size_t i = 1; i < results.size(); ++i)
+            CHECK(results[i - 1].id < results[i].id);
+    }
+
+    // The newest save lands, filled by one thread only
+    const uint64_t newest = std::max(ids[0].back(), ids[1].back());
+    const uint32_t expected = newest == ids[0].back() ? 19 : 1019;
+    auto slot = std::make_unique<okami::SaveSlot>();
+    SaveStore store(path);
+    REQUIRE(store.readSlot(*slot));
+    CHECK(slot->character.currentHealth == expected);
+    CHECK(slot->character.maxHealth == expected);
+    CHECK(store.remove());
+}
+
+TEST_CASE("SaveWriter: saves after the first go to the delta log until shutdown", "[saveman][savewriter][delta]")
+{
+    const auto path = storeTestPath("writer_delta.oksav");
+    auto fill = [](uint32_t health) { return [health](okami::SaveSlot &slot) { slot = *makeSlot(health); }; };
+
+    {
+        SaveWriter writer;
+        writer.submit(path, fill(1));
+        writer.waitIdle();
+        CHECK_FALSE(std::filesystem::exists(SaveStore::deltaPath(path)));
+
+        writer.submit(path, fill(2));
+        writer.waitIdle();
+        writer.submit(path, fill(3));
+        writer.waitIdle();
+        for (const auto &result : writer.takeResults())
+            CHECK(result.ok);
+
+        SaveStore store(path);
+        CHECK(store.deltaSize() > 0);
+        CHECK(store.deltaSize() < 256);
+        CHECK(readRawSlot(path)->character.currentHealth == 1);
+
+        auto slot = std::make_unique<okami::SaveSlot>();
+        REQUIRE(store.readSlot(*slot));
+        CHECK(slot->character.currentHealth == 3);
+
+        // A removed file is rewritten in full, not appended to
+        writer.waitIdle();
+        REQUIRE(store.remove());
+        writer.submit(path, fill(4));
+        writer.waitIdle();
+        CHECK(readRawSlot(path)->character.currentHealth == 4);
+        CHECK(writer.takeResults().back().ok);
+
+        writer.submit(path, fill(5));
+    }
+
+    // Shutting down writes the last save and folds the log into the file
+    CHECK_FALSE(std::filesystem::exists(SaveStore::deltaPath(path)));
+    CHECK(readRawSlot(path)->character.currentHealth == 5);
+    CHECK(SaveStore(path).remove());
+}
+
+TEST_CASE("SaveWriter: failures come back as results", "[saveman][savewriter]")
+{
+    // A regular file where the save directory should be
+    const auto blocker = storeTestPath("writer_blocker");
+    std::ofstream{blocker} << "not a directory";
+
+    SaveWriter writer;
+    writer.submit(blocker + "/sub/save.oksav", [](okami::SaveSlot &) {});
+    writer.waitIdle();
+
+    const auto results = writer.takeResults();
+    REQUIRE(results.size() == 1);
+    CHECK_FALSE(results[0].ok);
+    std::filesystem::remove(blocker);
+}
+
+TEST_CASE("Auto-save: the tick only queues the save", "[saveman][autosave][savewriter]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(kMockMemorySize);
+
+    mock::MockArchipelagoSocket socket;
+    auto sm = makeSaveMan(socket);
+    sm->setApModeActive(true);
+    GameFlagWriter(wolf::getModuleBase("main.dll")).setSafe();
+    cleanupSaveFile(*sm);
+
+    uintptr_t base = wolf::getModuleBase("main.dll");
+    auto *charStats = reinterpret_cast<okami::CharacterStats *>(base + okami::main::characterStats);
+    charStats->currentHealth = 321;
+
+    sm->queueAutoSave();
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    sm->processAutoSave();
+
+    // Changes after the tick are not part of the queued snapshot
+    charStats->currentHealth = 1;
+    REQUIRE(sm->waitForSaves());
+    REQUIRE(sm->loadGameState());
+    CHECK(charStats->currentHealth == 321);
+
+    cleanupSaveFile(*sm);
+    wolf::mock::reset();
+}
+
+// =============================================================================
+// SaveHistory (rollback ring)
+// =============================================================================
+
+namespace
+{
+
+std::string historyTestPath(const char *name)
+{
+    const auto path = storeTestPath(name);
+    std::filesystem::remove_all(SaveHistory::directoryFor(path));
+    return path;
+}
+
+size_t countFiles(const std::string &dir, const char *extension)
+{
+    return static_cast<size_t>(std::ranges::count_if(std::filesystem::directory_iterator(dir),
+                                                     [extension](const auto &file) { return file.path().extension() == extension; }));
+}
+
+} // namespace
+
+TEST_CASE("SaveHistory: snapshots share unchanged chunks and the ring keeps the newest", "[saveman][savehistory]")
+{
+    const auto path = historyTestPath("history_ring.oksav");
+    auto fixture = readFixtureSaveFile();
+    auto slot = std::make_unique<okami::SaveSlot>(fixture->slots[0]);
+
+    SaveHistory history;
+    for (uint32_t i = 1; i <= 120; ++i)
+    {
+        // A check's worth of change per save: health, a collected bead and the time
+        slot->character.currentHealth = static_cast<uint16_t>(i);
+        slot->collection.strayBeadsCollected.Set(i % 100);
+        slot->timeRTC += 10'000'000;
+        REQUIRE(history.add(path, *slot));
+    }
+
+    const auto entries = history.list(path);
+    REQUIRE(entries.size() == SaveHistory::kDefaultCapacity);
+    CHECK(entries.front().sequence == 120);
+    CHECK(entries.back().sequence == 21);
+    CHECK(entries.front().timeRTC == slot->timeRTC);
+    CHECK(entries.front().mapId == slot->collection.currentMapId);
+
+    // Only the first snapshot stores the whole slot; later ones add a couple of chunks
+    const auto stats = history.stats();
+    CHECK(stats.snapshots == SaveHistory::kDefaultCapacity);
+    CHECK(stats.chunksWritten <= 28 + 2 * 119);
+    CHECK(stats.storedBytes < 2 * 1024 * 1024);
+    CHECK(countFiles(SaveHistory::directoryFor(path), ".chunk") == stats.chunks);
+    CHECK(countFiles(SaveHistory::directoryFor(path), ".snap") == SaveHistory::kDefaultCapacity);
+
+    auto loaded = std::make_unique<okami::SaveSlot>();
+    REQUIRE(history.load(path, 120, *loaded));
+    CHECK(std::memcmp(loaded.get(), slot.get(), sizeof(*slot)) == 0);
+    REQUIRE(history.load(path, 21, *loaded));
+    CHECK(loaded->character.currentHealth == 21);
+    CHECK_FALSE(history.load(path, 20, *loaded));
+
+    std::filesystem::remove_all(SaveHistory::directoryFor(path));
+}
+
+TEST_CASE("SaveHistory: a reopened history drops what a crash left behind", "[saveman][savehistory]")
+{
+    const auto path = historyTestPath("history_reopen.oksav");
+    const auto dir = SaveHistory::directoryFor(path);
+
+    {
+        SaveHistory history;
+        for (uint32_t health = 1; health <= 3; ++health)
+            REQUIRE(history.add(path, *makeSlot(health)));
+    }
+
+    // A chunk written without its manifest, a torn manifest and a stray .tmp
+    std::ofstream(dir + "/00000000deadbeef.chunk", std::ios::binary) << "orphan";
+    std::ofstream(dir + "/0000000000000004.snap", std::ios::binary) << "torn";
+    std::ofstream(dir + "/0000000000000005.snap.tmp", std::ios::binary) << "torn";
+
+    SaveHistory history;
+    const auto entries = history.list(path);
+    REQUIRE(entries.size() == 3);
+    CHECK(entries.front().sequence == 3);
+    CHECK_FALSE(std::filesystem::exists(dir + "/00000000deadbeef.chunk"));
+    CHECK_FALSE(std::filesystem::exists(dir + "/0000000000000004.snap"));
+    CHECK_FALSE(std::filesystem::exists(dir + "/0000000000000005.snap.tmp"));
+
+    auto loaded = std::make_unique<okami::SaveSlot>();
+    REQUIRE(history.load(path, 2, *loaded));
+    CHECK(std::memcmp(loaded.get(), makeSlot(2).get(), sizeof(*loaded)) == 0);
+
+    // Numbering carries on where it stopped
+    REQUIRE(history.add(path, *makeSlot(4)));
+    CHECK(history.list(path).front().sequence == 4);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SaveHistory: a damaged chunk fails the load", "[saveman][savehistory]")
+{
+    const auto path = historyTestPath("history_damaged.oksav");
+    const auto dir = SaveHistory::directoryFor(path);
+
+    SaveHistory history;
+    REQUIRE(history.add(path, *makeSlot(1)));
+    auto loaded = std::make_unique<okami::SaveSlot>();
+    REQUIRE(history.load(path, 1, *loaded));
+
+    // Flip the last byte of every chunk: the end of each zlib stream
+    for (const auto &file : std::filesystem::directory_iterator(dir))
+    {
+        if (file.path().extension() != ".chunk")
+            continue;
+        std::fstream f(file.path(), std::ios::binary | std::ios::in | std::ios::out);
+        f.seekg(-1, std::ios::end);
+        const auto last = static_cast<char>(f.get());
+        f.seekp(-1, std::ios::end);
+        f.put(static_cast<char>(last ^ 0x5A));
+    }
+    CHECK_FALSE(history.load(path, 1, *loaded));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("SaveMan: ap_history restores a snapshot into the running game", "[saveman][savehistory]")
+{
+    wolf::mock::reset();
+    wolf::mock::reserveMemory(kMockMemorySize);
+
+    mock::MockArchipelagoSocket socket;
+    auto sm = makeSaveMan(socket);
+    sm->setApModeActive(true);
+    cleanupSaveFile(*sm);
+
+    uintptr_t base = wolf::getModuleBase("main.dll");
+    GameFlagWriter flags(base);
+    flags.setSafe();
+    auto *charStats = reinterpret_cast<okami::CharacterStats *>(base + okami::main::characterStats);
+
+    for (uint16_t health : {100, 200, 300})
+    {
+        charStats->currentHealth = health;
+        REQUIRE(sm->saveGameState());
+    }
+    const auto entries = sm->listHistory();
+    REQUIRE(entries.size() == 3);
+    CHECK(entries.front().sequence == 3);
+
+    // Listing only logs; a bad argument changes nothing
+    CHECK(wolf::mock::runCommand("ap_history"));
+    CHECK(wolf::mock::runCommand("ap_history", {"restore", "x"}));
+    CHECK(sm->listHistory().size() == 3);
+    CHECK_FALSE(sm->restoreFromHistory(99));
+
+    // The console only hands the snapshot over; the tick applies it once it is safe
+    REQUIRE(wolf::mock::runCommand("ap_history", {"restore", "1"}));
+    CHECK(charStats->currentHealth == 300);
+    *flags.areaFlags = 0x1000; // area load in flight
+    sm->processAutoSave();
+    CHECK(charStats->currentHealth == 300);
+
+    flags.setSafe();
+    sm->processAutoSave();
+    CHECK(charStats->currentHealth == 100);
+    REQUIRE(sm->waitForSaves());
+    CHECK(sm->listHistory().size() == 4);
+
+    // The restored state is the save now, and saving goes on as usual
+    charStats->currentHealth = 1;
+    REQUIRE(sm->loadGameState());
+    CHECK(charStats->currentHealth == 100);
+    charStats->currentHealth = 150;
+    CHECK(sm->saveGameState());
+    CHECK(sm->listHistory().size() == 5);
+
+    cleanupSaveFile(*sm);
+    wolf::mock::reset();
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <okami/msd.h>
+
+#include "checks/check_types.hpp"
+#include "itempatch.hpp"
+#include "scouted_names.hpp"
+
+using itempatch::ScoutedNamePool;
+
+namespace
+{
+
+constexpr size_t kMaxNames = 0x7000;
+
+bool matchesCompiled(const uint16_t *str, const std::string &name)
+{
+    if (!str)
+        return false;
+    const auto expected = okami::MSDManager::CompileString(name);
+    return std::equal(expected.begin(), expected.end(), str);
+}
+
+} // namespace
+
+// ============================================================================
+// Pool mechanics
+// ============================================================================
+
+TEST_CASE("ScoutedNamePool: add, find and ordinals", "[scouted_names]")
+{
+    ScoutedNamePool pool(kMaxNames);
+
+    CHECK(pool.add(300, "Fire Arrow"));
+    CHECK(pool.add(100, "Ice Rod"));
+    CHECK_FALSE(pool.add(300, "Ignored")); // first registration wins
+
+    REQUIRE(pool.size() == 2);
+    CHECK(matchesCompiled(pool.find(300), "Fire Arrow"));
+    CHECK(matchesCompiled(pool.find(100), "Ice Rod"));
+    CHECK(pool.find(200) == nullptr);
+
+    // Ordinals follow registration order
+    CHECK(pool.at(0) == pool.find(300));
+    CHECK(pool.at(1) == pool.find(100));
+    CHECK(pool.at(2) == nullptr);
+
+    CHECK(pool.arenaUnits() == okami::MSDManager::CompiledLength("Fire Arrow") + okami::MSDManager::CompiledLength("Ice Rod"));
+}
+
+TEST_CASE("ScoutedNamePool: addBatch skips registered and repeated locations", "[scouted_names]")
+{
+    ScoutedNamePool pool(kMaxNames);
+    pool.add(20, "Existing");
+    const uint16_t *existing = pool.find(20);
+
+    const std::vector<ScoutedNamePool::Name> batch{
+        {30, "Thirty"}, {10, "Ten"}, {20, "Replaced?"}, {30, "Thirty again"}, {5, "Five"}, {25, "Twenty-five"},
+    };
+    CHECK(pool.addBatch(batch) == 4);
+    CHECK(pool.size() == 5);
+
+    CHECK(pool.find(20) == existing);
+    CHECK(matchesCompiled(pool.find(20), "Existing"));
+    CHECK(matchesCompiled(pool.find(30), "Thirty")); // first in the batch wins
+    CHECK(matchesCompiled(pool.find(10), "Ten"));
+    CHECK(matchesCompiled(pool.find(5), "Five"));
+    CHECK(matchesCompiled(pool.find(25), "Twenty-five"));
+    CHECK(pool.find(15) == nullptr);
+
+    CHECK(pool.addBatch(batch) == 0);
+    CHECK(pool.addBatch({}) == 0);
+}
+
+TEST_CASE("ScoutedNamePool: pointers stay valid as the arena grows", "[scouted_names]")
+{
+    ScoutedNamePool pool(kMaxNames);
+    pool.add(checks::getShopCheckId(5, 0), "Progressive Sword");
+    const uint16_t *first = pool.find(checks::getShopCheckId(5, 0));
+
+    // Enough names to fill several chunks
+    std::vector<ScoutedNamePool::Name> batch;
+    for (int64_t i = 0; i < 4000; ++i)
+        batch.emplace_back(1000000 + i, "Player " + std::to_string(i) + "'s Progressive Bow");
+    REQUIRE(pool.addBatch(batch) == batch.size());
+    CHECK(pool.arenaUnits() > 2 * ScoutedNamePool::kChunkUnits);
+
+    CHECK(pool.find(checks::getShopCheckId(5, 0)) == first);
+    CHECK(matchesCompiled(first, "Progressive Sword"));
+    CHECK(matchesCompiled(pool.find(1000000), batch.front().second));
+    CHECK(matchesCompiled(pool.find(1003999), batch.back().second));
+
+    // A name longer than a chunk gets a chunk of its own
+    const std::string longName(ScoutedNamePool::kChunkUnits + 10, 'x');
+    CHECK(pool.add(7, longName));
+    CHECK(matchesCompiled(pool.find(7), longName));
+    CHECK(pool.find(checks::getShopCheckId(5, 0)) == first);
+}
+
+TEST_CASE("ScoutedNamePool: stops at maxNames", "[scouted_names]")
+{
+    ScoutedNamePool pool(3);
+    const std::vector<ScoutedNamePool::Name> batch{{1, "A"}, {2, "B"}, {3, "C"}, {4, "D"}};
+    CHECK(pool.addBatch(batch) == 3);
+    CHECK_FALSE(pool.add(5, "E"));
+    CHECK(pool.size() == 3);
+    CHECK(pool.find(4) == nullptr);
+}
+
+TEST_CASE("ScoutedNamePool: reset forgets everything and reuses the arena", "[scouted_names]")
+{
+    ScoutedNamePool pool(kMaxNames);
+    pool.add(1, "Before");
+    const uint16_t *before = pool.find(1);
+
+    pool.reset();
+    CHECK(pool.size() == 0);
+    CHECK(pool.arenaUnits() == 0);
+    CHECK(pool.find(1) == nullptr);
+    CHECK(pool.at(0) == nullptr);
+
+    CHECK(pool.add(2, "After"));
+    CHECK(pool.find(2) == before);
+    CHECK(matchesCompiled(pool.find(2), "After"));
+}
+
+TEST_CASE("MSDManager::CompileStringInto matches CompileString", "[scouted_names]")
+{
+    const std::string name = "Boomerang (Player 2)";
+    std::vector<uint16_t> buffer(okami::MSDManager::CompiledLength(name));
+    CHECK(okami::MSDManager::CompileStringInto(name, buffer) == buffer.size());
+    CHECK(buffer == okami::MSDManager::CompileString(name));
+
+    std::vector<uint16_t> tooSmall(name.size());
+    CHECK(okami::MSDManager::CompileStringInto(name, tooSmall) == 0);
+}
+
+// ============================================================================
+// itempatch integration
+// ============================================================================
+
+TEST_CASE("itempatch: batch registration and scouting sessions", "[scouted_names][itempatch]")
+{
+    itempatch::resetState();
+    const int64_t first = checks::getContainerCheckId(6, 3);
+    const int64_t second = checks::getContainerCheckId(6, 4);
+    const uint16_t listId = okami::ItemTypes::ForeignStandardItem + 294;
+
+    auto resolveContainer = [&](int64_t locationId)
+    {
+        itempatch::setContainerContext(locationId);
+        return itempatch::resolveApItemName(listId);
+    };
+
+    itempatch::beginScoutedNameSession("seed-1:1");
+    const std::vector<std::pair<int64_t, std::string>> names{{first, "Fire Arrow"}, {second, "Ice Rod"}};
+    itempatch::registerScoutedItemNames(names);
+    CHECK(matchesCompiled(resolveContainer(first), "Fire Arrow"));
+    CHECK(matchesCompiled(resolveContainer(second), "Ice Rod"));
+
+    SECTION("Reconnecting to the same session keeps the names")
+    {
+        itempatch::beginScoutedNameSession("seed-1:1");
+        CHECK(matchesCompiled(resolveContainer(first), "Fire Arrow"));
+    }
+
+    SECTION("A different seed or slot drops them")
+    {
+        itempatch::beginScoutedNameSession("seed-1:2");
+        CHECK(resolveContainer(first) == nullptr);
+
+        itempatch::registerScoutedItemName(first, "Bombs");
+        CHECK(matchesCompiled(resolveContainer(first), "Bombs"));
+    }
+
+    itempatch::resetState();
+}
@@ -0,0 +1,92 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "okami/serializer.hpp"
+
+namespace
+{
+
+#pragma pack(push, 1)
+struct Record
+{
+    uint16_t id;
+    uint32_t value;
+};
+#pragma pack(pop)
+
+// Exercises every sink operation, including a non-contiguous range
+auto sampleSerializer(const std::vector<uint16_t> &words, const std::list<uint8_t> &bytes)
+{
+    return [&](auto &out)
+    {
+        out.write(uint32_t{0xAABBCCDD});
+        out.write(Record{7, 0x11223344});
+        out.writeRange(words);
+        out.writeRange(bytes);
+        out.fill(3, 0xEE);
+        out.padTo(16);
+    };
+}
+
+} // namespace
+
+TEST_CASE("SizeCounter matches the bytes SpanWriter writes", "[serializer]")
+{
+    const std::vector<uint16_t> words{1, 2, 3, 0x8001};
+    const std::list<uint8_t> bytes{9, 8, 7};
+    auto serialize = sampleSerializer(words, bytes);
+
+    // 4 + 6 + 8 + 3 + 3 = 24, padded to 32
+    REQUIRE(okami::serializedSize(serialize) == 32);
+
+    std::array<uint8_t, 40> buffer{};
+    buffer.fill(0x55);
+    REQUIRE(okami::serializeInto(buffer, serialize) == 32);
+
+    const std::array<uint8_t, 32> expected{0xDD, 0xCC, 0xBB, 0xAA, 0x07, 0x00, 0x44, 0x33, 0x22, 0x11, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00,
+                                           0x01, 0x80, 0x09, 0x08, 0x07, 0xEE, 0xEE, 0xEE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    CHECK(std::memcmp(buffer.data(), expected.data(), expected.size()) == 0);
+    CHECK(buffer[32] == 0x55);
+}
+
+TEST_CASE("SpanWriter drops writes that don't fit and reports overflow", "[serializer]")
+{
+    std::array<uint8_t, 6> buffer{};
+    okami::SpanWriter writer(buffer);
+
+    writer.write(uint32_t{1});
+    CHECK_FALSE(writer.overflowed());
+
+    writer.write(uint32_t{2}); // 4 bytes into 2 remaining
+    CHECK(writer.overflowed());
+    writer.write(uint8_t{3}); // stays latched even though it would fit
+    CHECK(writer.size() == 4);
+    CHECK(buffer[4] == 0);
+
+    const std::vector<uint16_t> words{1, 2, 3, 4};
+    const std::list<uint8_t> bytes{1};
+    CHECK(okami::serializeInto(std::span<uint8_t>(buffer), sampleSerializer(words, bytes)) == 0);
+}
+
+TEST_CASE("ByteBuffer sizes exactly and reuses capacity across builds", "[serializer]")
+{
+    okami::ByteBuffer buffer;
+    std::vector<uint32_t> values(100, 0x01020304);
+
+    buffer.build([&](auto &out) { out.writeRange(values); });
+    REQUIRE(buffer.size() == 400);
+    CHECK(buffer.bytes().capacity() == 400);
+    CHECK(buffer.data()[0] == 0x04);
+
+    const uint8_t *first = buffer.data();
+    values.resize(50);
+    buffer.build([&](auto &out) { out.writeRange(values); });
+    CHECK(buffer.size() == 200);
+    CHECK(buffer.data() == first);
+}
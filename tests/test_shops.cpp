@@ -1,5 +1,7 @@
 #include <cstring>
 #include <optional>
+#include <span>
+#include <vector>
 
 #include <okami/shopdata.h>
 
@@ -9,6 +11,7 @@
 
 #include "checks/check_types.hpp"
 #include "checks/shops.hpp"
+#include "gamestate_accessors.hpp"
 #include "mock_archipelagosocket.h"
 #include "wolf_framework.hpp"
 
@@ -253,6 +256,23 @@ TEST_CASE("ShopDefinition ISL binary format is correct", "[shops][ShopDefinition
     REQUIRE(sellValues[okami::ItemTypes::HolyBoneS] == okami::DefaultItemSellPrices[okami::ItemTypes::HolyBoneS]);
 }
 
+TEST_CASE("ShopDefinition WriteISL writes the same image into a caller buffer", "[shops][ShopDefinition]")
+{
+    checks::ShopDefinition shop;
+    shop.AddItem(okami::ItemTypes::HolyBoneS, 100);
+    shop.AddItem(okami::ItemTypes::HolyBoneM, 200);
+
+    constexpr size_t kIslSize = sizeof(okami::ISLHeader) + sizeof(uint32_t) + 2 * sizeof(okami::ItemShopStock) + sizeof(okami::SellValueArray);
+    std::vector<uint8_t> buffer(kIslSize + 16, 0xCC);
+
+    REQUIRE(shop.WriteISL(buffer) == kIslSize);
+    CHECK(std::memcmp(buffer.data(), shop.GetData(), kIslSize) == 0);
+    CHECK(buffer[kIslSize] == 0xCC); // nothing written past the image
+
+    // Too small: reports failure instead of a truncated size
+    CHECK(shop.WriteISL(std::span<uint8_t>(buffer).first(kIslSize - 1)) == 0);
+}
+
 TEST_CASE("ShopDefinition dirty flag prevents unnecessary rebuilds", "[shops][ShopDefinition]")
 {
     checks::ShopDefinition shop;
@@ -438,3 +458,179 @@ TEST_CASE_METHOD(ShopManFixture, "ShopMan shutdown clears active instance", "[sh
 
     TearDown();
 }
+
+// ============================================================================
+// Prepared shops (batch scout at connect)
+// ============================================================================
+
+namespace
+{
+
+constexpr uintptr_t kLoadRscOffset = 0x1B1770;
+constexpr uintptr_t kKibaGetStockListOffset = 0x43F5A0;
+constexpr uintptr_t kKibaPurchaseOffset = 0x43FD30;
+constexpr uintptr_t kIsPurchasedOffset = 0x43BAE0;
+constexpr uintptr_t kExteriorMapIdOffset = 0xB6B240;
+
+using LoadRscFn = const void *(*)(void *, const char *, uint32_t);
+using KibaGetStockListFn = okami::ItemShopStock *(*)(void *, uint32_t *);
+using KibaPurchaseFn = void (*)(void *);
+using IsPurchasedFn = int (*)(void *, int);
+
+// Confirmed kiba purchase: sub-state 1 -> 0, outer state 0
+void fakeKibaPurchase(void *pShop)
+{
+    static_cast<uint8_t *>(pShop)[0x96] = 0;
+    static_cast<uint8_t *>(pShop)[0x95] = 0;
+}
+
+} // namespace
+
+class PreparedShopFixture : public ShopManFixture
+{
+  protected:
+    static constexpr int kMySlot = 1;
+
+    void SetUp()
+    {
+        ShopManFixture::SetUp();
+        wolf::mock::reserveMemory(0xC00000 + 1024);
+        apgame::initialize();
+        wolf::mock::hookOriginals[kKibaPurchaseOffset] = reinterpret_cast<void *>(&fakeKibaPurchase);
+
+        socket_.setConnected(true);
+        socket_.setPlayerSlot(kMySlot);
+        socket_.setSlotConfig(SlotConfig{.randomizeShops = true, .shopSlots = 2});
+
+        // Kamiki (shop 5) has two foreign items, Ark of Yamato's fang shop one
+        socket_.setDefaultScoutResponse({
+            {.item = 1000, .location = checks::getShopCheckId(5, 0), .player = 2, .flags = 0},
+            {.item = 1001, .location = checks::getShopCheckId(5, 1), .player = 2, .flags = 1},
+            {.item = 1002, .location = checks::getShopCheckId(checks::FANG_SHOP_ID_BASE + 1, 0), .player = 2, .flags = 0},
+        });
+
+        shopMan_->initialize();
+    }
+
+    void setMap(okami::MapID::Enum mapId)
+    {
+        *reinterpret_cast<uint16_t *>(&wolf::mock::mockMemory[kExteriorMapIdOffset]) = mapId;
+    }
+
+    // One game tick: the socket receives replies, then main-thread tasks run
+    void deliverScoutReplies()
+    {
+        socket_.poll();
+        socket_.processMainThreadTasks();
+    }
+
+    const void *openItemShop(okami::MapID::Enum mapId)
+    {
+        setMap(mapId);
+        return reinterpret_cast<LoadRscFn>(wolf::mock::registeredHooks.at(kLoadRscOffset))(nullptr, "ISL", 0);
+    }
+};
+
+TEST_CASE_METHOD(PreparedShopFixture, "ShopMan prepares every shop from one batch scout", "[shops][ShopMan][prepared]")
+{
+    SetUp();
+
+    shopMan_->prepareShops();
+    REQUIRE(socket_.getScoutRequestCount() == 1);
+    REQUIRE_FALSE(shopMan_->hasPreparedShops()); // sent, not waited for
+
+    // The reply is built and published on a later game tick
+    deliverScoutReplies();
+    REQUIRE(shopMan_->hasPreparedShops());
+
+    SECTION("Opening a scouted item shop returns the finished ISL without scouting")
+    {
+        const auto *isl = static_cast<const uint8_t *>(openItemShop(okami::MapID::KamikiVillage));
+        REQUIRE(isl != nullptr);
+        CHECK(std::memcmp(isl, "ISL", 3) == 0);
+
+        const auto *numItems = reinterpret_cast<const uint32_t *>(isl + sizeof(okami::ISLHeader));
+        REQUIRE(*numItems == 2);
+        const auto *stock = reinterpret_cast<const okami::ItemShopStock *>(isl + sizeof(okami::ISLHeader) + sizeof(uint32_t));
+        CHECK(stock[0].itemType == okami::ItemTypes::ForeignStandardItem);
+        CHECK(stock[1].itemType == okami::ItemTypes::ForeignProgressionItem);
+
+        // Same buffer on every open
+        CHECK(openItemShop(okami::MapID::KamikiVillage) == isl);
+        CHECK(socket_.getScoutRequestCount() == 1);
+    }
+
+    SECTION("A shop with nothing scouted stays vanilla")
+    {
+        CHECK(openItemShop(okami::MapID::AgataForestHealed) == nullptr); // original (null in tests)
+        CHECK(socket_.getScoutRequestCount() == 1);
+    }
+
+    SECTION("Demon fang shops get their stock and report their own check IDs")
+    {
+        setMap(okami::MapID::ArkofYamato);
+        uint32_t numItems = 0;
+        auto *stock = reinterpret_cast<KibaGetStockListFn>(wolf::mock::registeredHooks.at(kKibaGetStockListOffset))(nullptr, &numItems);
+        REQUIRE(stock != nullptr);
+        REQUIRE(numItems == 1);
+        CHECK(stock[0].itemType == okami::ItemTypes::ForeignStandardItem);
+
+        std::array<uint8_t, 0x100> shop{};
+        std::array<uint8_t, 0x20> stockBuffer{};
+        uint8_t *stockPtr = stockBuffer.data();
+        std::memcpy(&shop[0x48], &stockPtr, sizeof(stockPtr));
+        shop[0x96] = 1;
+        reinterpret_cast<KibaPurchaseFn>(wolf::mock::registeredHooks.at(kKibaPurchaseOffset))(shop.data());
+
+        REQUIRE(receivedCheckIds_.size() == 1);
+        CHECK(receivedCheckIds_[0] == checks::getShopCheckId(checks::FANG_SHOP_ID_BASE + 1, 0));
+
+        // The bought slot stays bought
+        auto isPurchased = reinterpret_cast<IsPurchasedFn>(wolf::mock::registeredHooks.at(kIsPurchasedOffset));
+        CHECK(isPurchased(shop.data(), 0) == 1);
+        CHECK(isPurchased(shop.data(), 1) == 0);
+    }
+
+    SECTION("Discarding falls back to lazy scouting")
+    {
+        shopMan_->discardPreparedShops();
+        CHECK_FALSE(shopMan_->hasPreparedShops());
+
+        CHECK(openItemShop(okami::MapID::KamikiVillage) != nullptr);
+        CHECK(socket_.getScoutRequestCount() == 2);
+    }
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(PreparedShopFixture, "ShopMan skips preparation when shops are not randomized", "[shops][ShopMan][prepared]")
+{
+    SetUp();
+    socket_.setSlotConfig(SlotConfig{.randomizeShops = false});
+
+    shopMan_->prepareShops();
+    deliverScoutReplies();
+    CHECK_FALSE(shopMan_->hasPreparedShops());
+    CHECK(socket_.getScoutRequestCount() == 0);
+
+    TearDown();
+}
+
+TEST_CASE_METHOD(PreparedShopFixture, "ShopMan drops a preparation reply that arrives after a discard", "[shops][ShopMan][prepared]")
+{
+    SetUp();
+
+    shopMan_->prepareShops();
+    shopMan_->discardPreparedShops(); // disconnected while the scout was in flight
+    deliverScoutReplies();
+    CHECK_FALSE(shopMan_->hasPreparedShops());
+
+    // A newer preparation supersedes an older one still in flight
+    shopMan_->prepareShops();
+    shopMan_->prepareShops();
+    deliverScoutReplies();
+    CHECK(shopMan_->hasPreparedShops());
+    CHECK(socket_.getScoutRequestCount() == 3);
+
+    TearDown();
+}